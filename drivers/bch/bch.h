@@ -53,9 +53,20 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifndef CONFIG_BCH_BUFFER_SECTORS
+#  define CONFIG_BCH_BUFFER_SECTORS 1
+#endif
+
 #define bchlib_semgive(d) nxsem_post(&(d)->sem)  /* To match bchlib_semtake */
 #define MAX_OPENCNT       (255)                  /* Limit of uint8_t */
 
+/* Return the address of a buffered sector.  bchlib_readsector() must have
+ * been called for the sector first.
+ */
+
+#define bchlib_sectorbuf(d,s) \
+  (&(d)->buffer[((s) - (d)->sector) * (d)->sectsize])
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -65,13 +76,16 @@ struct bchlib_s
   FAR struct inode *inode; /* I-node of the block driver */
   uint32_t sectsize;       /* The size of one sector on the device */
   size_t nsectors;         /* Number of sectors supported by the device */
-  size_t sector;           /* The current sector in the buffer */
+  size_t sector;           /* The first sector in the buffer */
+  size_t nbuffered;        /* Number of sectors in the buffer */
+  size_t dirtyfirst;       /* First modified sector in the buffer */
+  size_t dirtylast;        /* Last modified sector in the buffer */
   sem_t sem;               /* For atomic accesses to this structure */
   uint8_t refs;            /* Number of references */
   bool dirty;              /* true: Data has been written to the buffer */
   bool readonly;           /* true: Only read operations are supported */
   bool unlinked;           /* true: The driver has been unlinked */
-  FAR uint8_t *buffer;     /* One sector buffer */
+  FAR uint8_t *buffer;     /* CONFIG_BCH_BUFFER_SECTORS sector buffer */
 
 #if defined(CONFIG_BCH_ENCRYPTION)
   uint8_t key[CONFIG_BCH_ENCRYPTION_KEY_SIZE];  /* Encryption key */
@@ -100,6 +114,9 @@ EXTERN const struct file_operations bch_fops;
 EXTERN int  bchlib_semtake(FAR struct bchlib_s *bch);
 EXTERN int  bchlib_flushsector(FAR struct bchlib_s *bch);
 EXTERN int  bchlib_readsector(FAR struct bchlib_s *bch, size_t sector);
+EXTERN void bchlib_dirtysector(FAR struct bchlib_s *bch, size_t sector);
+EXTERN void bchlib_invalidate(FAR struct bchlib_s *bch, size_t sector,
+                              size_t nsectors);
 
 #undef EXTERN
 #if defined(__cplusplus)
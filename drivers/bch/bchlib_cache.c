@@ -74,29 +74,35 @@ static void bch_xor(uint32_t *R, uint32_t *A, uint32_t *B)
  ****************************************************************************/
 
 #if defined(CONFIG_BCH_ENCRYPTION)
-static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
+static int bch_cypher(FAR struct bchlib_s *bch, size_t sector,
+                      size_t nsectors, int encrypt)
 {
   int blocks = bch->sectsize / 16;
-  FAR uint32_t *buffer = (FAR uint32_t *)bch->buffer;
+  FAR uint32_t *buffer = (FAR uint32_t *)bchlib_sectorbuf(bch, sector);
   int i;
 
-  for (i = 0; i < blocks; i++, buffer += 16 / sizeof(uint32_t) )
+  for (; nsectors > 0; nsectors--, sector++)
     {
-      uint32_t T[4];
-      uint32_t X[4] =
-      {
-        bch->sector, 0, 0, i
-      };
-
-      aes_cypher(X, X, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
-                 AES_MODE_ECB, CYPHER_ENCRYPT);
-
-      /* Xor-Encrypt-Xor */
-
-      bch_xor(T, X, buffer);
-      aes_cypher(T, T, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
-                 AES_MODE_ECB, encrypt);
-      bch_xor(buffer, X, T);
+      for (i = 0; i < blocks; i++, buffer += 16 / sizeof(uint32_t) )
+        {
+          uint32_t T[4];
+          uint32_t X[4] =
+          {
+            sector, 0, 0, i
+          };
+
+          aes_cypher(X, X, 16, NULL, bch->key,
+                     CONFIG_BCH_ENCRYPTION_KEY_SIZE,
+                     AES_MODE_ECB, CYPHER_ENCRYPT);
+
+          /* Xor-Encrypt-Xor */
+
+          bch_xor(T, X, buffer);
+          aes_cypher(T, T, 16, NULL, bch->key,
+                     CONFIG_BCH_ENCRYPTION_KEY_SIZE,
+                     AES_MODE_ECB, encrypt);
+          bch_xor(buffer, X, T);
+        }
     }
 
   return OK;
@@ -111,7 +117,8 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
  * Name: bchlib_flushsector
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
+ *   Flush the current contents of the sector buffer (if dirty).  All of
+ *   the modified sectors are written with a single transfer.
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
@@ -121,6 +128,7 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
 int bchlib_flushsector(FAR struct bchlib_s *bch)
 {
   FAR struct inode *inode;
+  size_t nsectors;
   ssize_t ret = OK;
 
   /* Check if the sector has been modified and is out of synch with the
@@ -129,17 +137,20 @@ int bchlib_flushsector(FAR struct bchlib_s *bch)
 
   if (bch->dirty)
     {
-      inode = bch->inode;
+      inode    = bch->inode;
+      nsectors = bch->dirtylast - bch->dirtyfirst + 1;
 
 #if defined(CONFIG_BCH_ENCRYPTION)
       /* Encrypt data as necessary */
 
-      bch_cypher(bch, CYPHER_ENCRYPT);
+      bch_cypher(bch, bch->dirtyfirst, nsectors, CYPHER_ENCRYPT);
 #endif
 
-      /* Write the sector to the media */
+      /* Write the sectors to the media */
 
-      ret = inode->u.i_bops->write(inode, bch->buffer, bch->sector, 1);
+      ret = inode->u.i_bops->write(inode,
+                                   bchlib_sectorbuf(bch, bch->dirtyfirst),
+                                   bch->dirtyfirst, nsectors);
       if (ret < 0)
         {
           ferr("Write failed: %d\n");
@@ -150,7 +161,7 @@ int bchlib_flushsector(FAR struct bchlib_s *bch)
        * TODO: Add configuration switch for extra sector buffer
        */
 
-      bch_cypher(bch, CYPHER_DECRYPT);
+      bch_cypher(bch, bch->dirtyfirst, nsectors, CYPHER_DECRYPT);
 #endif
 
       /* The sector is now in sync with the media */
@@ -165,7 +176,11 @@ int bchlib_flushsector(FAR struct bchlib_s *bch)
  * Name: bchlib_readsector
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
+ *   Make sure that the sector is in the sector buffer, flushing the current
+ *   contents of the buffer (if dirty) first if it is not.  If the sector
+ *   immediately follows the buffered sectors, the access is assumed to be
+ *   sequential and as many of the following sectors as fit in the buffer
+ *   are read with it.
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
@@ -175,26 +190,97 @@ int bchlib_flushsector(FAR struct bchlib_s *bch)
 int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
 {
   FAR struct inode *inode;
+  size_t nsectors = 1;
   ssize_t ret = OK;
 
-  if (bch->sector != sector)
+  if (sector < bch->sector || sector - bch->sector >= bch->nbuffered)
     {
       inode = bch->inode;
 
+      /* Read ahead on sequential accesses */
+
+      if (sector == bch->sector + bch->nbuffered)
+        {
+          nsectors = CONFIG_BCH_BUFFER_SECTORS;
+          if (nsectors > bch->nsectors - sector)
+            {
+              nsectors = bch->nsectors - sector;
+            }
+        }
+
       bchlib_flushsector(bch);
-      bch->sector = (size_t)-1;
+      bch->sector    = sector;
+      bch->nbuffered = 0;
 
-      ret = inode->u.i_bops->read(inode, bch->buffer, sector, 1);
+      ret = inode->u.i_bops->read(inode, bch->buffer, sector, nsectors);
       if (ret < 0)
         {
           ferr("Read failed: %d\n");
+          return (int)ret;
         }
 
-      bch->sector = sector;
+      bch->nbuffered = nsectors;
 #if defined(CONFIG_BCH_ENCRYPTION)
-      bch_cypher(bch, CYPHER_DECRYPT);
+      bch_cypher(bch, sector, nsectors, CYPHER_DECRYPT);
 #endif
     }
 
   return (int)ret;
 }
+
+/****************************************************************************
+ * Name: bchlib_dirtysector
+ *
+ * Description:
+ *   Mark a sector in the sector buffer as modified.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+void bchlib_dirtysector(FAR struct bchlib_s *bch, size_t sector)
+{
+  DEBUGASSERT(sector >= bch->sector &&
+              sector - bch->sector < bch->nbuffered);
+
+  if (!bch->dirty)
+    {
+      bch->dirtyfirst = sector;
+      bch->dirtylast  = sector;
+      bch->dirty      = true;
+    }
+  else if (sector < bch->dirtyfirst)
+    {
+      bch->dirtyfirst = sector;
+    }
+  else if (sector > bch->dirtylast)
+    {
+      bch->dirtylast = sector;
+    }
+}
+
+/****************************************************************************
+ * Name: bchlib_invalidate
+ *
+ * Description:
+ *   Discard the sector buffer if it holds any of the specified sectors.
+ *   This is necessary when the sectors are written without going through
+ *   the sector buffer.  The buffer must have been flushed.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+void bchlib_invalidate(FAR struct bchlib_s *bch, size_t sector,
+                       size_t nsectors)
+{
+  DEBUGASSERT(!bch->dirty);
+
+  if (bch->nbuffered > 0 && sector < bch->sector + bch->nbuffered &&
+      bch->sector < sector + nsectors)
+    {
+      bch->nbuffered = 0;
+    }
+}
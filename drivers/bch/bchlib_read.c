@@ -86,6 +86,7 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset,
   uint16_t sectoffset;
   size_t   nbytes;
   size_t   bytesread;
+  size_t   i;
   int      ret;
 
   /* Get rid of this special case right away */
@@ -114,7 +115,11 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset,
     {
       /* Read the sector into the sector buffer */
 
-      bchlib_readsector(bch, sector);
+      ret = bchlib_readsector(bch, sector);
+      if (ret < 0)
+        {
+          return ret;
+        }
 
       /* Copy the tail end of the sector to the user buffer */
 
@@ -127,7 +132,7 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset,
           nbytes = len;
         }
 
-      memcpy(buffer, &bch->buffer[sectoffset], nbytes);
+      memcpy(buffer, bchlib_sectorbuf(bch, sector) + sectoffset, nbytes);
 
       /* Adjust pointers and counts */
 
@@ -143,8 +148,10 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset,
       len       -= nbytes;
     }
 
-  /* Then read all of the full sectors following the partial sector directly
-   * into the user buffer.
+  /* Then read all of the full sectors following the partial sector.  Reads
+   * that are shorter than the sector buffer are copied from the sector
+   * buffer so that sequential reads benefit from read-ahead.  Others are
+   * read directly into the user buffer.
    */
 
   if (len >= bch->sectsize)
@@ -155,12 +162,39 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset,
           nsectors = bch->nsectors - sector;
         }
 
-      ret = bch->inode->u.i_bops->read(bch->inode, (FAR uint8_t *)buffer,
-                                       sector, nsectors);
-      if (ret < 0)
+      if (nsectors < CONFIG_BCH_BUFFER_SECTORS)
         {
-          ferr("ERROR: Read failed: %d\n");
-          return ret;
+          for (i = 0; i < nsectors; i++)
+            {
+              ret = bchlib_readsector(bch, sector + i);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+
+              memcpy(buffer + i * bch->sectsize,
+                     bchlib_sectorbuf(bch, sector + i), bch->sectsize);
+            }
+        }
+      else
+        {
+          /* Flush the dirty sectors so that the media is up to date */
+
+          ret = bchlib_flushsector(bch);
+          if (ret < 0)
+            {
+              ferr("ERROR: Flush failed: %d\n", ret);
+              return ret;
+            }
+
+          ret = bch->inode->u.i_bops->read(bch->inode,
+                                           (FAR uint8_t *)buffer,
+                                           sector, nsectors);
+          if (ret < 0)
+            {
+              ferr("ERROR: Read failed: %d\n");
+              return ret;
+            }
         }
 
       /* Adjust pointers and counts */
@@ -184,11 +218,15 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset,
     {
       /* Read the sector into the sector buffer */
 
-      bchlib_readsector(bch, sector);
+      ret = bchlib_readsector(bch, sector);
+      if (ret < 0)
+        {
+          return ret;
+        }
 
       /* Copy the head end of the sector to the user buffer */
 
-      memcpy(buffer, bch->buffer, len);
+      memcpy(buffer, bchlib_sectorbuf(bch, sector), len);
 
       /* Adjust counts */
 
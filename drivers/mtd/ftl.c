@@ -57,6 +57,51 @@
 
 #define DEV_NAME_MAX    (NAME_MAX + 5)
 
+/* Log-structured sector mapping.  The first hdrblks R/W blocks of each
+ * erase block hold a header: a magic number, the sequence number of the
+ * erase block and one 32-bit entry per data block that follows.  An entry
+ * is programmed in two steps.  It is first claimed with the uncommitted
+ * bit still set before the data is written, and it is committed by
+ * clearing that bit once the data is written.  Of several committed copies
+ * of a logical sector, the one in the erase block with the highest
+ * sequence number (and the highest entry within it) is the current one.
+ */
+
+#ifdef CONFIG_FTL_MAPPED
+#  ifndef CONFIG_FTL_MAPPED_NSPARE
+#    define CONFIG_FTL_MAPPED_NSPARE 4
+#  endif
+
+#  define FTL_MAGIC             0x4d4c5446  /* "FTLM" */
+#  define FTL_HDRSIZE(n)        (8 + 4 * (n))
+#  define FTL_ENTRY_FREE        0xffffffff
+#  define FTL_ENTRY_UNCOMMITTED 0x80000000
+#  define FTL_UNMAPPED          0xffffffff
+
+/* Erase blocks kept free besides the open one.  One is enough to hold the
+ * current sectors of any erase block that is not full of them.  Ordinary
+ * writes never open these; only garbage collection does.
+ */
+
+#  define FTL_MINFREE           1
+
+/* Erase block states */
+
+#  define FTL_EBLOCK_FREE       0  /* May be erased and opened */
+#  define FTL_EBLOCK_USED       1  /* Holds data, possibly stale */
+#  define FTL_EBLOCK_OPEN       2  /* Data is being appended */
+#endif
+
+/* The block transfer functions used with or without the sector mapping */
+
+#ifdef CONFIG_FTL_MAPPED
+#  define ftl_doreload ftl_mapped_reload
+#  define ftl_doflush  ftl_mapped_flush
+#else
+#  define ftl_doreload ftl_reload
+#  define ftl_doflush  ftl_flush
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -72,6 +117,22 @@ struct ftl_struct_s
   uint16_t              refs;     /* Number of references */
   bool                  unlinked; /* The driver has been unlinked */
   FAR uint8_t          *eblock;   /* One, in-memory erase block */
+#ifdef CONFIG_FTL_MAPPED
+  uint16_t              hdrblks;  /* R/W blocks in each erase block header */
+  uint16_t              ndata;    /* Data blocks in each erase block */
+  uint16_t              openblk;  /* Erase block open for writing */
+  uint16_t              wrndx;    /* Next free entry in the open block */
+  uint16_t              nfree;    /* Number of free erase blocks */
+  uint32_t              seq;      /* Last erase block sequence number */
+  size_t                nsectors; /* Number of logical sectors */
+  FAR uint32_t         *map;      /* Logical sector to R/W block map */
+  FAR uint32_t         *ebseq;    /* Sequence number of each erase block */
+  FAR uint16_t         *nvalid;   /* Current sectors in each erase block */
+  FAR uint8_t          *state;    /* State of each erase block */
+  FAR uint32_t         *hdr;      /* Header of the open erase block */
+  FAR uint32_t         *gchdr;    /* Header of the block being collected */
+  FAR uint32_t         *gclist;   /* Logical sectors being relocated */
+#endif
 };
 
 /****************************************************************************
@@ -84,8 +145,10 @@ static ssize_t ftl_reload(FAR void *priv, FAR uint8_t *buffer,
                  off_t startblock, size_t nblocks);
 static ssize_t ftl_read(FAR struct inode *inode, FAR unsigned char *buffer,
                  size_t start_sector, unsigned int nsectors);
+#ifndef CONFIG_FTL_MAPPED
 static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer,
                  off_t startblock, size_t nblocks);
+#endif
 static ssize_t ftl_write(FAR struct inode *inode,
                  FAR const unsigned char *buffer, size_t start_sector,
                  unsigned int nsectors);
@@ -96,6 +159,14 @@ static int     ftl_ioctl(FAR struct inode *inode, int cmd,
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
 static int     ftl_unlink(FAR struct inode *inode);
 #endif
+#ifdef CONFIG_FTL_MAPPED
+static ssize_t ftl_mapped_reload(FAR void *priv, FAR uint8_t *buffer,
+                 off_t startblock, size_t nblocks);
+static ssize_t ftl_mapped_flush(FAR void *priv, FAR const uint8_t *buffer,
+                 off_t startblock, size_t nblocks);
+static int     ftl_mapped_initialize(FAR struct ftl_struct_s *dev);
+static void    ftl_mapped_uninitialize(FAR struct ftl_struct_s *dev);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -164,6 +235,9 @@ static int ftl_close(FAR struct inode *inode)
           kmm_free(dev->eblock);
         }
 
+#ifdef CONFIG_FTL_MAPPED
+      ftl_mapped_uninitialize(dev);
+#endif
       kmm_free(dev);
     }
 
@@ -215,7 +289,7 @@ static ssize_t ftl_read(FAR struct inode *inode, unsigned char *buffer,
 #ifdef FTL_HAVE_RWBUFFER
   return rwb_read(&dev->rwb, start_sector, nsectors, buffer);
 #else
-  return ftl_reload(dev, buffer, start_sector, nsectors);
+  return ftl_doreload(dev, buffer, start_sector, nsectors);
 #endif
 }
 
@@ -238,6 +312,7 @@ static int ftl_alloc_eblock(FAR struct ftl_struct_s *dev)
   return dev->eblock != NULL ? OK : -ENOMEM;
 }
 
+#ifndef CONFIG_FTL_MAPPED
 static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer,
                          off_t startblock, size_t nblocks)
 {
@@ -422,6 +497,623 @@ static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer,
 
   return nblocks;
 }
+#endif /* !CONFIG_FTL_MAPPED */
+
+/****************************************************************************
+ * Name: ftl_mapped_writehdr
+ *
+ * Description:
+ *   Program the header blocks of the open erase block that contain entries
+ *   'first' through 'first' + 'n' - 1.  Entries that were already programmed
+ *   are rewritten with the same value, which leaves them unchanged on NOR
+ *   FLASH.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_MAPPED
+static int ftl_mapped_writehdr(FAR struct ftl_struct_s *dev,
+                               unsigned int first, unsigned int n)
+{
+  off_t startblk;
+  off_t endblk;
+  ssize_t nxfrd;
+
+  startblk = FTL_HDRSIZE(first) / dev->geo.blocksize;
+  endblk   = (FTL_HDRSIZE(first + n) - 1) / dev->geo.blocksize;
+
+  nxfrd = MTD_BWRITE(dev->mtd,
+                     (off_t)dev->openblk * dev->blkper + startblk,
+                     endblk - startblk + 1,
+                     (FAR const uint8_t *)dev->hdr +
+                     startblk * dev->geo.blocksize);
+  if (nxfrd != endblk - startblk + 1)
+    {
+      ferr("ERROR: Header write of erase block %d failed: %d\n",
+           dev->openblk, nxfrd);
+      return -EIO;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_mapped_open
+ *
+ * Description:
+ *   Erase a free erase block and open it for writing.  The free blocks are
+ *   taken round-robin, starting after the block that was opened last, so
+ *   that the erases are spread over the whole device.  Erase counts are not
+ *   recorded in the header, but the open block is found again by its
+ *   sequence number when the device is mounted, so the rotation continues
+ *   across reboots.
+ *
+ ****************************************************************************/
+
+static int ftl_mapped_open(FAR struct ftl_struct_s *dev)
+{
+  uint16_t start;
+  uint16_t eb;
+  uint16_t i;
+  int ret;
+
+  start = 0;
+  if (dev->openblk < dev->geo.neraseblocks)
+    {
+      start = dev->openblk + 1;
+    }
+
+  eb = UINT16_MAX;
+  for (i = 0; i < dev->geo.neraseblocks; i++)
+    {
+      uint16_t candidate = (start + i) % dev->geo.neraseblocks;
+
+      if (dev->state[candidate] == FTL_EBLOCK_FREE)
+        {
+          eb = candidate;
+          break;
+        }
+    }
+
+  if (eb == UINT16_MAX)
+    {
+      return -ENOSPC;
+    }
+
+  ret = MTD_ERASE(dev->mtd, eb, 1);
+  if (ret < 0)
+    {
+      ferr("ERROR: Erase block=%d failed: %d\n", eb, ret);
+      return ret;
+    }
+
+  /* The previously open block, if any, is now just another used block */
+
+  if (dev->openblk < dev->geo.neraseblocks &&
+      dev->state[dev->openblk] == FTL_EBLOCK_OPEN)
+    {
+      dev->state[dev->openblk] = FTL_EBLOCK_USED;
+    }
+
+  dev->nfree--;
+  dev->state[eb]  = FTL_EBLOCK_OPEN;
+  dev->openblk    = eb;
+  dev->wrndx      = 0;
+  dev->ebseq[eb]  = ++dev->seq;
+  dev->nvalid[eb] = 0;
+
+  memset(dev->hdr, 0xff, dev->hdrblks * dev->geo.blocksize);
+  dev->hdr[0] = FTL_MAGIC;
+  dev->hdr[1] = dev->seq;
+
+  return ftl_mapped_writehdr(dev, 0, 0);
+}
+
+/****************************************************************************
+ * Name: ftl_mapped_append
+ *
+ * Description:
+ *   Append up to 'nblocks' sectors to the open erase block, opening a new
+ *   one if necessary.  Sector 'i' is written to logical sector logical[i]
+ *   or, if 'logical' is NULL, to logical sector startblock + i.  Returns
+ *   the number of sectors appended.
+ *
+ ****************************************************************************/
+
+static ssize_t ftl_mapped_append(FAR struct ftl_struct_s *dev,
+                                 FAR const uint8_t *buffer,
+                                 FAR const uint32_t *logical,
+                                 off_t startblock, size_t nblocks)
+{
+  FAR uint32_t *entries = &dev->hdr[2];
+  uint32_t sector;
+  uint32_t old;
+  off_t    rwblock;
+  ssize_t  nxfrd;
+  size_t   i;
+  int      ret;
+
+  if (dev->openblk >= dev->geo.neraseblocks || dev->wrndx >= dev->ndata)
+    {
+      ret = ftl_mapped_open(dev);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  if (nblocks > dev->ndata - dev->wrndx)
+    {
+      nblocks = dev->ndata - dev->wrndx;
+    }
+
+  /* Claim the entries, then write the data to consecutive blocks */
+
+  for (i = 0; i < nblocks; i++)
+    {
+      sector = logical != NULL ? logical[i] : startblock + i;
+      entries[dev->wrndx + i] = sector | FTL_ENTRY_UNCOMMITTED;
+    }
+
+  ret = ftl_mapped_writehdr(dev, dev->wrndx, nblocks);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  rwblock = (off_t)dev->openblk * dev->blkper + dev->hdrblks + dev->wrndx;
+  nxfrd   = MTD_BWRITE(dev->mtd, rwblock, nblocks, buffer);
+  if (nxfrd != nblocks)
+    {
+      ferr("ERROR: Write of %d blocks at %d failed: %d\n",
+           nblocks, rwblock, nxfrd);
+
+      /* The claimed entries are left uncommitted and will be ignored */
+
+      dev->wrndx += nblocks;
+      return -EIO;
+    }
+
+  /* Commit the entries and update the mapping */
+
+  for (i = 0; i < nblocks; i++)
+    {
+      entries[dev->wrndx + i] &= ~FTL_ENTRY_UNCOMMITTED;
+    }
+
+  ret = ftl_mapped_writehdr(dev, dev->wrndx, nblocks);
+  if (ret < 0)
+    {
+      dev->wrndx += nblocks;
+      return ret;
+    }
+
+  for (i = 0; i < nblocks; i++)
+    {
+      sector = logical != NULL ? logical[i] : startblock + i;
+      old    = dev->map[sector];
+      if (old != FTL_UNMAPPED)
+        {
+          dev->nvalid[old / dev->blkper]--;
+        }
+
+      dev->map[sector] = rwblock + i;
+      dev->nvalid[dev->openblk]++;
+    }
+
+  dev->wrndx += nblocks;
+  return nblocks;
+}
+
+/****************************************************************************
+ * Name: ftl_mapped_collect
+ *
+ * Description:
+ *   Reclaim the used erase block with the fewest current sectors by
+ *   copying those sectors to the open erase block.  The reclaimed block is
+ *   erased when it is next opened.
+ *
+ ****************************************************************************/
+
+static int ftl_mapped_collect(FAR struct ftl_struct_s *dev)
+{
+  FAR const uint32_t *entries = &dev->gchdr[2];
+  FAR uint8_t *data;
+  uint16_t victim = UINT16_MAX;
+  uint16_t eb;
+  off_t    rwblock;
+  ssize_t  nxfrd;
+  size_t   nvalid;
+  size_t   i;
+  int      ret;
+
+  for (eb = 0; eb < dev->geo.neraseblocks; eb++)
+    {
+      if (dev->state[eb] == FTL_EBLOCK_USED &&
+          (victim == UINT16_MAX || dev->nvalid[eb] < dev->nvalid[victim]))
+        {
+          victim = eb;
+        }
+    }
+
+  if (victim == UINT16_MAX || dev->nvalid[victim] >= dev->ndata)
+    {
+      return -ENOSPC;
+    }
+
+  ret = ftl_alloc_eblock(dev);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Read the header and the data of the victim in one transfer */
+
+  rwblock = (off_t)victim * dev->blkper;
+  nxfrd   = MTD_BREAD(dev->mtd, rwblock, dev->blkper, dev->eblock);
+  if (nxfrd != dev->blkper)
+    {
+      ferr("ERROR: Read erase block %d failed: %d\n", victim, nxfrd);
+      return -EIO;
+    }
+
+  memcpy(dev->gchdr, dev->eblock, dev->hdrblks * dev->geo.blocksize);
+  data = dev->eblock + dev->hdrblks * dev->geo.blocksize;
+
+  /* Gather the current sectors at the beginning of the data */
+
+  for (i = 0, nvalid = 0; i < dev->ndata; i++)
+    {
+      if (entries[i] < dev->nsectors &&
+          dev->map[entries[i]] == rwblock + dev->hdrblks + i)
+        {
+          if (i != nvalid)
+            {
+              memcpy(data + nvalid * dev->geo.blocksize,
+                     data + i * dev->geo.blocksize, dev->geo.blocksize);
+            }
+
+          dev->gclist[nvalid++] = entries[i];
+        }
+    }
+
+  finfo("Collecting erase block %d with %d current sectors\n",
+        victim, nvalid);
+
+  /* And append them to the open erase block */
+
+  for (i = 0; i < nvalid; i += nxfrd)
+    {
+      nxfrd = ftl_mapped_append(dev, data + i * dev->geo.blocksize,
+                                &dev->gclist[i], 0, nvalid - i);
+      if (nxfrd < 0)
+        {
+          return nxfrd;
+        }
+    }
+
+  DEBUGASSERT(dev->nvalid[victim] == 0);
+  dev->state[victim] = FTL_EBLOCK_FREE;
+  dev->nfree++;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_mapped_reload
+ *
+ * Description:
+ *   Read the specified number of logical sectors.  Runs of sectors that are
+ *   consecutive in FLASH are read in a single transfer.  Sectors that were
+ *   never written read as erased.
+ *
+ ****************************************************************************/
+
+static ssize_t ftl_mapped_reload(FAR void *priv, FAR uint8_t *buffer,
+                                 off_t startblock, size_t nblocks)
+{
+  FAR struct ftl_struct_s *dev = (FAR struct ftl_struct_s *)priv;
+  uint32_t first;
+  size_t   remaining;
+  size_t   nrun;
+  ssize_t  nread;
+
+  if (startblock + nblocks > dev->nsectors)
+    {
+      return -EINVAL;
+    }
+
+  for (remaining = nblocks; remaining > 0; remaining -= nrun)
+    {
+      first = dev->map[startblock];
+
+      for (nrun = 1; nrun < remaining; nrun++)
+        {
+          uint32_t next = dev->map[startblock + nrun];
+
+          if (first == FTL_UNMAPPED ? next != FTL_UNMAPPED :
+                                      next != first + nrun)
+            {
+              break;
+            }
+        }
+
+      if (first == FTL_UNMAPPED)
+        {
+          memset(buffer, 0xff, nrun * dev->geo.blocksize);
+        }
+      else
+        {
+          nread = ftl_reload(dev, buffer, first, nrun);
+          if (nread != nrun)
+            {
+              return nread < 0 ? nread : -EIO;
+            }
+        }
+
+      startblock += nrun;
+      buffer     += nrun * dev->geo.blocksize;
+    }
+
+  return nblocks;
+}
+
+/****************************************************************************
+ * Name: ftl_mapped_flush
+ *
+ * Description:
+ *   Write the specified number of logical sectors, reclaiming erase blocks
+ *   as needed.
+ *
+ ****************************************************************************/
+
+static ssize_t ftl_mapped_flush(FAR void *priv, FAR const uint8_t *buffer,
+                                off_t startblock, size_t nblocks)
+{
+  FAR struct ftl_struct_s *dev = (FAR struct ftl_struct_s *)priv;
+  size_t  remaining;
+  ssize_t nxfrd;
+  int     retries;
+  int     ret;
+
+  if (startblock + nblocks > dev->nsectors)
+    {
+      return -EINVAL;
+    }
+
+  for (remaining = nblocks; remaining > 0; remaining -= nxfrd)
+    {
+      /* If the open erase block is full, the append below opens a new one.
+       * It must not take one of the erase blocks kept free for garbage
+       * collection itself, so collect until there is one more.
+       */
+
+      for (retries = 0;
+           (dev->openblk >= dev->geo.neraseblocks ||
+            dev->wrndx >= dev->ndata) && dev->nfree <= FTL_MINFREE;
+           retries++)
+        {
+          if (retries >= dev->geo.neraseblocks)
+            {
+              return -ENOSPC;
+            }
+
+          ret = ftl_mapped_collect(dev);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      nxfrd = ftl_mapped_append(dev, buffer, NULL, startblock, remaining);
+      if (nxfrd < 0)
+        {
+          return nxfrd;
+        }
+
+      startblock += nxfrd;
+      buffer     += nxfrd * dev->geo.blocksize;
+    }
+
+  return nblocks;
+}
+
+/****************************************************************************
+ * Name: ftl_mapped_scan
+ *
+ * Description:
+ *   Rebuild the sector map from the erase block headers.
+ *
+ ****************************************************************************/
+
+static int ftl_mapped_scan(FAR struct ftl_struct_s *dev)
+{
+  FAR const uint32_t *entries = &dev->gchdr[2];
+  uint32_t maxseq = 0;
+  uint32_t sector;
+  uint32_t old;
+  uint16_t eb;
+  uint16_t lastused;
+  uint16_t i;
+  ssize_t  nxfrd;
+
+  dev->openblk = UINT16_MAX;
+  dev->nfree   = 0;
+
+  for (eb = 0; eb < dev->geo.neraseblocks; eb++)
+    {
+      nxfrd = MTD_BREAD(dev->mtd, (off_t)eb * dev->blkper, dev->hdrblks,
+                        (FAR uint8_t *)dev->gchdr);
+      if (nxfrd != dev->hdrblks)
+        {
+          ferr("ERROR: Read header of erase block %d failed: %d\n",
+               eb, nxfrd);
+          return -EIO;
+        }
+
+      if (dev->gchdr[0] != FTL_MAGIC)
+        {
+          /* Erased or not formatted for the mapped FTL */
+
+          dev->state[eb] = FTL_EBLOCK_FREE;
+          continue;
+        }
+
+      dev->state[eb] = FTL_EBLOCK_USED;
+      dev->ebseq[eb] = dev->gchdr[1];
+
+      for (i = 0; i < dev->ndata; i++)
+        {
+          sector = entries[i];
+          if (sector >= dev->nsectors)
+            {
+              /* Free, uncommitted or invalid */
+
+              continue;
+            }
+
+          old = dev->map[sector];
+          if (old != FTL_UNMAPPED)
+            {
+              if (dev->ebseq[old / dev->blkper] > dev->ebseq[eb])
+                {
+                  continue;
+                }
+
+              dev->nvalid[old / dev->blkper]--;
+            }
+
+          dev->map[sector] = (off_t)eb * dev->blkper + dev->hdrblks + i;
+          dev->nvalid[eb]++;
+        }
+
+      /* Re-open the most recent erase block if it has room */
+
+      if (dev->ebseq[eb] >= maxseq)
+        {
+          maxseq = dev->ebseq[eb];
+
+          for (lastused = dev->ndata; lastused > 0; lastused--)
+            {
+              if (entries[lastused - 1] != FTL_ENTRY_FREE)
+                {
+                  break;
+                }
+            }
+
+          dev->openblk = eb;
+          dev->wrndx   = lastused;
+          memcpy(dev->hdr, dev->gchdr, dev->hdrblks * dev->geo.blocksize);
+        }
+    }
+
+  dev->seq = maxseq;
+
+  if (dev->openblk < dev->geo.neraseblocks)
+    {
+      dev->state[dev->openblk] = FTL_EBLOCK_OPEN;
+    }
+
+  /* Blocks without current sectors can be reclaimed without copying */
+
+  for (eb = 0; eb < dev->geo.neraseblocks; eb++)
+    {
+      if (dev->state[eb] == FTL_EBLOCK_USED && dev->nvalid[eb] == 0)
+        {
+          dev->state[eb] = FTL_EBLOCK_FREE;
+        }
+
+      if (dev->state[eb] == FTL_EBLOCK_FREE)
+        {
+          dev->nfree++;
+        }
+    }
+
+  finfo("%d sectors, %d free erase blocks, open block %d\n",
+        dev->nsectors, dev->nfree, dev->openblk);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_mapped_initialize
+ *
+ * Description:
+ *   Size the erase block headers, allocate the sector map and scan the
+ *   FLASH.
+ *
+ ****************************************************************************/
+
+static int ftl_mapped_initialize(FAR struct ftl_struct_s *dev)
+{
+  uint16_t neb = dev->geo.neraseblocks;
+  size_t hdrsize;
+  int ret;
+
+  /* Find the smallest header that has an entry for each remaining block */
+
+  for (dev->hdrblks = 1; dev->hdrblks < dev->blkper; dev->hdrblks++)
+    {
+      if (FTL_HDRSIZE(dev->blkper - dev->hdrblks) <=
+          dev->hdrblks * dev->geo.blocksize)
+        {
+          break;
+        }
+    }
+
+  if (dev->hdrblks >= dev->blkper || neb <= CONFIG_FTL_MAPPED_NSPARE)
+    {
+      ferr("ERROR: Geometry not supported by the mapped FTL\n");
+      return -EINVAL;
+    }
+
+  dev->ndata    = dev->blkper - dev->hdrblks;
+  dev->nsectors = (size_t)(neb - CONFIG_FTL_MAPPED_NSPARE) * dev->ndata;
+  hdrsize       = dev->hdrblks * dev->geo.blocksize;
+
+  dev->map    = (FAR uint32_t *)kmm_malloc(dev->nsectors * sizeof(uint32_t));
+  dev->ebseq  = (FAR uint32_t *)kmm_zalloc(neb * sizeof(uint32_t));
+  dev->nvalid = (FAR uint16_t *)kmm_zalloc(neb * sizeof(uint16_t));
+  dev->state  = (FAR uint8_t *)kmm_zalloc(neb);
+  dev->hdr    = (FAR uint32_t *)kmm_malloc(hdrsize);
+  dev->gchdr  = (FAR uint32_t *)kmm_malloc(hdrsize);
+  dev->gclist = (FAR uint32_t *)kmm_malloc(dev->ndata * sizeof(uint32_t));
+
+  if (dev->map == NULL || dev->ebseq == NULL || dev->nvalid == NULL ||
+      dev->state == NULL || dev->hdr == NULL || dev->gchdr == NULL ||
+      dev->gclist == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  memset(dev->map, 0xff, dev->nsectors * sizeof(uint32_t));
+
+  ret = ftl_mapped_scan(dev);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  return OK;
+
+errout:
+  ftl_mapped_uninitialize(dev);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ftl_mapped_uninitialize
+ ****************************************************************************/
+
+static void ftl_mapped_uninitialize(FAR struct ftl_struct_s *dev)
+{
+  kmm_free(dev->map);
+  kmm_free(dev->ebseq);
+  kmm_free(dev->nvalid);
+  kmm_free(dev->state);
+  kmm_free(dev->hdr);
+  kmm_free(dev->gchdr);
+  kmm_free(dev->gclist);
+}
+#endif /* CONFIG_FTL_MAPPED */
 
 /****************************************************************************
  * Name: ftl_write
@@ -443,7 +1135,7 @@ static ssize_t ftl_write(FAR struct inode *inode,
 #ifdef FTL_HAVE_RWBUFFER
   return rwb_write(&dev->rwb, start_sector, nsectors, buffer);
 #else
-  return ftl_flush(dev, buffer, start_sector, nsectors);
+  return ftl_doflush(dev, buffer, start_sector, nsectors);
 #endif
 }
 
@@ -468,7 +1160,11 @@ static int ftl_geometry(FAR struct inode *inode,
       geometry->geo_available     = true;
       geometry->geo_mediachanged  = false;
       geometry->geo_writeenabled  = true;
+#ifdef CONFIG_FTL_MAPPED
+      geometry->geo_nsectors      = dev->nsectors;
+#else
       geometry->geo_nsectors      = dev->geo.neraseblocks * dev->blkper;
+#endif
       geometry->geo_sectorsize    = dev->geo.blocksize;
 
       finfo("available: true mediachanged: false writeenabled: %s\n",
@@ -506,6 +1202,12 @@ static int ftl_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 
   if (cmd == BIOC_XIPBASE)
     {
+#ifdef CONFIG_FTL_MAPPED
+      /* Sectors are not at fixed locations in FLASH */
+
+      return -ENOTTY;
+#endif
+
       /* The argument accompanying the BIOC_XIPBASE should be non-NULL.  If
        * DEBUG is enabled, we will catch it here instead of in the MTD
        * driver.
@@ -570,6 +1272,9 @@ static int ftl_unlink(FAR struct inode *inode)
           kmm_free(dev->eblock);
         }
 
+#ifdef CONFIG_FTL_MAPPED
+      ftl_mapped_uninitialize(dev);
+#endif
       kmm_free(dev);
     }
 
@@ -635,19 +1340,39 @@ int ftl_initialize_by_path(FAR const char *path, FAR struct mtd_dev_s *mtd)
       dev->blkper = dev->geo.erasesize / dev->geo.blocksize;
       DEBUGASSERT(dev->blkper * dev->geo.blocksize == dev->geo.erasesize);
 
+#ifdef CONFIG_FTL_MAPPED
+      /* Build the sector map from the erase block headers */
+
+      ret = ftl_mapped_initialize(dev);
+      if (ret < 0)
+        {
+          ferr("ERROR: ftl_mapped_initialize failed: %d\n", ret);
+          kmm_free(dev);
+          return ret;
+        }
+#endif
+
       /* Configure read-ahead/write buffering */
 
 #ifdef FTL_HAVE_RWBUFFER
       dev->rwb.blocksize     = dev->geo.blocksize;
+#ifdef CONFIG_FTL_MAPPED
+      dev->rwb.nblocks       = dev->nsectors;
+#else
       dev->rwb.nblocks       = dev->geo.neraseblocks * dev->blkper;
+#endif
       dev->rwb.dev           = (FAR void *)dev;
-      dev->rwb.wrflush       = ftl_flush;
-      dev->rwb.rhreload      = ftl_reload;
+      dev->rwb.wrflush       = ftl_doflush;
+      dev->rwb.rhreload      = ftl_doreload;
 
 #if defined(CONFIG_FTL_WRITEBUFFER)
       dev->rwb.wrmaxblocks   = dev->blkper;
+#ifndef CONFIG_FTL_MAPPED
+      /* Flush whole erase blocks since each flush rewrites them anyway */
+
       dev->rwb.wralignblocks = dev->blkper;
 #endif
+#endif
 
 #ifdef CONFIG_FTL_READAHEAD
       dev->rwb.rhmaxblocks   = dev->blkper;
@@ -657,6 +1382,9 @@ int ftl_initialize_by_path(FAR const char *path, FAR struct mtd_dev_s *mtd)
       if (ret < 0)
         {
           ferr("ERROR: rwb_initialize failed: %d\n", ret);
+#ifdef CONFIG_FTL_MAPPED
+          ftl_mapped_uninitialize(dev);
+#endif
           kmm_free(dev);
           return ret;
         }
@@ -670,6 +1398,9 @@ int ftl_initialize_by_path(FAR const char *path, FAR struct mtd_dev_s *mtd)
           ferr("ERROR: register_blockdriver failed: %d\n", -ret);
 #ifdef FTL_HAVE_RWBUFFER
           rwb_uninitialize(&dev->rwb);
+#endif
+#ifdef CONFIG_FTL_MAPPED
+          ftl_mapped_uninitialize(dev);
 #endif
           kmm_free(dev);
         }
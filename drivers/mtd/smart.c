@@ -59,6 +59,8 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mtd/mtd.h>
@@ -116,6 +118,25 @@
 #define SMART_WEAR_LEVEL_FORMAT_SIG 32
 #define SMART_PARTNAME_SIZE         4
 
+/* Background garbage collection keeps this many free sectors available.
+ * The synchronous collector in the write path only keeps one erase block
+ * (plus a few sectors) in reserve.
+ */
+
+#ifdef CONFIG_MTD_SMART_BGGC
+#  ifndef CONFIG_MTD_SMART_BGGC_RESERVE
+#    define CONFIG_MTD_SMART_BGGC_RESERVE 2
+#  endif
+#  if CONFIG_MTD_SMART_BGGC_RESERVE < 2
+#    error CONFIG_MTD_SMART_BGGC_RESERVE must be at least 2
+#  endif
+#  define smart_lock(d)   nxsem_wait_uninterruptible(&(d)->exclsem)
+#  define smart_unlock(d) nxsem_post(&(d)->exclsem)
+#else
+#  define smart_lock(d)   OK
+#  define smart_unlock(d)
+#endif
+
 #define SMART_FIRST_DIR_SECTOR      3       /* First root directory sector */
 #define SMART_FIRST_ALLOC_SECTOR    12      /* First logical sector number
                                              * we will use for assignment
@@ -241,6 +262,16 @@ struct smart_struct_s
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
   uint32_t              unusedsectors;    /* Count of unused sectors (i.e. free when erased) */
   uint32_t              blockerases;      /* Count of unused sectors (i.e. free when erased) */
+  uint32_t              gcblocks;         /* Blocks collected in the write path */
+  uint32_t              bggcblocks;       /* Blocks collected in the background */
+  uint32_t              relocsectors;     /* Count of sectors relocated */
+#endif
+#ifdef CONFIG_MTD_SMART_BGGC
+  sem_t                 exclsem;          /* Serializes the FS and background GC */
+  sem_t                 gcdone;           /* Posted when a stopped GC work ends */
+  struct work_s         gcwork;           /* Background garbage collection work */
+  bool                  gcbusy;           /* GC work is queued or running */
+  bool                  gcstop;           /* Do not queue GC work any more */
 #endif
   uint16_t              neraseblocks;     /* Number of erase blocks or sub-sectors */
   uint16_t              lastallocblock;   /* Last  block we allocated a sector from */
@@ -435,6 +466,9 @@ static int     smart_validate_crc(FAR struct smart_struct_s *dev);
 static int     smart_read_wearstatus(FAR struct smart_struct_s *dev);
 static int     smart_relocate_static_data(FAR struct smart_struct_s *dev,
                  uint16_t block);
+#ifdef CONFIG_MTD_SMART_BGGC
+static int     smart_write_wearstatus(struct smart_struct_s *dev);
+#endif
 #endif
 
 static int     smart_relocate_sector(FAR struct smart_struct_s *dev,
@@ -443,6 +477,10 @@ static int     smart_relocate_sector(FAR struct smart_struct_s *dev,
 #ifdef CONFIG_MTD_SMART_FSCK
 static int     smart_fsck(FAR struct smart_struct_s *dev);
 #endif
+#ifdef CONFIG_MTD_SMART_BGGC
+static void    smart_gc_schedule(FAR struct smart_struct_s *dev);
+static void    smart_gc_worker(FAR void *arg);
+#endif
 
 #ifdef CONFIG_SMART_DEV_LOOP
 static ssize_t smart_loop_read(FAR struct file *filep, FAR char *buffer,
@@ -893,6 +931,7 @@ static ssize_t smart_read(FAR struct inode *inode, unsigned char *buffer,
                           size_t start_sector, unsigned int nsectors)
 {
   FAR struct smart_struct_s *dev;
+  ssize_t ret;
 
   finfo("SMART: sector: %d nsectors: %d\n", start_sector, nsectors);
 
@@ -902,7 +941,16 @@ static ssize_t smart_read(FAR struct inode *inode, unsigned char *buffer,
 #else
   dev = (struct smart_struct_s *)inode->i_private;
 #endif
-  return smart_reload(dev, buffer, start_sector, nsectors);
+
+  ret = smart_lock(dev);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = smart_reload(dev, buffer, start_sector, nsectors);
+  smart_unlock(dev);
+  return ret;
 }
 
 /****************************************************************************
@@ -939,7 +987,11 @@ static ssize_t smart_write(FAR struct inode *inode,
   dev = (FAR struct smart_struct_s *)inode->i_private;
 #endif
 
-  /* I think maybe we need to lock on a mutex here */
+  ret = smart_lock(dev);
+  if (ret < 0)
+    {
+      return ret;
+    }
 
   /* Get the aligned block.  Here is is assumed: (1) The number of R/W blocks
    * per erase block is a power of 2, and (2) the erase begins with that same
@@ -978,9 +1030,7 @@ static ssize_t smart_write(FAR struct inode *inode,
           if (ret < 0)
             {
               ferr("ERROR: Erase block=%d failed: %d\n", eraseblock, ret);
-
-              /* Unlock the mutex if we add one */
-
+              smart_unlock(dev);
               return ret;
             }
         }
@@ -1007,9 +1057,7 @@ static ssize_t smart_write(FAR struct inode *inode,
           /* The block is not empty!!  What to do? */
 
           ferr("ERROR: Write block %d failed: %d.\n", nextblock, nxfrd);
-
-          /* Unlock the mutex if we add one */
-
+          smart_unlock(dev);
           return -EIO;
         }
 
@@ -1021,6 +1069,7 @@ static ssize_t smart_write(FAR struct inode *inode,
       alignedblock += mtdblkspererase;
     }
 
+  smart_unlock(dev);
   return nsectors;
 }
 
@@ -3428,6 +3477,10 @@ static int smart_relocate_sector(FAR struct smart_struct_s *dev,
       ferr("ERROR: Error %d releasing old sector %d\n" -ret, oldsector);
     }
 
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
+  dev->relocsectors++;
+#endif
+
 errout:
   return ret;
 }
@@ -3971,129 +4024,158 @@ retry:
 }
 
 /****************************************************************************
- * Name: smart_garbagecollect
+ * Name: smart_gc_needed
  *
- * Description:  Performs garbage collection if needed.  This is determined
- *               by the count of released sectors relative to free and
- *               total sectors.
+ * Description:  Returns true if garbage collection is needed to keep at
+ *               least 'reserve' free sectors available.
  *
  ****************************************************************************/
 
-static int smart_garbagecollect(FAR struct smart_struct_s *dev)
+static bool smart_gc_needed(FAR struct smart_struct_s *dev,
+                            uint16_t reserve)
 {
-  uint16_t  collectblock;
-  uint16_t  releasemax;
-  bool      collect = TRUE;
-  int       x;
-  int       ret;
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
-  uint8_t   count;
-#endif
+  /* Test if the released sectors count is greater than the free sectors.
+   * If it is, then we will do garbage collection.
+   */
 
-  while (collect)
+  if (dev->releasesectors > dev->freesectors && dev->freesectors <
+      (dev->totalsectors >> 5))
     {
-      collect = FALSE;
-
-      /* Test if the released sectors count is greater than the
-       * free sectors.  If it is, then we will do garbage collection.
-       */
-
-      if (dev->releasesectors > dev->freesectors && dev->freesectors <
-          (dev->totalsectors >> 5))
-        {
-          collect = TRUE;
-        }
+      return true;
+    }
 
-      /* Test if we have more reached our reserved free sector limit */
+  /* Test if we have reached the reserved free sector limit */
 
-      if (dev->freesectors <= (dev->sectorsperblk << 0) + 4)
-        {
-          collect = TRUE;
-        }
+  return dev->freesectors <= reserve;
+}
 
-      /* Test if we need to garbage collect */
+/****************************************************************************
+ * Name: smart_find_collectblock
+ *
+ * Description:  Finds the erase block with the most released sectors.  Of
+ *               blocks with the same count, the least worn one is chosen.
+ *               Returns 0xffff if no block has at least 'minrelease'
+ *               released sectors.
+ *
+ ****************************************************************************/
 
-      if (collect)
-        {
-          /* Find the block with the most released sectors */
+static uint16_t smart_find_collectblock(FAR struct smart_struct_s *dev,
+                                        uint16_t minrelease)
+{
+  uint16_t  collectblock = 0xffff;
+  uint16_t  releasemax = minrelease > 0 ? minrelease - 1 : 0;
+  uint16_t  count;
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+  uint8_t   wearlevel;
+  uint8_t   collectwear = 0;
+#endif
+  int       x;
 
-          collectblock = 0xffff;
-          releasemax = 0;
-          for (x = 0; x < dev->neraseblocks; x++)
-            {
+  for (x = 0; x < dev->neraseblocks; x++)
+    {
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
-              /* Don't collect blocks that have been worn completely */
+      /* Don't collect blocks that have been worn completely */
 
-              if (smart_get_wear_level(dev, x) >= SMART_WEAR_REORG_THRESHOLD)
-                {
-                  continue;
-                }
+      wearlevel = smart_get_wear_level(dev, x);
+      if (wearlevel >= SMART_WEAR_REORG_THRESHOLD)
+        {
+          continue;
+        }
 #endif
 
 #ifdef CONFIG_MTD_SMART_PACK_COUNTS
-              count = smart_get_count(dev, dev->releasecount, x);
-              if (count > releasemax)
-                {
-                  releasemax = count;
-                  collectblock = x;
-                }
+      count = smart_get_count(dev, dev->releasecount, x);
 #else
-              if (dev->releasecount[x] > releasemax)
-                {
-                  releasemax = dev->releasecount[x];
-                  collectblock = x;
-                }
+      count = dev->releasecount[x];
 #endif
-            }
 
-#if 0
-          releasemax = smart_get_count(dev, dev->releasecount, collectblock);
+      if (count > releasemax)
+        {
+          releasemax   = count;
+          collectblock = x;
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+          collectwear  = wearlevel;
+#endif
+        }
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+      else if (count == releasemax && collectblock != 0xffff &&
+               wearlevel < collectwear)
+        {
+          collectblock = x;
+          collectwear  = wearlevel;
+        }
 #endif
+    }
 
-          if (collectblock == 0xffff)
-            {
-              /* Need to collect, but no sectors with released blocks! */
+  return collectblock;
+}
 
-              ret = -ENOSPC;
-              goto errout;
-            }
+/****************************************************************************
+ * Name: smart_garbagecollect
+ *
+ * Description:  Performs garbage collection if needed.  This is determined
+ *               by the count of released sectors relative to free and
+ *               total sectors.
+ *
+ ****************************************************************************/
+
+static int smart_garbagecollect(FAR struct smart_struct_s *dev)
+{
+  uint16_t  collectblock;
+  int       ret;
+
+  while (smart_gc_needed(dev, dev->sectorsperblk + 4))
+    {
+      /* Find the block with the most released sectors */
+
+      collectblock = smart_find_collectblock(dev, 1);
+      if (collectblock == 0xffff)
+        {
+          /* Need to collect, but no sectors with released blocks! */
+
+          ret = -ENOSPC;
+          goto errout;
+        }
 
 #ifdef CONFIG_SMART_LOCAL_CHECKFREE
-          if (smart_checkfree(dev, __LINE__) != OK)
-            {
-              fwarn("   ...before collecting block %d\n", collectblock);
-            }
+      if (smart_checkfree(dev, __LINE__) != OK)
+        {
+          fwarn("   ...before collecting block %d\n", collectblock);
+        }
 #endif
 
 #ifdef CONFIG_MTD_SMART_PACK_COUNTS
-          finfo("Collecting block %d, free=%d released=%d, "
-                "totalfree=%d, totalrelease=%d\n",
-                collectblock,
-                smart_get_count(dev, dev->freecount, collectblock),
-                smart_get_count(dev, dev->releasecount, collectblock),
-                dev->freesectors, dev->releasesectors);
+      finfo("Collecting block %d, free=%d released=%d, "
+            "totalfree=%d, totalrelease=%d\n",
+            collectblock,
+            smart_get_count(dev, dev->freecount, collectblock),
+            smart_get_count(dev, dev->releasecount, collectblock),
+            dev->freesectors, dev->releasesectors);
 #else
-          finfo("Collecting block %d, free=%d released=%d\n",
-                collectblock, dev->freecount[collectblock],
-                dev->releasecount[collectblock]);
+      finfo("Collecting block %d, free=%d released=%d\n",
+            collectblock, dev->freecount[collectblock],
+            dev->releasecount[collectblock]);
 #endif
 
-          /* Relocate the active data in the collection block */
+      /* Relocate the active data in the collection block */
 
-          ret = smart_relocate_block(dev, collectblock);
+      ret = smart_relocate_block(dev, collectblock);
 
 #ifdef CONFIG_SMART_LOCAL_CHECKFREE
-          if (smart_checkfree(dev, __LINE__) != OK)
-            {
-              fwarn("   ...while collecting block %d\n", collectblock);
-            }
+      if (smart_checkfree(dev, __LINE__) != OK)
+        {
+          fwarn("   ...while collecting block %d\n", collectblock);
+        }
 #endif
 
-          if (ret != OK)
-            {
-              goto errout;
-            }
+      if (ret != OK)
+        {
+          goto errout;
         }
+
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
+      dev->gcblocks++;
+#endif
     }
 
   return OK;
@@ -4102,6 +4184,120 @@ errout:
   return ret;
 }
 
+/****************************************************************************
+ * Name: smart_gc_schedule
+ *
+ * Description:  Schedules background garbage collection if the free sector
+ *               reserve has been used up.
+ *
+ * Assumptions:  The device is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_BGGC
+static void smart_gc_schedule(FAR struct smart_struct_s *dev)
+{
+  if (!dev->gcstop && dev->formatstatus == SMART_FMT_STAT_FORMATTED &&
+      dev->releasesectors > 0 && work_available(&dev->gcwork) &&
+      smart_gc_needed(dev, dev->sectorsperblk *
+                      CONFIG_MTD_SMART_BGGC_RESERVE + 4))
+    {
+      dev->gcbusy = true;
+      work_queue(LPWORK, &dev->gcwork, smart_gc_worker, dev, 0);
+    }
+}
+
+/****************************************************************************
+ * Name: smart_gc_worker
+ *
+ * Description:  Collects one erase block on the low priority work queue
+ *               and reschedules itself until the free sector reserve is
+ *               restored.  Only blocks with at least a quarter of their
+ *               sectors released are collected so that the background
+ *               collector does not add needless wear.
+ *
+ ****************************************************************************/
+
+static void smart_gc_worker(FAR void *arg)
+{
+  FAR struct smart_struct_s *dev = (FAR struct smart_struct_s *)arg;
+  uint16_t minrelease;
+  uint16_t collectblock;
+  int ret;
+
+  ret = smart_lock(dev);
+  if (ret < 0)
+    {
+      return;
+    }
+
+  if (dev->gcstop ||
+      !smart_gc_needed(dev, dev->sectorsperblk *
+                       CONFIG_MTD_SMART_BGGC_RESERVE + 4))
+    {
+      goto out;
+    }
+
+  minrelease = dev->sectorsperblk >> 2;
+  if (minrelease == 0)
+    {
+      minrelease = 1;
+    }
+
+  collectblock = smart_find_collectblock(dev, minrelease);
+  if (collectblock == 0xffff)
+    {
+      goto out;
+    }
+
+  finfo("Background collecting block %d, totalfree=%d totalrelease=%d\n",
+        collectblock, dev->freesectors, dev->releasesectors);
+
+  ret = smart_relocate_block(dev, collectblock);
+  if (ret < 0)
+    {
+      ferr("ERROR: Background collection of block %d failed: %d\n",
+           collectblock, ret);
+      goto out;
+    }
+
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
+  dev->bggcblocks++;
+#endif
+
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+  if (dev->wearflags & SMART_WEARFLAGS_WRITE_NEEDED)
+    {
+      /* Write new wear status bits to the device */
+
+      smart_write_wearstatus(dev);
+    }
+#endif
+
+  /* Release the lock between blocks so that the file system is never held
+   * off for more than one block relocation.
+   */
+
+  smart_gc_schedule(dev);
+
+out:
+  if (work_available(&dev->gcwork))
+    {
+      /* The work was not queued again.  If the device is being torn down,
+       * let the teardown go on once the lock is released.
+       */
+
+      dev->gcbusy = false;
+      if (dev->gcstop)
+        {
+          nxsem_post(&dev->gcdone);
+        }
+    }
+
+  smart_unlock(dev);
+}
+#endif /* CONFIG_MTD_SMART_BGGC */
+
 /****************************************************************************
  * Name: smart_write_wearstatus
  *
@@ -5458,6 +5654,12 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
   dev = (FAR struct smart_struct_s *)inode->i_private;
 #endif
 
+  ret = smart_lock(dev);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
   /* Process the ioctl's we care about first, pass any we don't respond
    * to directly to the underlying MTD device.
    */
@@ -5474,7 +5676,8 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
       if (arg == 0)
         {
           ferr("ERROR: BIOC_XIPBASE argument is NULL\n");
-          return -EINVAL;
+          ret = -EINVAL;
+          goto ok_out;
         }
 #endif
 
@@ -5583,6 +5786,9 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
       procfs_data->uneven_wearcount = dev->uneven_wearcount;
 #endif
+      procfs_data->gcblocks       = dev->gcblocks;
+      procfs_data->bggcblocks     = dev->bggcblocks;
+      procfs_data->relocsectors   = dev->relocsectors;
       ret = OK;
       goto ok_out;
 #endif
@@ -5616,6 +5822,10 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
     }
 
 ok_out:
+#ifdef CONFIG_MTD_SMART_BGGC
+  smart_gc_schedule(dev);
+#endif
+  smart_unlock(dev);
   return ret;
 }
 
@@ -6151,6 +6361,11 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd,
       /* Initialize the SMART device structure */
 
       dev->mtd = mtd;
+#ifdef CONFIG_MTD_SMART_BGGC
+      nxsem_init(&dev->exclsem, 0, 1);
+      nxsem_init(&dev->gcdone, 0, 0);
+      nxsem_set_protocol(&dev->gcdone, SEM_PRIO_NONE);
+#endif
 
       /* Get the device geometry. (casting to uintptr_t first eliminates
        * complaints on some architectures where the sizeof long is different
@@ -6380,6 +6595,9 @@ static int smart_loteardown(FAR const char *devname)
 {
   FAR struct smart_struct_s *dev;
   FAR struct inode *inode;
+#ifdef CONFIG_MTD_SMART_BGGC
+  bool busy;
+#endif
   int ret;
 
   /* Sanity check */
@@ -6416,6 +6634,35 @@ static int smart_loteardown(FAR const char *devname)
 
   close_blockdriver(inode);
 
+#ifdef CONFIG_MTD_SMART_BGGC
+  /* Stop background garbage collection.  Once gcstop is set, the worker
+   * does not queue itself again.  Work that is still queued is cancelled.
+   * Work that is already running (or waiting for the lock) finishes and
+   * posts gcdone, and the lock is taken once more so that the worker has
+   * released it before the device is freed.
+   */
+
+  smart_lock(dev);
+  dev->gcstop = true;
+  if (dev->gcbusy && work_cancel(LPWORK, &dev->gcwork) == OK)
+    {
+      dev->gcbusy = false;
+    }
+
+  busy = dev->gcbusy;
+  smart_unlock(dev);
+
+  if (busy)
+    {
+      nxsem_wait_uninterruptible(&dev->gcdone);
+      smart_lock(dev);
+      smart_unlock(dev);
+    }
+
+  nxsem_destroy(&dev->gcdone);
+  nxsem_destroy(&dev->exclsem);
+#endif
+
   /* Now teardown the filemtd */
 
   filemtd_teardown(dev->mtd);
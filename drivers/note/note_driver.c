@@ -24,6 +24,7 @@
 
 #include <nuttx/note/note_driver.h>
 #include <nuttx/note/noteram_driver.h>
+#include <nuttx/note/notepcpu_driver.h>
 
 /****************************************************************************
  * Public Functions
@@ -56,5 +57,13 @@ int note_register(void)
     }
 #endif
 
+#ifdef CONFIG_DRIVER_NOTEPCPU
+  ret = notepcpu_register();
+  if (ret < 0)
+    {
+      return ret;
+    }
+#endif
+
   return ret;
 }
@@ -0,0 +1,484 @@
+/****************************************************************************
+ * drivers/note/notepcpu_driver.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/sched_note.h>
+#include <nuttx/note/notepcpu_driver.h>
+#include <nuttx/fs/fs.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+#  define NOTEPCPU_NCPUS     CONFIG_SMP_NCPUS
+#else
+#  define NOTEPCPU_NCPUS     1
+#endif
+
+/* Without CONFIG_SPINLOCK there is only one CPU and a note is added with
+ * interrupts disabled, so the reader cannot see a partial note.
+ */
+
+#ifndef SP_DMB
+#  define SP_DMB()
+#endif
+
+#define NOTEPCPU_BUFSIZE     CONFIG_DRIVER_NOTEPCPU_BUFSIZE
+#define NOTEPCPU_RECSIZE     sizeof(struct notepcpu_record_s)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Each CPU owns one circular buffer.  Only that CPU writes notes into the
+ * buffer and moves ni_head; only the reader moves ni_tail.  Since each
+ * index has a single writer, no lock is needed between the two sides.
+ * A note that does not fit is dropped (and counted) rather than
+ * overwriting older notes, because overwriting would require the writer
+ * to move ni_tail too.
+ */
+
+struct notepcpu_info_s
+{
+  volatile unsigned int ni_head;
+  volatile unsigned int ni_tail;
+  uint16_t ni_dropped;          /* Notes dropped since the last stored one */
+  uint8_t ni_buffer[NOTEPCPU_BUFSIZE];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static ssize_t notepcpu_read(FAR struct file *filep,
+                             FAR char *buffer, size_t buflen);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_notepcpu_fops =
+{
+  NULL,           /* open */
+  NULL,           /* close */
+  notepcpu_read,  /* read */
+  NULL,           /* write */
+  NULL,           /* seek */
+  NULL,           /* ioctl */
+  NULL            /* poll */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , 0             /* unlink */
+#endif
+};
+
+static struct notepcpu_info_s g_notepcpu_info[NOTEPCPU_NCPUS];
+
+/* Serializes readers.  Writers never take it. */
+
+static sem_t g_notepcpu_sem = SEM_INITIALIZER(1);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: notepcpu_length
+ *
+ * Description:
+ *   Length of data currently in the circular buffer described by the
+ *   provided head and tail indices.
+ *
+ ****************************************************************************/
+
+static inline unsigned int notepcpu_length(unsigned int head,
+                                           unsigned int tail)
+{
+  if (tail > head)
+    {
+      head += NOTEPCPU_BUFSIZE;
+    }
+
+  return head - tail;
+}
+
+/****************************************************************************
+ * Name: notepcpu_copyin
+ *
+ * Description:
+ *   Copy 'len' bytes into the circular buffer at index 'head', handling
+ *   wraparound.  Returns the index following the copied data.
+ *
+ ****************************************************************************/
+
+static unsigned int notepcpu_copyin(FAR struct notepcpu_info_s *info,
+                                    unsigned int head,
+                                    FAR const void *src, size_t len)
+{
+  FAR const uint8_t *ptr = src;
+  size_t chunk;
+
+  chunk = NOTEPCPU_BUFSIZE - head;
+  if (chunk > len)
+    {
+      chunk = len;
+    }
+
+  memcpy(&info->ni_buffer[head], ptr, chunk);
+  memcpy(info->ni_buffer, ptr + chunk, len - chunk);
+
+  head += len;
+  if (head >= NOTEPCPU_BUFSIZE)
+    {
+      head -= NOTEPCPU_BUFSIZE;
+    }
+
+  return head;
+}
+
+/****************************************************************************
+ * Name: notepcpu_copyout
+ *
+ * Description:
+ *   Copy 'len' bytes out of the circular buffer at index 'tail', handling
+ *   wraparound.  Returns the index following the copied data.
+ *
+ ****************************************************************************/
+
+static unsigned int notepcpu_copyout(FAR struct notepcpu_info_s *info,
+                                     unsigned int tail,
+                                     FAR void *dest, size_t len)
+{
+  FAR uint8_t *ptr = dest;
+  size_t chunk;
+
+  chunk = NOTEPCPU_BUFSIZE - tail;
+  if (chunk > len)
+    {
+      chunk = len;
+    }
+
+  memcpy(ptr, &info->ni_buffer[tail], chunk);
+  memcpy(ptr + chunk, info->ni_buffer, len - chunk);
+
+  tail += len;
+  if (tail >= NOTEPCPU_BUFSIZE)
+    {
+      tail -= NOTEPCPU_BUFSIZE;
+    }
+
+  return tail;
+}
+
+/****************************************************************************
+ * Name: notepcpu_peek
+ *
+ * Description:
+ *   Get the record header and the total length of the oldest record of a
+ *   CPU without removing it.
+ *
+ * Returned Value:
+ *   The total length of the record (header and note) or zero if the
+ *   buffer of the CPU is empty.
+ *
+ ****************************************************************************/
+
+static size_t notepcpu_peek(FAR struct notepcpu_info_s *info,
+                            FAR struct notepcpu_record_s *rec)
+{
+  unsigned int tail = info->ni_tail;
+  uint8_t notelen;
+
+  if (info->ni_head == tail)
+    {
+      return 0;
+    }
+
+  /* Do not read the record before the head index that published it */
+
+  SP_DMB();
+
+  tail = notepcpu_copyout(info, tail, rec, NOTEPCPU_RECSIZE);
+  notepcpu_copyout(info, tail, &notelen, 1);
+  return NOTEPCPU_RECSIZE + notelen;
+}
+
+/****************************************************************************
+ * Name: notepcpu_before
+ *
+ * Description:
+ *   Return true if the record 'r1' was generated before 'r2'.
+ *
+ ****************************************************************************/
+
+static bool notepcpu_before(FAR const struct notepcpu_record_s *r1,
+                            FAR const struct notepcpu_record_s *r2)
+{
+  int i;
+
+  for (i = 3; i >= 0; i--)
+    {
+      if (r1->nr_sec[i] != r2->nr_sec[i])
+        {
+          return r1->nr_sec[i] < r2->nr_sec[i];
+        }
+    }
+
+  for (i = 3; i >= 0; i--)
+    {
+      if (r1->nr_nsec[i] != r2->nr_nsec[i])
+        {
+          return r1->nr_nsec[i] < r2->nr_nsec[i];
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: notepcpu_read
+ *
+ * Description:
+ *   Return the stream header (on the first read after open) followed by as
+ *   many records as fit into the user buffer.  The records of all CPUs are
+ *   merged in time order.
+ *
+ ****************************************************************************/
+
+static ssize_t notepcpu_read(FAR struct file *filep,
+                             FAR char *buffer, size_t buflen)
+{
+  FAR struct notepcpu_info_s *info;
+  struct notepcpu_record_s best;
+  struct notepcpu_record_s rec;
+  unsigned int tail;
+  ssize_t retlen = 0;
+  size_t bestlen;
+  size_t reclen;
+  int bestcpu;
+  int cpu;
+
+  DEBUGASSERT(filep != NULL && buffer != NULL && buflen > 0);
+
+  nxsem_wait_uninterruptible(&g_notepcpu_sem);
+
+  if (filep->f_pos == 0)
+    {
+      FAR struct notepcpu_header_s *hdr;
+
+      if (buflen < sizeof(struct notepcpu_header_s))
+        {
+          retlen = -EFBIG;
+          goto errout_with_sem;
+        }
+
+      hdr              = (FAR struct notepcpu_header_s *)buffer;
+      hdr->nh_magic[0] = NOTEPCPU_MAGIC0;
+      hdr->nh_magic[1] = NOTEPCPU_MAGIC1;
+      hdr->nh_magic[2] = NOTEPCPU_MAGIC2;
+      hdr->nh_magic[3] = NOTEPCPU_MAGIC3;
+      hdr->nh_version  = NOTEPCPU_VERSION;
+      hdr->nh_ncpus    = NOTEPCPU_NCPUS;
+#ifdef CONFIG_SMP
+      hdr->nh_flags    = NOTEPCPU_FLAG_SMP;
+#else
+      hdr->nh_flags    = 0;
+#endif
+      hdr->nh_reserved = 0;
+
+      retlen = sizeof(struct notepcpu_header_s);
+    }
+
+  /* Merge the per-CPU streams, always taking the oldest pending record */
+
+  for (; ; )
+    {
+      bestcpu = -1;
+      bestlen = 0;
+
+      for (cpu = 0; cpu < NOTEPCPU_NCPUS; cpu++)
+        {
+          reclen = notepcpu_peek(&g_notepcpu_info[cpu], &rec);
+          if (reclen > 0 && (bestcpu < 0 || notepcpu_before(&rec, &best)))
+            {
+              best    = rec;
+              bestlen = reclen;
+              bestcpu = cpu;
+            }
+        }
+
+      if (bestcpu < 0)
+        {
+          break;
+        }
+
+      if (bestlen > buflen - retlen)
+        {
+          /* Report the error only if nothing at all could be returned */
+
+          if (retlen == 0)
+            {
+              retlen = -EFBIG;
+            }
+
+          break;
+        }
+
+      /* Finish reading the record before the writer may reuse the space */
+
+      info = &g_notepcpu_info[bestcpu];
+      tail = notepcpu_copyout(info, info->ni_tail, buffer + retlen,
+                              bestlen);
+      SP_DMB();
+      info->ni_tail = tail;
+      retlen += bestlen;
+    }
+
+  if (retlen > 0)
+    {
+      filep->f_pos += retlen;
+    }
+
+errout_with_sem:
+  nxsem_post(&g_notepcpu_sem);
+  return retlen;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_note_add
+ *
+ * Description:
+ *   Add the variable length note to the buffer of the current CPU.  Only
+ *   local interrupts are disabled; no spinlock or critical section is
+ *   taken, so this may be used with CONFIG_SCHED_INSTRUMENTATION_CSECTION
+ *   and CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS.
+ *
+ * Input Parameters:
+ *   note    - The note buffer
+ *   notelen - The buffer length
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void sched_note_add(FAR const void *note, size_t notelen)
+{
+  FAR struct notepcpu_info_s *info;
+  struct notepcpu_record_s rec;
+  struct timespec ts;
+  irqstate_t flags;
+  unsigned int head;
+  uint32_t sec;
+  uint32_t nsec;
+  int cpu;
+
+  DEBUGASSERT(note != NULL && notelen > 0 &&
+              NOTEPCPU_RECSIZE + notelen < NOTEPCPU_BUFSIZE);
+
+  flags = up_irq_save();
+  cpu   = up_cpu_index();
+  info  = &g_notepcpu_info[cpu];
+  head  = info->ni_head;
+
+  if (NOTEPCPU_RECSIZE + notelen >=
+      NOTEPCPU_BUFSIZE - notepcpu_length(head, info->ni_tail))
+    {
+      /* No space.  Drop the note; the reader will see the count. */
+
+      if (info->ni_dropped < UINT16_MAX)
+        {
+          info->ni_dropped++;
+        }
+
+      up_irq_restore(flags);
+      return;
+    }
+
+  clock_systime_timespec(&ts);
+  sec  = (uint32_t)ts.tv_sec;
+  nsec = (uint32_t)ts.tv_nsec;
+
+  rec.nr_cpu        = (uint8_t)cpu;
+  rec.nr_reserved   = 0;
+  rec.nr_dropped[0] = (uint8_t)(info->ni_dropped & 0xff);
+  rec.nr_dropped[1] = (uint8_t)((info->ni_dropped >> 8) & 0xff);
+  rec.nr_sec[0]     = (uint8_t)(sec         & 0xff);
+  rec.nr_sec[1]     = (uint8_t)((sec >> 8)  & 0xff);
+  rec.nr_sec[2]     = (uint8_t)((sec >> 16) & 0xff);
+  rec.nr_sec[3]     = (uint8_t)((sec >> 24) & 0xff);
+  rec.nr_nsec[0]    = (uint8_t)(nsec         & 0xff);
+  rec.nr_nsec[1]    = (uint8_t)((nsec >> 8)  & 0xff);
+  rec.nr_nsec[2]    = (uint8_t)((nsec >> 16) & 0xff);
+  rec.nr_nsec[3]    = (uint8_t)((nsec >> 24) & 0xff);
+
+  head = notepcpu_copyin(info, head, &rec, NOTEPCPU_RECSIZE);
+  head = notepcpu_copyin(info, head, note, notelen);
+
+  /* Make the record visible before publishing the new head index */
+
+  SP_DMB();
+  info->ni_head    = head;
+  info->ni_dropped = 0;
+
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: notepcpu_register
+ *
+ * Description:
+ *   Register the per-CPU RAM note driver at /dev/note that can be used by
+ *   an application to read the merged note streams of all CPUs.
+ *
+ * Input Parameters:
+ *   None.
+ *
+ * Returned Value:
+ *   Zero on success. A negated errno value is returned on a failure.
+ *
+ ****************************************************************************/
+
+int notepcpu_register(void)
+{
+  return register_driver("/dev/note", &g_notepcpu_fops, 0444, NULL);
+}
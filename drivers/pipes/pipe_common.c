@@ -63,6 +63,19 @@
 #  define pipe_dumpbuffer(m,a,n)
 #endif
 
+/* With CONFIG_DEV_PIPE_LOCKFREE, the reader publishes d_rdndx and the
+ * writer publishes d_wrndx.  Each side loads the other side's index with
+ * acquire semantics so that the buffer contents are visible before the
+ * index is.  The full fence orders publishing an index against checking
+ * whether the peer waits for it (and vice versa for the waiting side).
+ */
+
+#ifdef CONFIG_DEV_PIPE_LOCKFREE
+#  define PIPE_LOAD(p)     __atomic_load_n(p, __ATOMIC_ACQUIRE)
+#  define PIPE_STORE(p,v)  __atomic_store_n(p, v, __ATOMIC_RELEASE)
+#  define PIPE_FENCE()     __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -108,12 +121,34 @@ static void pipecommon_pollnotify(FAR struct pipe_dev_s *dev,
           if (fds->revents != 0)
             {
               finfo("Report events: %02x\n", fds->revents);
-              nxsem_post(fds->sem);
+              poll_notify(fds);
             }
         }
     }
 }
 
+/****************************************************************************
+ * Name: pipecommon_wakeup
+ *
+ * Description:
+ *   Wake up the reader or writer waiting on 'sem' if it has announced that
+ *   it is (about to be) waiting through 'waiting'.  Only the caller that
+ *   clears the flag posts the semaphore.  A post that arrives after the
+ *   waiter has already seen the condition change is harmless:  all waiters
+ *   re-check their condition when they are awakened.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DEV_PIPE_LOCKFREE
+static void pipecommon_wakeup(FAR sem_t *sem, FAR uint8_t *waiting)
+{
+  if (__atomic_exchange_n(waiting, 0, __ATOMIC_SEQ_CST) != 0)
+    {
+      nxsem_post(sem);
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -147,6 +182,11 @@ FAR struct pipe_dev_s *pipecommon_allocdev(size_t bufsize)
       nxsem_set_protocol(&dev->d_rdsem, SEM_PRIO_NONE);
       nxsem_set_protocol(&dev->d_wrsem, SEM_PRIO_NONE);
 
+#ifdef CONFIG_DEV_PIPE_LOCKFREE
+      nxsem_init(&dev->d_rdlock, 0, 1);
+      nxsem_init(&dev->d_wrlock, 0, 1);
+#endif
+
       dev->d_bufsize = bufsize;
     }
 
@@ -162,6 +202,10 @@ void pipecommon_freedev(FAR struct pipe_dev_s *dev)
   nxsem_destroy(&dev->d_bfsem);
   nxsem_destroy(&dev->d_rdsem);
   nxsem_destroy(&dev->d_wrsem);
+#ifdef CONFIG_DEV_PIPE_LOCKFREE
+  nxsem_destroy(&dev->d_rdlock);
+  nxsem_destroy(&dev->d_wrlock);
+#endif
   kmm_free(dev);
 }
 
@@ -173,6 +217,9 @@ int pipecommon_open(FAR struct file *filep)
 {
   FAR struct inode      *inode = filep->f_inode;
   FAR struct pipe_dev_s *dev   = inode->i_private;
+#ifdef CONFIG_DEV_PIPE_LOCKFREE
+  uint8_t                nwropens;
+#endif
   int                    sval;
   int                    ret;
 
@@ -212,6 +259,9 @@ int pipecommon_open(FAR struct file *filep)
   if ((filep->f_oflags & O_WROK) != 0)
     {
       dev->d_nwriters++;
+#ifdef CONFIG_DEV_PIPE_LOCKFREE
+      dev->d_nwropens++;
+#endif
 
       /* If this is the first writer, then the read semaphore indicates the
        * number of readers waiting for the first writer.  Wake them all up.
@@ -240,12 +290,29 @@ int pipecommon_open(FAR struct file *filep)
    * read (policy == 1).
    */
 
+#ifdef CONFIG_DEV_PIPE_LOCKFREE
+  nwropens = dev->d_nwropens;
+#endif
+
   sched_lock();
   nxsem_post(&dev->d_bfsem);
 
+#ifdef CONFIG_DEV_PIPE_LOCKFREE
+  /* The lock-free read logic may leave a stale count on d_rdsem, so the
+   * condition is re-checked after each wake-up.  A writer that opened the
+   * pipe while we were waiting ends the wait, even if it has already
+   * closed the pipe again.
+   */
+
+  while ((filep->f_oflags & O_RDWR) == O_RDONLY &&  /* Read-only */
+         dev->d_nwriters < 1 &&                     /* No writers */
+         dev->d_nwropens == nwropens &&             /* None opened since */
+         dev->d_wrndx == dev->d_rdndx)              /* Buffer is empty */
+#else
   if ((filep->f_oflags & O_RDWR) == O_RDONLY &&  /* Read-only */
       dev->d_nwriters < 1 &&                     /* No writers on the pipe */
       dev->d_wrndx == dev->d_rdndx)              /* Buffer is empty */
+#endif
     {
       /* NOTE: d_rdsem is normally used when the read logic waits for more
        * data to be written.  But until the first writer has opened the
@@ -268,6 +335,9 @@ int pipecommon_open(FAR struct file *filep)
           /* Immediately close the pipe that we just opened */
 
           pipecommon_close(filep);
+#ifdef CONFIG_DEV_PIPE_LOCKFREE
+          break;
+#endif
         }
     }
 
@@ -321,6 +391,13 @@ int pipecommon_close(FAR struct file *filep)
 
           if (--dev->d_nwriters <= 0)
             {
+#ifdef CONFIG_DEV_PIPE_LOCKFREE
+              /* Wake up a reader blocked in pipecommon_read() */
+
+              PIPE_FENCE();
+              pipecommon_wakeup(&dev->d_rdsem, &dev->d_rdwait);
+#endif
+
               while (nxsem_get_value(&dev->d_rdsem, &sval) == 0 && sval < 0)
                 {
                   nxsem_post(&dev->d_rdsem);
@@ -387,6 +464,322 @@ int pipecommon_close(FAR struct file *filep)
   return OK;
 }
 
+#ifdef CONFIG_DEV_PIPE_LOCKFREE
+/****************************************************************************
+ * Name: pipecommon_read
+ ****************************************************************************/
+
+ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
+{
+  FAR struct inode      *inode  = filep->f_inode;
+  FAR struct pipe_dev_s *dev    = inode->i_private;
+  ssize_t                nread  = 0;
+  pipe_ndx_t             rdndx;
+  pipe_ndx_t             wrndx;
+  size_t                 nbytes;
+  int                    ret;
+
+  DEBUGASSERT(dev);
+
+  if (len == 0)
+    {
+      return 0;
+    }
+
+  /* Make sure that we are the only reader of the ring buffer.  Another
+   * reader keeps the lock while it waits for data, so do not wait for the
+   * lock if O_NONBLOCK was set.
+   */
+
+  if (filep->f_oflags & O_NONBLOCK)
+    {
+      ret = nxsem_trywait(&dev->d_rdlock);
+    }
+  else
+    {
+      ret = nxsem_wait(&dev->d_rdlock);
+    }
+
+  if (ret < 0)
+    {
+      /* May fail with EAGAIN if another reader holds the lock, because a
+       * signal was received or if the task was canceled.
+       */
+
+      return ret;
+    }
+
+  /* If the pipe is empty, then wait for something to be written to it */
+
+  rdndx = dev->d_rdndx;
+  while ((wrndx = PIPE_LOAD(&dev->d_wrndx)) == rdndx)
+    {
+      /* If there are no writers on the pipe, then return end of file.  The
+       * last writer may have written before it closed, so look again.
+       */
+
+      if (dev->d_nwriters <= 0)
+        {
+          PIPE_FENCE();
+          if (PIPE_LOAD(&dev->d_wrndx) == rdndx)
+            {
+              goto out;
+            }
+
+          continue;
+        }
+
+      /* If O_NONBLOCK was set, then return EGAIN */
+
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          nread = -EAGAIN;
+          goto out;
+        }
+
+      /* Otherwise, announce that we are waiting and wait for something to
+       * be written to the pipe, unless that happened in the meantime.
+       */
+
+      __atomic_store_n(&dev->d_rdwait, 1, __ATOMIC_SEQ_CST);
+      PIPE_FENCE();
+
+      if (PIPE_LOAD(&dev->d_wrndx) == rdndx && dev->d_nwriters > 0)
+        {
+          ret = nxsem_wait(&dev->d_rdsem);
+        }
+
+      __atomic_store_n(&dev->d_rdwait, 0, __ATOMIC_SEQ_CST);
+      if (ret < 0)
+        {
+          /* May fail because a signal was received or if the task was
+           * canceled.
+           */
+
+          nread = ret;
+          goto out;
+        }
+    }
+
+  /* Then return whatever is available in the pipe (which is at least one
+   * byte), in at most two contiguous pieces.
+   */
+
+  while ((size_t)nread < len && rdndx != wrndx)
+    {
+      nbytes = (wrndx > rdndx ? wrndx : dev->d_bufsize) - rdndx;
+      if (nbytes > len - nread)
+        {
+          nbytes = len - nread;
+        }
+
+      memcpy(buffer + nread, &dev->d_buffer[rdndx], nbytes);
+      nread += nbytes;
+      rdndx += nbytes;
+      if (rdndx >= dev->d_bufsize)
+        {
+          rdndx = 0;
+        }
+    }
+
+  /* Give the space back to the writer and wake it up if it is waiting for
+   * space.
+   */
+
+  PIPE_STORE(&dev->d_rdndx, rdndx);
+  PIPE_FENCE();
+  pipecommon_wakeup(&dev->d_wrsem, &dev->d_wrwait);
+
+  /* Notify all poll/select waiters that they can write to the FIFO */
+
+  if (dev->d_npolls > 0)
+    {
+      pipecommon_semtake(&dev->d_bfsem);
+      pipecommon_pollnotify(dev, POLLOUT);
+      nxsem_post(&dev->d_bfsem);
+    }
+
+  pipe_dumpbuffer("From PIPE:", (FAR uint8_t *)buffer, nread);
+
+out:
+  nxsem_post(&dev->d_rdlock);
+  return nread;
+}
+
+/****************************************************************************
+ * Name: pipecommon_write
+ ****************************************************************************/
+
+ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
+                         size_t len)
+{
+  FAR struct inode      *inode    = filep->f_inode;
+  FAR struct pipe_dev_s *dev      = inode->i_private;
+  ssize_t                nwritten = 0;
+  pipe_ndx_t             rdndx;
+  pipe_ndx_t             wrndx;
+  size_t                 nbytes;
+  int                    ret;
+
+  DEBUGASSERT(dev);
+  pipe_dumpbuffer("To PIPE:", (FAR uint8_t *)buffer, len);
+
+  /* Handle zero-length writes */
+
+  if (len == 0)
+    {
+      return 0;
+    }
+
+  /* REVISIT:  SIGPIPE is not generated (see the non-lock-free version) */
+
+  if (dev->d_nreaders <= 0)
+    {
+      return -EPIPE;
+    }
+
+  DEBUGASSERT(up_interrupt_context() == false);
+
+  /* Make sure that we are the only writer of the ring buffer.  Another
+   * writer keeps the lock while it waits for space, so do not wait for the
+   * lock if O_NONBLOCK was set.
+   */
+
+  if (filep->f_oflags & O_NONBLOCK)
+    {
+      ret = nxsem_trywait(&dev->d_wrlock);
+    }
+  else
+    {
+      ret = nxsem_wait(&dev->d_wrlock);
+    }
+
+  if (ret < 0)
+    {
+      /* May fail with EAGAIN if another writer holds the lock, because a
+       * signal was received or if the task was canceled.
+       */
+
+      return ret;
+    }
+
+  /* Loop until all of the bytes have been written */
+
+  wrndx = dev->d_wrndx;
+  for (; ; )
+    {
+      /* Copy as much as fits, in at most two contiguous pieces.  One byte
+       * is always left free to tell a full buffer from an empty one.
+       */
+
+      rdndx = PIPE_LOAD(&dev->d_rdndx);
+      while ((size_t)nwritten < len)
+        {
+          if (wrndx >= rdndx)
+            {
+              nbytes = dev->d_bufsize - wrndx - (rdndx == 0 ? 1 : 0);
+            }
+          else
+            {
+              nbytes = rdndx - wrndx - 1;
+            }
+
+          if (nbytes == 0)
+            {
+              break;
+            }
+
+          if (nbytes > len - nwritten)
+            {
+              nbytes = len - nwritten;
+            }
+
+          memcpy(&dev->d_buffer[wrndx], buffer + nwritten, nbytes);
+          nwritten += nbytes;
+          wrndx += nbytes;
+          if (wrndx >= dev->d_bufsize)
+            {
+              wrndx = 0;
+            }
+        }
+
+      if (wrndx != dev->d_wrndx)
+        {
+          /* Publish the new data and wake up the reader if it is waiting
+           * for data.
+           */
+
+          PIPE_STORE(&dev->d_wrndx, wrndx);
+          PIPE_FENCE();
+          pipecommon_wakeup(&dev->d_rdsem, &dev->d_rdwait);
+
+          /* Notify all poll/select waiters that they can read from the
+           * FIFO.
+           */
+
+          if (dev->d_npolls > 0)
+            {
+              pipecommon_semtake(&dev->d_bfsem);
+              pipecommon_pollnotify(dev, POLLIN);
+              nxsem_post(&dev->d_bfsem);
+            }
+        }
+
+      /* Is the write complete? */
+
+      if ((size_t)nwritten >= len)
+        {
+          break;
+        }
+
+      /* If O_NONBLOCK was set, then return partial bytes written or
+       * EGAIN.
+       */
+
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          if (nwritten == 0)
+            {
+              nwritten = -EAGAIN;
+            }
+
+          break;
+        }
+
+      /* There is more to be written.. announce that we are waiting and wait
+       * for data to be removed from the pipe, unless that happened in the
+       * meantime.
+       */
+
+      __atomic_store_n(&dev->d_wrwait, 1, __ATOMIC_SEQ_CST);
+      PIPE_FENCE();
+
+      if (PIPE_LOAD(&dev->d_rdndx) == rdndx)
+        {
+          ret = nxsem_wait(&dev->d_wrsem);
+        }
+
+      __atomic_store_n(&dev->d_wrwait, 0, __ATOMIC_SEQ_CST);
+      if (ret < 0)
+        {
+          /* May fail because a signal was received or if the task was
+           * canceled.
+           */
+
+          if (nwritten == 0)
+            {
+              nwritten = ret;
+            }
+
+          break;
+        }
+    }
+
+  nxsem_post(&dev->d_wrlock);
+  return nwritten;
+}
+
+#else
 /****************************************************************************
  * Name: pipecommon_read
  ****************************************************************************/
@@ -665,6 +1058,8 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
     }
 }
 
+#endif /* CONFIG_DEV_PIPE_LOCKFREE */
+
 /****************************************************************************
  * Name: pipecommon_poll
  ****************************************************************************/
@@ -705,6 +1100,15 @@ int pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds,
 
               dev->d_fds[i] = fds;
               fds->priv     = &dev->d_fds[i];
+#ifdef CONFIG_DEV_PIPE_LOCKFREE
+              dev->d_npolls++;
+
+              /* Order the binding against reading the indices below,
+               * pairing with the fence after an index is published.
+               */
+
+              PIPE_FENCE();
+#endif
               break;
             }
         }
@@ -785,6 +1189,9 @@ int pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds,
 
       *slot                = NULL;
       fds->priv            = NULL;
+#ifdef CONFIG_DEV_PIPE_LOCKFREE
+      dev->d_npolls--;
+#endif
     }
 
 errout:
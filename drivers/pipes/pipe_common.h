@@ -141,6 +141,20 @@ struct pipe_dev_s
   uint8_t    d_flags;       /* See PIPE_FLAG_* definitions */
   uint8_t   *d_buffer;      /* Buffer allocated when device opened */
 
+#ifdef CONFIG_DEV_PIPE_LOCKFREE
+  /* With the lock-free ring, d_bfsem no longer protects the buffer indices.
+   * d_rdndx is only modified by the reader holding d_rdlock and d_wrndx
+   * only by the writer holding d_wrlock.
+   */
+
+  sem_t      d_rdlock;      /* Serializes readers */
+  sem_t      d_wrlock;      /* Serializes writers */
+  uint8_t    d_rdwait;      /* Reader is waiting on d_rdsem for data */
+  uint8_t    d_wrwait;      /* Writer is waiting on d_wrsem for space */
+  uint8_t    d_npolls;      /* Number of bound poll structures */
+  uint8_t    d_nwropens;    /* Number of write opens (wraps around) */
+#endif
+
   /* The following is a list if poll structures of threads waiting for
    * driver events. The 'struct pollfd' reference for each open is also
    * retained in the f_priv field of the 'struct file'.
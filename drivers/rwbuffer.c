@@ -950,6 +950,34 @@ static ssize_t rwb_read_(FAR struct rwbuffer_s *rwb, off_t startblock,
                 }
             }
 
+          /* If what is left would not fit in the read-ahead buffer, read it
+           * directly into the user buffer with a single transfer rather
+           * than in read-ahead buffer sized pieces that must be copied.
+           *
+           * Read-ahead then happens only on shorter reads:  The buffer is
+           * refilled with rhmaxblocks blocks from the first missing one, so
+           * the blocks that follow a short read are already loaded.  No
+           * blocks are prefetched after a direct read.  rhreload() is
+           * synchronous, so such a prefetch would only move the next
+           * transfer forward in time, and it would split a following long
+           * read into a buffered and a direct part.
+           */
+
+          if (remaining >= rwb->rhmaxblocks)
+            {
+              ret = rwb->rhreload(rwb->dev, rdbuffer, startblock, remaining);
+              if (ret != remaining)
+                {
+                  ferr("ERROR: Failed to read %d blocks: %d\n",
+                       remaining, ret);
+
+                  rwb_semgive(&rwb->rhsem);
+                  return ret < 0 ? ret : -EIO;
+                }
+
+              break;
+            }
+
           /* If we did not get all of the data from the buffer, then we have
            * to refill the buffer and try again.
            */
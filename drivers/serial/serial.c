@@ -160,24 +160,12 @@ static void uart_pollnotify(FAR uart_dev_t *dev, pollevent_t eventset)
 #endif
           if (fds->revents != 0)
             {
-              irqstate_t flags;
-              int semcount;
-
-              finfo("Report events: %02x\n", fds->revents);
-
-              /* Limit the number of times that the semaphore is posted.
-               * The critical section is needed to make the following
-               * operation atomic.
+              /* poll_notify() limits the number of times that the
+               * semaphore is posted.
                */
 
-              flags = enter_critical_section();
-              nxsem_get_value(fds->sem, &semcount);
-              if (semcount < 1)
-                {
-                  nxsem_post(fds->sem);
-                }
-
-              leave_critical_section(flags);
+              finfo("Report events: %02x\n", fds->revents);
+              poll_notify(fds);
             }
         }
     }
@@ -49,6 +49,25 @@
 #  define CONFIG_FS_NAIOC 8
 #endif
 
+#ifndef CONFIG_FS_AIO_NTHREADS
+#  define CONFIG_FS_AIO_NTHREADS 0
+#endif
+
+#ifndef CONFIG_FS_AIO_BATCH
+#  define CONFIG_FS_AIO_BATCH 1
+#endif
+
+/* When the I/O is performed on the low-priority work queue, the worker
+ * must restore the priority of the work queue that aio_queue() boosted.
+ * The AIO worker threads manage their own priority.
+ */
+
+#if defined(CONFIG_PRIORITY_INHERITANCE) && CONFIG_FS_AIO_NTHREADS == 0
+#  define aio_restorepriority(p) lpwork_restorepriority(p)
+#else
+#  define aio_restorepriority(p) UNUSED(p)
+#endif
+
 #undef AIO_HAVE_PSOCK
 
 #ifdef CONFIG_NET_TCP
@@ -79,6 +98,7 @@ struct aio_container_s
   } u;
   struct work_s aioc_work;         /* Used to defer I/O to the work thread */
   pid_t aioc_pid;                  /* ID of the waiting task */
+  uint8_t aioc_op;                 /* LIO_READ, LIO_WRITE or LIO_NOP */
 #ifdef CONFIG_PRIORITY_INHERITANCE
   uint8_t aioc_prio;               /* Priority of the waiting task */
 #endif
@@ -220,7 +240,8 @@ FAR struct aiocb *aioc_decant(FAR struct aio_container_s *aioc);
  * Name: aio_queue
  *
  * Description:
- *   Schedule the asynchronous I/O on the low priority work queue
+ *   Schedule the asynchronous I/O on the low priority work queue or, if
+ *   CONFIG_FS_AIO_NTHREADS is non-zero, on the AIO worker threads.
  *
  * Input Parameters:
  *   arg - Worker argument.  In this case, a pointer to an instance of
@@ -234,6 +255,24 @@ FAR struct aiocb *aioc_decant(FAR struct aio_container_s *aioc);
 
 int aio_queue(FAR struct aio_container_s *aioc, worker_t worker);
 
+/****************************************************************************
+ * Name: aio_unqueue
+ *
+ * Description:
+ *   Remove an asynchronous I/O from the queue if it has not yet been
+ *   started.
+ *
+ * Input Parameters:
+ *   aioc - The AIO control block container passed to aio_queue()
+ *
+ * Returned Value:
+ *   Zero (OK) if the I/O was removed from the queue.  -ENOENT if the I/O
+ *   has already been started.
+ *
+ ****************************************************************************/
+
+int aio_unqueue(FAR struct aio_container_s *aioc);
+
 /****************************************************************************
  * Name: aio_signal
  *
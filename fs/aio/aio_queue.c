@@ -39,26 +39,462 @@
 
 #include <nuttx/config.h>
 
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <fcntl.h>
 #include <sched.h>
+#include <queue.h>
 #include <aio.h>
+#include <assert.h>
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/kthread.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/wqueue.h>
+#include <nuttx/fs/fs.h>
 
 #include "aio/aio.h"
 
 #ifdef CONFIG_FS_AIO
 
+#if CONFIG_FS_AIO_NTHREADS > 0
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* State of one AIO worker thread */
+
+struct aio_worker_s
+{
+  pid_t pid;                       /* The worker thread */
+  FAR void *busy;                  /* File or socket in service, or NULL */
+};
+
+/* State of the pool of AIO worker threads.  The fields are protected by
+ * aio_lock().
+ *
+ * Queued I/O is held in 'queue', linked through aioc_work.dq.  A worker
+ * takes the oldest request for a file or socket that no other worker is
+ * servicing.  That keeps the requests for one file in order while the
+ * requests for different files can proceed in parallel.
+ */
+
+struct aio_pool_s
+{
+  bool started;                    /* Worker threads have been created */
+  uint8_t nidle;                   /* Number of workers waiting on 'wait' */
+  dq_queue_t queue;                /* Queued, not yet started I/O */
+  sem_t wait;                      /* Idle workers wait here */
+  struct aio_worker_s worker[CONFIG_FS_AIO_NTHREADS];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct aio_pool_s g_aio_pool;
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: aio_pool_container
+ *
+ * Description:
+ *   Return the AIO container that holds the queue entry 'entry'
+ *
+ ****************************************************************************/
+
+static inline FAR struct aio_container_s *
+aio_pool_container(FAR dq_entry_t *entry)
+{
+  return (FAR struct aio_container_s *)((FAR struct work_s *)entry)->arg;
+}
+
+/****************************************************************************
+ * Name: aio_pool_isbusy
+ *
+ * Description:
+ *   Return true if some worker thread is servicing 'ptr'
+ *
+ ****************************************************************************/
+
+static bool aio_pool_isbusy(FAR void *ptr)
+{
+  int wndx;
+
+  for (wndx = 0; wndx < CONFIG_FS_AIO_NTHREADS; wndx++)
+    {
+      if (g_aio_pool.worker[wndx].busy == ptr)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: aio_pool_select
+ *
+ * Description:
+ *   Remove the next I/O that worker 'wndx' may perform from the queue.
+ *   Later reads (or writes) of the same file that each start where the
+ *   previous one ends are removed with it, up to CONFIG_FS_AIO_BATCH
+ *   requests in all.
+ *
+ * Returned Value:
+ *   The number of containers returned in 'batch'.  Zero if there is no
+ *   I/O that the worker may perform now.
+ *
+ * Assumptions:
+ *   The caller holds aio_lock().
+ *
+ ****************************************************************************/
+
+static int aio_pool_select(FAR struct aio_container_s **batch, int wndx)
+{
+  FAR struct aio_container_s *aioc;
+  FAR struct aio_container_s *last;
+  FAR dq_entry_t *entry;
+  FAR dq_entry_t *next;
+  int nbatch;
+
+  /* Find the oldest I/O for a file that no other worker is servicing */
+
+  for (entry = dq_peek(&g_aio_pool.queue); entry != NULL;
+       entry = dq_next(entry))
+    {
+      if (!aio_pool_isbusy(aio_pool_container(entry)->u.ptr))
+        {
+          break;
+        }
+    }
+
+  if (entry == NULL)
+    {
+      return 0;
+    }
+
+  next = dq_next(entry);
+  last = aio_pool_container(entry);
+
+  dq_rem(entry, &g_aio_pool.queue);
+  g_aio_pool.worker[wndx].busy = last->u.ptr;
+  batch[0] = last;
+  nbatch   = 1;
+
+  /* Only reads and writes of files can be combined */
+
+  if (last->aioc_op == LIO_NOP
+#ifdef AIO_HAVE_PSOCK
+      || last->aioc_aiocbp->aio_fildes >= CONFIG_NFILE_DESCRIPTORS
+#endif
+     )
+    {
+      return 1;
+    }
+
+  for (entry = next; entry != NULL && nbatch < CONFIG_FS_AIO_BATCH;
+       entry = next)
+    {
+      next = dq_next(entry);
+      aioc = aio_pool_container(entry);
+
+      /* Skip over the I/O of other files */
+
+      if (aioc->u.ptr != last->u.ptr)
+        {
+          continue;
+        }
+
+      /* Stop at the first I/O of this file that does not continue the
+       * transfer.  Taking any later one would reorder the requests.
+       */
+
+      if (aioc->aioc_op != last->aioc_op ||
+          aioc->aioc_aiocbp->aio_offset !=
+          last->aioc_aiocbp->aio_offset + last->aioc_aiocbp->aio_nbytes)
+        {
+          break;
+        }
+
+      dq_rem(entry, &g_aio_pool.queue);
+      batch[nbatch++] = aioc;
+      last = aioc;
+    }
+
+  return nbatch;
+}
+
+/****************************************************************************
+ * Name: aio_pool_transfer
+ *
+ * Description:
+ *   Perform a batch of reads or writes of one file as selected by
+ *   aio_pool_select().  Requests whose buffers are adjacent in memory are
+ *   performed with a single transfer and the result is divided among them.
+ *
+ ****************************************************************************/
+
+static void aio_pool_transfer(FAR struct aio_container_s **batch,
+                              int nbatch)
+{
+  FAR struct aiocb *aiocbp[CONFIG_FS_AIO_BATCH];
+  pid_t pid[CONFIG_FS_AIO_BATCH];
+  FAR struct file *filep = batch[0]->u.aioc_filep;
+  uint8_t op = batch[0]->aioc_op;
+  int first;
+  int i;
+
+  /* Decant all of the AIO control blocks first.  That releases the
+   * containers as early as possible.
+   */
+
+  for (i = 0; i < nbatch; i++)
+    {
+      pid[i]    = batch[i]->aioc_pid;
+      aiocbp[i] = aioc_decant(batch[i]);
+    }
+
+  for (first = 0; first < nbatch; )
+    {
+      FAR uint8_t *buffer = (FAR uint8_t *)aiocbp[first]->aio_buf;
+      size_t nbytes = aiocbp[first]->aio_nbytes;
+      ssize_t ret;
+      int last;
+
+      /* Extend the transfer over the requests with adjacent buffers */
+
+      for (last = first + 1;
+           last < nbatch &&
+           (FAR uint8_t *)aiocbp[last]->aio_buf == buffer + nbytes;
+           last++)
+        {
+          nbytes += aiocbp[last]->aio_nbytes;
+        }
+
+      if (op == LIO_READ)
+        {
+          ret = file_pread(filep, buffer, nbytes,
+                           aiocbp[first]->aio_offset);
+        }
+      else if ((filep->f_oflags & O_APPEND) != 0)
+        {
+          ret = file_write(filep, buffer, nbytes);
+        }
+      else
+        {
+          ret = file_pwrite(filep, buffer, nbytes,
+                            aiocbp[first]->aio_offset);
+        }
+
+      if (ret < 0)
+        {
+          ferr("ERROR: AIO transfer failed: %d\n", (int)ret);
+        }
+
+      /* Divide the result among the requests and signal the clients */
+
+      for (; first < last; first++)
+        {
+          if (ret < 0)
+            {
+              aiocbp[first]->aio_result = ret;
+            }
+          else
+            {
+              ssize_t nxfrd = aiocbp[first]->aio_nbytes;
+
+              if (nxfrd > ret)
+                {
+                  nxfrd = ret;
+                }
+
+              aiocbp[first]->aio_result = nxfrd;
+              ret -= nxfrd;
+            }
+
+          aio_signal(pid[first], aiocbp[first]);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: aio_pool_thread
+ *
+ * Description:
+ *   The entry point of the AIO worker threads
+ *
+ ****************************************************************************/
+
+static int aio_pool_thread(int argc, FAR char *argv[])
+{
+  FAR struct aio_container_s *batch[CONFIG_FS_AIO_BATCH];
+  pid_t me = getpid();
+  int nbatch;
+  int wndx;
+
+  /* Find our thread index */
+
+  for (wndx = 0; wndx < CONFIG_FS_AIO_NTHREADS; wndx++)
+    {
+      if (g_aio_pool.worker[wndx].pid == me)
+        {
+          break;
+        }
+    }
+
+  DEBUGASSERT(wndx < CONFIG_FS_AIO_NTHREADS);
+
+  for (; ; )
+    {
+#ifdef CONFIG_PRIORITY_INHERITANCE
+      struct sched_param param;
+      uint8_t prio = CONFIG_FS_AIO_PRIORITY;
+      int i;
+#endif
+
+      DEBUGVERIFY(aio_lock());
+
+      nbatch = aio_pool_select(batch, wndx);
+      if (nbatch == 0)
+        {
+          /* Nothing that we can do now.  Wait for more I/O or for another
+           * worker to finish with a file.
+           */
+
+          g_aio_pool.nidle++;
+          aio_unlock();
+
+          nxsem_wait_uninterruptible(&g_aio_pool.wait);
+          continue;
+        }
+
+      aio_unlock();
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+      /* Run at the priority of the highest priority waiting thread */
+
+      for (i = 0; i < nbatch; i++)
+        {
+          if (batch[i]->aioc_prio > prio)
+            {
+              prio = batch[i]->aioc_prio;
+            }
+        }
+
+      if (prio > CONFIG_FS_AIO_PRIORITY)
+        {
+          param.sched_priority = prio;
+          nxsched_set_param(0, &param);
+        }
+#endif
+
+      if (nbatch == 1)
+        {
+          /* The worker decants the AIO control block */
+
+          batch[0]->aioc_work.worker(batch[0]);
+        }
+      else
+        {
+          aio_pool_transfer(batch, nbatch);
+        }
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+      if (prio > CONFIG_FS_AIO_PRIORITY)
+        {
+          param.sched_priority = CONFIG_FS_AIO_PRIORITY;
+          nxsched_set_param(0, &param);
+        }
+#endif
+
+      /* We are no longer servicing the file.  I/O for that file that was
+       * skipped by the other workers may now be performed.
+       */
+
+      DEBUGVERIFY(aio_lock());
+      g_aio_pool.worker[wndx].busy = NULL;
+
+      if (g_aio_pool.nidle > 0 && !dq_empty(&g_aio_pool.queue))
+        {
+          g_aio_pool.nidle--;
+          nxsem_post(&g_aio_pool.wait);
+        }
+
+      aio_unlock();
+    }
+
+  return OK; /* To keep some compilers happy */
+}
+
+/****************************************************************************
+ * Name: aio_pool_start
+ *
+ * Description:
+ *   Create the AIO worker threads when the first I/O is queued.
+ *
+ * Assumptions:
+ *   The caller holds aio_lock().
+ *
+ ****************************************************************************/
+
+static int aio_pool_start(void)
+{
+  pid_t pid;
+  int wndx;
+
+  nxsem_init(&g_aio_pool.wait, 0, 0);
+  nxsem_set_protocol(&g_aio_pool.wait, SEM_PRIO_NONE);
+  dq_init(&g_aio_pool.queue);
+
+  /* Don't permit any of the threads to run until we have fully
+   * initialized g_aio_pool.
+   */
+
+  sched_lock();
+
+  for (wndx = 0; wndx < CONFIG_FS_AIO_NTHREADS; wndx++)
+    {
+      pid = kthread_create("aio", CONFIG_FS_AIO_PRIORITY,
+                           CONFIG_FS_AIO_STACKSIZE,
+                           (main_t)aio_pool_thread,
+                           (FAR char * const *)NULL);
+      if (pid < 0)
+        {
+          ferr("ERROR: kthread_create %d failed: %d\n", wndx, (int)pid);
+          break;
+        }
+
+      g_aio_pool.worker[wndx].pid = pid;
+    }
+
+  /* Carry on with the threads that could be created */
+
+  g_aio_pool.started = (wndx > 0);
+  sched_unlock();
+
+  return wndx > 0 ? OK : (int)pid;
+}
+
+#endif /* CONFIG_FS_AIO_NTHREADS > 0 */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
 /****************************************************************************
  * Name: aio_queue
  *
  * Description:
- *   Schedule the asynchronous I/O on the low priority work queue
+ *   Schedule the asynchronous I/O on the low priority work queue or, if
+ *   CONFIG_FS_AIO_NTHREADS is non-zero, on the AIO worker threads.
  *
  * Input Parameters:
  *   arg - Worker argument.  In this case, a pointer to an instance of
@@ -70,6 +506,50 @@
  *
  ****************************************************************************/
 
+#if CONFIG_FS_AIO_NTHREADS > 0
+int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
+{
+  int ret;
+
+  ret = aio_lock();
+  if (ret >= 0)
+    {
+      if (!g_aio_pool.started)
+        {
+          ret = aio_pool_start();
+        }
+
+      if (ret >= 0)
+        {
+          /* Add the I/O to the queue and wake up an idle worker */
+
+          aioc->aioc_work.worker = worker;
+          aioc->aioc_work.arg    = aioc;
+          dq_addlast(&aioc->aioc_work.dq, &g_aio_pool.queue);
+
+          if (g_aio_pool.nidle > 0)
+            {
+              g_aio_pool.nidle--;
+              nxsem_post(&g_aio_pool.wait);
+            }
+        }
+
+      aio_unlock();
+    }
+
+  if (ret < 0)
+    {
+      FAR struct aiocb *aiocbp = aioc->aioc_aiocbp;
+      DEBUGASSERT(aiocbp);
+
+      aiocbp->aio_result = ret;
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  return ret;
+}
+#else
 int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
 {
   int ret;
@@ -109,5 +589,55 @@ int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
 #endif
   return ret;
 }
+#endif
+
+/****************************************************************************
+ * Name: aio_unqueue
+ *
+ * Description:
+ *   Remove an asynchronous I/O from the queue if it has not yet been
+ *   started.
+ *
+ * Input Parameters:
+ *   aioc - The AIO control block container passed to aio_queue()
+ *
+ * Returned Value:
+ *   Zero (OK) if the I/O was removed from the queue.  -ENOENT if the I/O
+ *   has already been started.
+ *
+ ****************************************************************************/
+
+int aio_unqueue(FAR struct aio_container_s *aioc)
+{
+#if CONFIG_FS_AIO_NTHREADS > 0
+  FAR dq_entry_t *entry;
+  int ret;
+
+  ret = aio_lock();
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (entry = dq_peek(&g_aio_pool.queue);
+       entry != NULL && entry != &aioc->aioc_work.dq;
+       entry = dq_next(entry));
+
+  if (entry != NULL)
+    {
+      dq_rem(entry, &g_aio_pool.queue);
+      ret = OK;
+    }
+  else
+    {
+      ret = -ENOENT;
+    }
+
+  aio_unlock();
+  return ret;
+#else
+  return work_cancel(LPWORK, &aioc->aioc_work);
+#endif
+}
 
 #endif /* CONFIG_FS_AIO */
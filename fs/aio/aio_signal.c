@@ -25,6 +25,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/eventfd.h>
 #include <sched.h>
 #include <signal.h>
 #include <aio.h>
@@ -33,6 +34,7 @@
 #include <debug.h>
 
 #include <nuttx/signal.h>
+#include <nuttx/fs/fs.h>
 
 #include "aio/aio.h"
 
@@ -72,13 +74,33 @@ int aio_signal(pid_t pid, FAR struct aiocb *aiocbp)
 
   ret = OK; /* Assume success */
 
-  /* Signal the client */
+#ifdef CONFIG_FS_AIO_EVENTFD
+  /* Notify the client through an eventfd? */
 
-  ret = nxsig_notification(pid, &aiocbp->aio_sigevent,
-                           SI_ASYNCIO, &aiocbp->aio_sigwork);
-  if (ret < 0)
+  if (aiocbp->aio_sigevent.sigev_notify == SIGEV_EVENTFD)
     {
-      ferr("ERROR: nxsig_notification failed: %d\n", ret);
+      eventfd_t count = 1;
+      ssize_t nwritten;
+
+      DEBUGASSERT(aiocbp->aio_evfilep != NULL);
+      nwritten = file_write(aiocbp->aio_evfilep, &count, sizeof(count));
+      if (nwritten < 0)
+        {
+          ferr("ERROR: eventfd write failed: %d\n", (int)nwritten);
+          ret = (int)nwritten;
+        }
+    }
+  else
+#endif
+    {
+      /* Signal the client */
+
+      ret = nxsig_notification(pid, &aiocbp->aio_sigevent,
+                               SI_ASYNCIO, &aiocbp->aio_sigwork);
+      if (ret < 0)
+        {
+          ferr("ERROR: nxsig_notification failed: %d\n", ret);
+        }
     }
 
   /* Send the poll signal in any event in case the caller is waiting
@@ -105,6 +105,23 @@ FAR struct aio_container_s *aio_contain(FAR struct aiocb *aiocbp)
     }
 #endif
 
+#ifdef CONFIG_FS_AIO_EVENTFD
+  /* The eventfd to be notified must also be looked up in the context of
+   * the caller.
+   */
+
+  aiocbp->aio_evfilep = NULL;
+  if (aiocbp->aio_sigevent.sigev_notify == SIGEV_EVENTFD)
+    {
+      ret = fs_getfilep(aiocbp->aio_sigevent.sigev_value.sival_int,
+                        &aiocbp->aio_evfilep);
+      if (ret < 0)
+        {
+          goto errout;
+        }
+    }
+#endif
+
   /* Allocate the AIO control block container, waiting for one to become
    * available if necessary.  This should not fail except for in the case
    * where the calling thread is canceled.
@@ -43,6 +43,14 @@
 #include <sys/types.h>
 #include <stdint.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Values of the cn_flags field of a node */
+
+#define CROMFS_NODE_BLKINDEX (1 << 0) /* A block index precedes the data */
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -115,12 +123,18 @@ struct cromfs_volume_s
  *                Return 0
  *   st_ctime   - Time of last status change
  *                Return 0
+ *
+ * If CROMFS_NODE_BLKINDEX is set in cn_flags of a file node, the compressed
+ * data blocks are preceded by a block index:  One 32-bit offset to the LZF
+ * header of each block.  Every block except the last holds cv_bsize bytes
+ * of uncompressed data, so the block containing any file position can be
+ * found without walking the blocks that precede it.
  */
 
 struct cromfs_node_s
 {
   uint16_t cn_mode;      /* File type, attributes, and access mode bits */
-  uint16_t cn_pad;       /* Not used */
+  uint16_t cn_flags;     /* See CROMFS_NODE_* definitions */
   uint32_t cn_name;      /* Offset from the beginning of the volume header to the
                           * node name string.  NUL-terminated. */
   uint32_t cn_size;      /* Size of the uncompressed data (in bytes) */
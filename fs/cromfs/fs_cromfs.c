@@ -38,6 +38,7 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/dirent.h>
 #include <nuttx/fs/ioctl.h>
@@ -52,6 +53,10 @@
 
 #define CROMFS_MAX_LINKS 64
 
+#ifndef CONFIG_FS_CROMFS_CACHE_NBLOCKS
+#  define CONFIG_FS_CROMFS_CACHE_NBLOCKS 2
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -61,9 +66,18 @@
 struct cromfs_file_s
 {
   FAR const struct cromfs_node_s *ff_node;  /* The open file node */
-  uint32_t ff_offset;                       /* Cached block offset (zero means none) */
-  uint16_t ff_ulen;                         /* Length of decompressed data in cache */
-  FAR uint8_t *ff_buffer;                   /* Cached, decompressed data */
+  FAR const struct lzf_header_s *ff_blkhdr; /* Last block accessed */
+  uint32_t ff_blkoffs;                      /* File offset of that block */
+};
+
+/* This structure describes one decompressed block in the block cache */
+
+struct cromfs_cache_s
+{
+  FAR const struct lzf_header_s *cc_hdr;    /* Block header (NULL if unused) */
+  uint32_t cc_lastuse;                      /* Time of last use (for LRU) */
+  uint16_t cc_ulen;                         /* Length of decompressed data */
+  FAR uint8_t *cc_buffer;                   /* Decompressed data */
 };
 
 /* This is the form of the callback from cromfs_foreach_node(): */
@@ -124,6 +138,16 @@ static int      cromfs_find_node(FAR const struct cromfs_volume_s *fs,
                   FAR const char *relpath,
                   FAR struct cromfs_nodeinfo_s *info,
                   FAR uint32_t *offset);
+static uint32_t cromfs_block_info(FAR const struct lzf_header_s *hdr,
+                  FAR uint16_t *ulen, FAR uint16_t *clen);
+static FAR const struct lzf_header_s *
+                cromfs_find_block(FAR const struct cromfs_volume_s *fs,
+                  FAR struct cromfs_file_s *ff, uint32_t fpos);
+static FAR struct cromfs_cache_s *
+                cromfs_cache_find(FAR const struct lzf_header_s *hdr);
+static int      cromfs_cache_fill(FAR const struct cromfs_volume_s *fs,
+                  FAR const struct lzf_header_s *hdr,
+                  FAR struct cromfs_cache_s **pcache);
 
 /* Common file system methods */
 
@@ -157,6 +181,21 @@ static int      cromfs_statfs(FAR struct inode *mountpt,
 static int      cromfs_stat(FAR struct inode *mountpt,
                   FAR const char *relpath, FAR struct stat *buf);
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Recently decompressed blocks are retained in a cache that is shared by
+ * all open files.  Since there is only one CROMFS image, there is only one
+ * cache.  The buffers are allocated when first needed and freed when the
+ * last mount of the image is unbound.
+ */
+
+static struct cromfs_cache_s g_cromfs_cache[CONFIG_FS_CROMFS_CACHE_NBLOCKS];
+static sem_t    g_cromfs_cachesem = SEM_INITIALIZER(1);
+static uint32_t g_cromfs_lastuse;  /* Incremented on each cache access */
+static uint16_t g_cromfs_nmounts;  /* Number of mounts of the image */
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -330,7 +369,7 @@ static int cromfs_follow_link(FAR const struct cromfs_volume_s *fs,
            */
 
           newnode->cn_mode    = S_IFDIR | (node->cn_mode & ~S_IFMT);
-          newnode->cn_pad     = 0;
+          newnode->cn_flags   = 0;
           newnode->cn_name    = node->cn_name;
           newnode->cn_size    = 0;
           newnode->cn_peer    = node->cn_peer;
@@ -347,13 +386,13 @@ static int cromfs_follow_link(FAR const struct cromfs_volume_s *fs,
       /* Copy the origin node file name into the writable node copy */
 
       newnode->cn_name   = node->cn_name;
-      newnode->cn_pad    = 0;
 
       /* Copy all attributes of the target node, but retain the hard link
        * file name and, possibly, the peer node reference.
        */
 
       newnode->cn_mode   = linknode->cn_mode;
+      newnode->cn_flags  = linknode->cn_flags;
       newnode->cn_size   = linknode->cn_size;
       newnode->u.cn_link = linknode->u.cn_link;
 
@@ -704,6 +743,214 @@ static int cromfs_find_node(FAR const struct cromfs_volume_s *fs,
     }
 }
 
+/****************************************************************************
+ * Name: cromfs_block_info
+ *
+ * Description:
+ *   Return the uncompressed and compressed data lengths of the block with
+ *   the LZF header 'hdr' and the size of the block including the header.
+ *   For an uncompressed block, both lengths are the same.
+ *
+ ****************************************************************************/
+
+static uint32_t cromfs_block_info(FAR const struct lzf_header_s *hdr,
+                                  FAR uint16_t *ulen, FAR uint16_t *clen)
+{
+  if (hdr->lzf_type == LZF_TYPE0_HDR)
+    {
+      FAR const struct lzf_type0_header_s *hdr0 =
+        (FAR const struct lzf_type0_header_s *)hdr;
+
+      *ulen = (uint16_t)hdr0->lzf_len[0] << 8 |
+              (uint16_t)hdr0->lzf_len[1];
+      *clen = *ulen;
+      return (uint32_t)*ulen + LZF_TYPE0_HDR_SIZE;
+    }
+  else
+    {
+      FAR const struct lzf_type1_header_s *hdr1 =
+        (FAR const struct lzf_type1_header_s *)hdr;
+
+      *ulen = (uint16_t)hdr1->lzf_ulen[0] << 8 |
+              (uint16_t)hdr1->lzf_ulen[1];
+      *clen = (uint16_t)hdr1->lzf_clen[0] << 8 |
+              (uint16_t)hdr1->lzf_clen[1];
+      return (uint32_t)*clen + LZF_TYPE1_HDR_SIZE;
+    }
+}
+
+/****************************************************************************
+ * Name: cromfs_find_block
+ *
+ * Description:
+ *   Return the LZF header of the block of the open file that contains the
+ *   file position 'fpos'.  On return, ff->ff_blkoffs holds the file offset
+ *   of the first byte of that block.
+ *
+ *   If the image provides a block index for the file, the block is found
+ *   directly.  Otherwise, the blocks are walked from the last block found
+ *   (if that lies before 'fpos') or from the beginning of the file.
+ *
+ ****************************************************************************/
+
+static FAR const struct lzf_header_s *
+cromfs_find_block(FAR const struct cromfs_volume_s *fs,
+                  FAR struct cromfs_file_s *ff, uint32_t fpos)
+{
+  FAR const struct cromfs_node_s *node = ff->ff_node;
+  FAR const struct lzf_header_s *hdr;
+  uint32_t blkoffs;
+  uint16_t ulen;
+  uint16_t clen;
+
+  if ((node->cn_flags & CROMFS_NODE_BLKINDEX) != 0)
+    {
+      FAR const uint8_t *blkindex;
+      uint32_t nblocks;
+      uint32_t blkno;
+      uint32_t offset;
+
+      /* The index of 32-bit block offsets ends where the first block
+       * begins.  It may not be aligned.
+       */
+
+      nblocks  = (node->cn_size + fs->cv_bsize - 1) / fs->cv_bsize;
+      blkno    = fpos / fs->cv_bsize;
+      DEBUGASSERT(blkno < nblocks);
+
+      blkindex = (FAR const uint8_t *)fs + node->u.cn_blocks -
+                 nblocks * sizeof(uint32_t);
+      memcpy(&offset, &blkindex[blkno * sizeof(uint32_t)], sizeof(uint32_t));
+
+      hdr      = (FAR const struct lzf_header_s *)
+                 cromfs_offset2addr(fs, offset);
+      blkoffs  = blkno * fs->cv_bsize;
+    }
+  else
+    {
+      /* Start with the last block found if the position is not before it */
+
+      if (ff->ff_blkhdr != NULL && fpos >= ff->ff_blkoffs)
+        {
+          hdr     = ff->ff_blkhdr;
+          blkoffs = ff->ff_blkoffs;
+        }
+      else
+        {
+          hdr     = (FAR const struct lzf_header_s *)
+                    cromfs_offset2addr(fs, node->u.cn_blocks);
+          blkoffs = 0;
+        }
+
+      for (; ; )
+        {
+          uint32_t blksize = cromfs_block_info(hdr, &ulen, &clen);
+
+          if (fpos < blkoffs + ulen)
+            {
+              break;
+            }
+
+          blkoffs += ulen;
+          hdr      = (FAR const struct lzf_header_s *)
+                     ((FAR const uint8_t *)hdr + blksize);
+        }
+    }
+
+  ff->ff_blkhdr  = hdr;
+  ff->ff_blkoffs = blkoffs;
+  return hdr;
+}
+
+/****************************************************************************
+ * Name: cromfs_cache_find
+ *
+ * Description:
+ *   Return the cache entry that holds the decompressed data of the block
+ *   with the LZF header 'hdr', or NULL if the block is not cached.  The
+ *   caller must hold g_cromfs_cachesem for as long as the entry is used.
+ *
+ ****************************************************************************/
+
+static FAR struct cromfs_cache_s *
+cromfs_cache_find(FAR const struct lzf_header_s *hdr)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FS_CROMFS_CACHE_NBLOCKS; i++)
+    {
+      if (g_cromfs_cache[i].cc_hdr == hdr)
+        {
+          g_cromfs_cache[i].cc_lastuse = ++g_cromfs_lastuse;
+          return &g_cromfs_cache[i];
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: cromfs_cache_fill
+ *
+ * Description:
+ *   Decompress the compressed block with the LZF header 'hdr' into the
+ *   least recently used cache entry and return that entry.  The caller
+ *   must hold g_cromfs_cachesem for as long as the entry is used.
+ *
+ ****************************************************************************/
+
+static int cromfs_cache_fill(FAR const struct cromfs_volume_s *fs,
+                             FAR const struct lzf_header_s *hdr,
+                             FAR struct cromfs_cache_s **pcache)
+{
+  FAR struct cromfs_cache_s *victim;
+  unsigned int decomplen;
+  uint16_t ulen;
+  uint16_t clen;
+  int i;
+
+  /* Prefer an unused entry, then the least recently used one */
+
+  victim = &g_cromfs_cache[0];
+  for (i = 1; i < CONFIG_FS_CROMFS_CACHE_NBLOCKS && victim->cc_hdr; i++)
+    {
+      if (g_cromfs_cache[i].cc_hdr == NULL ||
+          (int32_t)(g_cromfs_cache[i].cc_lastuse - victim->cc_lastuse) < 0)
+        {
+          victim = &g_cromfs_cache[i];
+        }
+    }
+
+  if (victim->cc_buffer == NULL)
+    {
+      victim->cc_buffer = (FAR uint8_t *)kmm_malloc(fs->cv_bsize);
+      if (victim->cc_buffer == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  /* Decompress the block into the entry */
+
+  victim->cc_hdr = NULL;
+
+  cromfs_block_info(hdr, &ulen, &clen);
+  decomplen = lzf_decompress((FAR const uint8_t *)hdr + LZF_TYPE1_HDR_SIZE,
+                             clen, victim->cc_buffer, fs->cv_bsize);
+  if (decomplen != ulen)
+    {
+      ferr("ERROR: Failed to decompress block: %u\n", decomplen);
+      return -EIO;
+    }
+
+  victim->cc_hdr     = hdr;
+  victim->cc_ulen    = decomplen;
+  victim->cc_lastuse = ++g_cromfs_lastuse;
+
+  *pcache = victim;
+  return OK;
+}
+
 /****************************************************************************
  * Name: cromfs_open
  ****************************************************************************/
@@ -772,15 +1019,6 @@ static int cromfs_open(FAR struct file *filep, FAR const char *relpath,
       return -ENOMEM;
     }
 
-  /* Create a file buffer to support partial sector accesses */
-
-  ff->ff_buffer = (FAR uint8_t *)kmm_malloc(fs->cv_bsize);
-  if (!ff->ff_buffer)
-    {
-      kmm_free(ff);
-      return -ENOMEM;
-    }
-
   /* Save the node in the open file instance */
 
   ff->ff_node = (FAR const struct cromfs_node_s *)
@@ -806,11 +1044,10 @@ static int cromfs_close(FAR struct file *filep)
   /* Get the open file instance from the file structure */
 
   ff = filep->f_priv;
-  DEBUGASSERT(ff->ff_node != NULL && ff->ff_buffer != NULL);
+  DEBUGASSERT(ff->ff_node != NULL);
 
   /* Free all resources consumed by the opened file */
 
-  kmm_free(ff->ff_buffer);
   kmm_free(ff);
 
   return OK;
@@ -826,17 +1063,18 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
   FAR struct inode *inode;
   FAR const struct cromfs_volume_s *fs;
   FAR struct cromfs_file_s *ff;
-  FAR struct lzf_header_s *currhdr;
-  FAR struct lzf_header_s *nexthdr;
+  FAR const struct lzf_header_s *currhdr;
+  FAR struct cromfs_cache_s *cache;
   FAR uint8_t *dest;
   FAR const uint8_t *src;
   off_t fpos;
   size_t remaining;
-  uint32_t blkoffs;
   uint16_t ulen;
   uint16_t clen;
   unsigned int copysize;
   unsigned int copyoffs;
+  unsigned int decomplen;
+  int ret;
 
   finfo("Read %d bytes from offset %d\n", buflen, filep->f_pos);
   DEBUGASSERT(filep->f_priv != NULL && filep->f_inode != NULL);
@@ -852,7 +1090,7 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
   /* Get the open file instance from the file structure */
 
   ff = (FAR struct cromfs_file_s *)filep->f_priv;
-  DEBUGASSERT(ff->ff_node != NULL && ff->ff_buffer != NULL);
+  DEBUGASSERT(ff->ff_node != NULL);
 
   /* Check for a read past the end of the file */
 
@@ -873,66 +1111,25 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
       buflen = ff->ff_node->cn_size - filep->f_pos;
     }
 
-  /* Find the compressed block containing the current offset, f_pos */
-
   dest      = (FAR uint8_t *)buffer;
   remaining = buflen;
   fpos      = filep->f_pos;
-  blkoffs   = 0;
-  ulen      = 0;
-  nexthdr   = (FAR struct lzf_header_s *)
-               cromfs_offset2addr(fs, ff->ff_node->u.cn_blocks);
-
-  /* Look until we find the compressed block containing the start of the
-   * requested data.
-   */
 
   while (remaining > 0)
     {
-      /* Search for the next block containing the fpos file offset.  This is
-       * real search on the first time through but the remaining blocks
-       * should be contiguous so that the logic should not loop.
-       *
-       */
-
-      do
-        {
-          uint32_t blksize;
-
-          /* Go to the next block */
-
-          currhdr  = nexthdr;
-          blkoffs += ulen;
+      /* Find the block containing the fpos file offset */
 
-          if (currhdr->lzf_type == LZF_TYPE0_HDR)
-            {
-              FAR struct lzf_type0_header_s *hdr0 =
-                (FAR struct lzf_type0_header_s *)currhdr;
+      currhdr  = cromfs_find_block(fs, ff, fpos);
+      cromfs_block_info(currhdr, &ulen, &clen);
 
-              ulen    = (uint16_t)hdr0->lzf_len[0] << 8 |
-                        (uint16_t)hdr0->lzf_len[1];
-              blksize = (uint32_t)ulen + LZF_TYPE0_HDR_SIZE;
-            }
-          else
-            {
-              FAR struct lzf_type1_header_s * hdr1 =
-                (FAR struct lzf_type1_header_s *)currhdr;
-
-              ulen    = (uint16_t)hdr1->lzf_ulen[0] << 8 |
-                        (uint16_t)hdr1->lzf_ulen[1];
-              clen    = (uint16_t)hdr1->lzf_clen[0] << 8 |
-                        (uint16_t)hdr1->lzf_clen[1];
-              blksize = (uint32_t)clen + LZF_TYPE1_HDR_SIZE;
-            }
+      copyoffs = fpos - ff->ff_blkoffs;
+      DEBUGASSERT(ulen > copyoffs);
+      copysize = ulen - copyoffs;
 
-          nexthdr  = (FAR struct lzf_header_s *)
-                     ((FAR uint8_t *)currhdr + blksize);
+      if (copysize > remaining)  /* Clip to the size really needed */
+        {
+          copysize = remaining;
         }
-      while (fpos >= (blkoffs + ulen));
-
-      /* Check if we need to decompress the next block into the user
-       * buffer.
-       */
 
       if (currhdr->lzf_type == LZF_TYPE0_HDR)
         {
@@ -940,103 +1137,57 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
            * user buffer.
            */
 
-          copyoffs = (blkoffs >= filep->f_pos) ? 0 : filep->f_pos - blkoffs;
-          DEBUGASSERT(ulen > copyoffs);
-          copysize = ulen - copyoffs;
-
-          if (copysize > remaining)  /* Clip to the size really needed */
-            {
-              copysize = remaining;
-            }
-
           src = (FAR const uint8_t *)currhdr + LZF_TYPE0_HDR_SIZE;
           memcpy(dest, &src[copyoffs], copysize);
-
-          finfo("blkoffs=%lu ulen=%u copysize=%u\n",
-                (unsigned long)blkoffs, ulen, copysize);
         }
       else
         {
-          /* If the source of the data is at the beginning of the compressed
-           * data buffer and if the uncompressed data would not overrun the
-           * buffer, then we can decompress directly into the user buffer.
-           */
-
-          if (filep->f_pos <= blkoffs && ulen <= remaining)
+          ret = nxsem_wait_uninterruptible(&g_cromfs_cachesem);
+          if (ret < 0)
             {
-              uint32_t voloffs;
-
-              copyoffs = 0;
-              copysize = ulen;
+              return ret;
+            }
 
-              /* Get the address and offset in the CROMFS image to obtain
-               * the data.  Check if we already have this offset in the
-               * cache.
-               */
+          /* Use the decompressed block if it is in the cache.  Otherwise,
+           * if the whole block is wanted, decompress it directly into the
+           * user buffer so that sequential reads do not displace the cached
+           * blocks.  Only decompress partially read blocks into the cache.
+           */
 
-              src     = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
-              voloffs = cromfs_addr2offset(fs, src);
-              if (voloffs != ff->ff_offset)
+          cache = cromfs_cache_find(currhdr);
+          if (cache == NULL && copyoffs == 0 && copysize == ulen)
+            {
+              src       = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
+              decomplen = lzf_decompress(src, clen, dest, ulen);
+              if (decomplen != ulen)
                 {
-                  unsigned int decomplen;
-
-                  decomplen = lzf_decompress(src, clen, dest, fs->cv_bsize);
-
-                  ff->ff_offset = voloffs;
-                  ff->ff_ulen   = decomplen;
+                  ferr("ERROR: Failed to decompress block: %u\n", decomplen);
+                  nxsem_post(&g_cromfs_cachesem);
+                  return -EIO;
                 }
-
-              finfo(
-                "voloffs=%lu blkoffs=%lu ulen=%u ff_offset=%u copysize=%u\n",
-                (unsigned long)voloffs, (unsigned long)blkoffs, ulen,
-                ff->ff_offset, copysize);
-              DEBUGASSERT(ff->ff_ulen >= copysize);
             }
           else
             {
-              uint32_t voloffs;
-
-              /* No, we will need to decompress into the our intermediate
-               * decompression buffer.
-               */
-
-              copyoffs = (blkoffs >= filep->f_pos) ?
-                            0 : filep->f_pos - blkoffs;
-              DEBUGASSERT(ulen > copyoffs);
-              copysize = ulen - copyoffs;
-
-              if (copysize > remaining)  /* Clip to the size really needed */
-                {
-                  copysize = remaining;
-                }
-
-              DEBUGASSERT((copyoffs + copysize) <=  fs->cv_bsize);
-
-              src = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
-              voloffs = cromfs_addr2offset(fs, src);
-              if (voloffs != ff->ff_offset)
+              if (cache == NULL)
                 {
-                  unsigned int decomplen;
-
-                  decomplen = lzf_decompress(src, clen, ff->ff_buffer,
-                                             fs->cv_bsize);
-
-                  ff->ff_offset = voloffs;
-                  ff->ff_ulen   = decomplen;
+                  ret = cromfs_cache_fill(fs, currhdr, &cache);
+                  if (ret < 0)
+                    {
+                      nxsem_post(&g_cromfs_cachesem);
+                      return ret;
+                    }
                 }
 
-              finfo("voloffs=%lu blkoffs=%lu ulen=%u clen=%u ff_offset=%u "
-                    "copyoffs=%u copysize=%u\n",
-                    (unsigned long)voloffs, (unsigned long)blkoffs, ulen,
-                    clen, ff->ff_offset, copyoffs, copysize);
-              DEBUGASSERT(ff->ff_ulen >= (copyoffs + copysize));
-
-              /* Then copy to user buffer */
-
-              memcpy(dest, &ff->ff_buffer[copyoffs], copysize);
+              DEBUGASSERT(cache->cc_ulen >= copyoffs + copysize);
+              memcpy(dest, &cache->cc_buffer[copyoffs], copysize);
             }
+
+          nxsem_post(&g_cromfs_cachesem);
         }
 
+      finfo("blkoffs=%lu ulen=%u clen=%u copyoffs=%u copysize=%u\n",
+            (unsigned long)ff->ff_blkoffs, ulen, clen, copyoffs, copysize);
+
       /* Adjust pointers counts and offset */
 
       dest      += copysize;
@@ -1073,7 +1224,6 @@ static int cromfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
 static int cromfs_dup(FAR const struct file *oldp, FAR struct file *newp)
 {
-  FAR struct cromfs_volume_s *fs;
   FAR struct cromfs_file_s *oldff;
   FAR struct cromfs_file_s *newff;
 
@@ -1081,15 +1231,10 @@ static int cromfs_dup(FAR const struct file *oldp, FAR struct file *newp)
   DEBUGASSERT(oldp->f_priv != NULL && oldp->f_inode != NULL &&
               newp->f_priv == NULL && newp->f_inode != NULL);
 
-  /* Recover our private data from the struct file instance */
-
-  fs = (FAR struct cromfs_volume_s *)oldp->f_inode->i_private;
-  DEBUGASSERT(fs != NULL);
-
   /* Get the open file instance from the file structure */
 
   oldff = oldp->f_priv;
-  DEBUGASSERT(oldff->ff_node != NULL && oldff->ff_buffer != NULL);
+  DEBUGASSERT(oldff->ff_node != NULL);
 
   /* Allocate and initialize an new open file instance referring to the
    * same node.
@@ -1101,15 +1246,6 @@ static int cromfs_dup(FAR const struct file *oldp, FAR struct file *newp)
       return -ENOMEM;
     }
 
-  /* Create a file buffer to support partial sector accesses */
-
-  newff->ff_buffer = (FAR uint8_t *)kmm_malloc(fs->cv_bsize);
-  if (newff->ff_buffer == NULL)
-    {
-      kmm_free(newff);
-      return -ENOMEM;
-    }
-
   /* Save the node in the open file instance */
 
   newff->ff_node = oldff->ff_node;
@@ -1146,7 +1282,7 @@ static int cromfs_fstat(FAR const struct file *filep, FAR struct stat *buf)
    */
 
   ff              = filep->f_priv;
-  DEBUGASSERT(ff->ff_node != NULL && ff->ff_buffer != NULL);
+  DEBUGASSERT(ff->ff_node != NULL);
 
   inode           = filep->f_inode;
   fs              = inode->i_private;
@@ -1377,6 +1513,14 @@ static int cromfs_bind(FAR struct inode *blkdriver, const void *data,
   DEBUGASSERT(blkdriver == NULL && handle != NULL);
   DEBUGASSERT(g_cromfs_image.cv_magic == CROMFS_MAGIC);
 
+  /* Count the mount so that the block cache is kept until the last
+   * unmount.
+   */
+
+  nxsem_wait_uninterruptible(&g_cromfs_cachesem);
+  g_cromfs_nmounts++;
+  nxsem_post(&g_cromfs_cachesem);
+
   /* Return the new file system handle */
 
   *handle = (FAR void *)&g_cromfs_image;
@@ -1394,8 +1538,31 @@ static int cromfs_bind(FAR struct inode *blkdriver, const void *data,
 static int cromfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
                         unsigned int flags)
 {
+  int i;
+
   finfo("handle: %p blkdriver: %p flags: %02x\n",
         handle, blkdriver, flags);
+
+  /* Release the block cache when the last mount goes away */
+
+  nxsem_wait_uninterruptible(&g_cromfs_cachesem);
+  DEBUGASSERT(g_cromfs_nmounts > 0);
+
+  if (--g_cromfs_nmounts == 0)
+    {
+      for (i = 0; i < CONFIG_FS_CROMFS_CACHE_NBLOCKS; i++)
+        {
+          if (g_cromfs_cache[i].cc_buffer != NULL)
+            {
+              kmm_free(g_cromfs_cache[i].cc_buffer);
+            }
+
+          g_cromfs_cache[i].cc_hdr    = NULL;
+          g_cromfs_cache[i].cc_buffer = NULL;
+        }
+    }
+
+  nxsem_post(&g_cromfs_cachesem);
   return OK;
 }
 
@@ -2270,10 +2270,10 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
 
   /* Release the mountpoint private data */
 
-  if (fs->fs_buffer)
-    {
-      fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
-    }
+  fat_fscachefree(fs);
+#ifdef CONFIG_FAT_FREEMAP
+  kmm_free(fs->fs_freemap);
+#endif
 
   nxsem_destroy(&fs->fs_sem);
   kmm_free(fs);
@@ -2506,11 +2506,12 @@ static int fat_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
       goto errout_with_semaphore;
     }
 
-  /* Flush any existing, dirty data in fs_buffer (because we need
-   * it to create the directory entries.
+  /* Use fs_buffer to create the directory entries.  This moves any
+   * existing, dirty data in fs_buffer out of the way and erases the
+   * contents of fs_buffer.
    */
 
-  ret = fat_fscacheflush(fs);
+  ret = fat_fscacheclear(fs, dirsector);
   if (ret < 0)
     {
       goto errout_with_semaphore;
@@ -2520,11 +2521,6 @@ static int fat_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
 
   direntry = fs->fs_buffer;
 
-  /* Now erase the contents of fs_buffer */
-
-  fs->fs_currentsector = dirsector;
-  memset(direntry, 0, fs->fs_hwsectorsize);
-
   /* Now clear all sectors in the new directory cluster (except for the
    * first).
    */
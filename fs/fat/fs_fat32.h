@@ -337,6 +337,18 @@
 
 #define UMOUNT_FORCED        8
 
+/* Number of sectors cached for the mountpoint in addition to the current
+ * sector in fs_buffer.
+ */
+
+#ifndef CONFIG_FAT_SECTORCACHE
+#  define CONFIG_FAT_SECTORCACHE 1
+#endif
+
+#if CONFIG_FAT_SECTORCACHE > 1
+#  define FAT_NCACHESLOTS    (CONFIG_FAT_SECTORCACHE - 1)
+#endif
+
 /****************************************************************************
  * These offset describe the FSINFO sector
  */
@@ -852,6 +864,20 @@
  * Public Types
  ****************************************************************************/
 
+/* This structure describes one sector of the mountpoint sector cache other
+ * than the current sector in fs_buffer.
+ */
+
+#ifdef FAT_NCACHESLOTS
+struct fat_cacheslot_s
+{
+  off_t    cs_sector;              /* Sector held in cs_buffer (-1: none) */
+  uint32_t cs_age;                 /* Value of fs_cacheage when last used */
+  bool     cs_dirty;               /* true: cs_buffer is dirty */
+  uint8_t *cs_buffer;              /* Buffer holding one sector */
+};
+#endif
+
 /* This structure represents the overall mountpoint state.  An instance of
  * this structure is retained as inode private data on each mountpoint that
  * is mounted with a fat32 filesystem.
@@ -886,6 +912,17 @@ struct fat_mountpt_s
   uint8_t  fs_fatsecperclus;       /* MBR: Sectors per allocation unit: 2**n, n=0..7 */
   uint8_t *fs_buffer;              /* This is an allocated buffer to hold one
                                     * sector from the device */
+#ifdef FAT_NCACHESLOTS
+  uint32_t fs_cacheage;            /* Incremented on each use of a cache slot */
+
+  /* The other cached sectors */
+
+  struct fat_cacheslot_s fs_cache[FAT_NCACHESLOTS];
+#endif
+#ifdef CONFIG_FAT_FREEMAP
+  uint32_t *fs_freemap;            /* One bit per cluster, set if in use */
+  uint32_t fs_nfreemap;            /* Number of free clusters in fs_freemap */
+#endif
 };
 
 /* This structure represents on open file under the mountpoint.  An instance
@@ -1084,8 +1121,11 @@ EXTERN int    fat_remove(struct fat_mountpt_s *fs, const char *relpath,
 
 /* Mountpoint and file buffer cache (for partial sector accesses) */
 
+EXTERN int    fat_fscachealloc(struct fat_mountpt_s *fs);
+EXTERN void   fat_fscachefree(struct fat_mountpt_s *fs);
 EXTERN int    fat_fscacheflush(struct fat_mountpt_s *fs);
 EXTERN int    fat_fscacheread(struct fat_mountpt_s *fs, off_t sector);
+EXTERN int    fat_fscacheclear(struct fat_mountpt_s *fs, off_t sector);
 EXTERN int    fat_ffcacheflush(struct fat_mountpt_s *fs,
                                struct fat_file_s *ff);
 EXTERN int    fat_ffcacheread(struct fat_mountpt_s *fs,
@@ -2783,11 +2783,12 @@ int fat_allocatedirentry(FAR struct fat_mountpt_s *fs,
           return cluster;
         }
 
-      /* Flush out any cached data in fs_buffer.. we are going to use
-       * it to initialize the new directory cluster.
+      /* Move any cached data in fs_buffer out of the way.. we are going to
+       * use it to initialize the new directory cluster.
        */
 
-      ret = fat_fscacheflush(fs);
+      sector = fat_cluster2sector(fs, cluster);
+      ret    = fat_fscacheclear(fs, sector);
       if (ret < 0)
         {
           return ret;
@@ -2795,10 +2796,6 @@ int fat_allocatedirentry(FAR struct fat_mountpt_s *fs,
 
       /* Clear all sectors comprising the new directory cluster */
 
-      fs->fs_currentsector = fat_cluster2sector(fs, cluster);
-      memset(fs->fs_buffer, 0, fs->fs_hwsectorsize);
-
-      sector = fs->fs_currentsector;
       for (i = fs->fs_fatsecperclus; i; i--)
         {
           ret = fat_hwwrite(fs, fs->fs_buffer, sector, 1);
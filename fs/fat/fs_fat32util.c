@@ -29,6 +29,7 @@
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <time.h>
 #include <assert.h>
 #include <errno.h>
@@ -257,6 +258,351 @@ static int fat_checkbootrecord(struct fat_mountpt_s *fs)
   return OK;
 }
 
+/****************************************************************************
+ * Name: fat_fscachewrite
+ *
+ * Description:
+ *   Write one dirty sector of the mountpoint cache back to the media.  If
+ *   the sector lies in the FAT region, the copies of the FAT are updated as
+ *   well.
+ *
+ ****************************************************************************/
+
+static int fat_fscachewrite(FAR struct fat_mountpt_s *fs,
+                            FAR uint8_t *buffer, off_t sector)
+{
+  int ret;
+
+  /* Write the dirty sector */
+
+  ret = fat_hwwrite(fs, buffer, sector, 1);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Does the sector lie in the FAT region? */
+
+  if (sector >= fs->fs_fatbase &&
+      sector < fs->fs_fatbase + fs->fs_nfatsects)
+    {
+      int i;
+
+      /* Yes, then make the change in the FAT copy as well */
+
+      for (i = fs->fs_fatnumfats; i >= 2; i--)
+        {
+          sector += fs->fs_nfatsects;
+          ret = fat_hwwrite(fs, buffer, sector, 1);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_fscacheinval
+ *
+ * Description:
+ *   The sectors [sector, sector + nsectors) are about to be written from
+ *   'buffer' without going through the mountpoint cache.  Discard any other
+ *   cached copy of these sectors; it will no longer match the media.
+ *
+ ****************************************************************************/
+
+static void fat_fscacheinval(FAR struct fat_mountpt_s *fs,
+                             FAR const uint8_t *buffer, off_t sector,
+                             unsigned int nsectors)
+{
+#ifdef FAT_NCACHESLOTS
+  int i;
+
+  for (i = 0; i < FAT_NCACHESLOTS; i++)
+    {
+      FAR struct fat_cacheslot_s *slot = &fs->fs_cache[i];
+
+      if (slot->cs_buffer != buffer && slot->cs_sector >= sector &&
+          slot->cs_sector < sector + nsectors)
+        {
+          slot->cs_sector = -1;
+          slot->cs_dirty  = false;
+        }
+    }
+#endif
+
+  if (fs->fs_buffer != buffer && fs->fs_currentsector >= sector &&
+      fs->fs_currentsector < sector + nsectors)
+    {
+      fs->fs_currentsector = -1;
+      fs->fs_dirty         = false;
+    }
+}
+
+#ifdef FAT_NCACHESLOTS
+/****************************************************************************
+ * Name: fat_fscachefind
+ *
+ * Description:
+ *   Return the cache slot holding 'sector' or NULL if the sector is not
+ *   cached (other than, possibly, in fs_buffer).
+ *
+ ****************************************************************************/
+
+static FAR struct fat_cacheslot_s *
+fat_fscachefind(FAR struct fat_mountpt_s *fs, off_t sector)
+{
+  int i;
+
+  for (i = 0; i < FAT_NCACHESLOTS; i++)
+    {
+      if (fs->fs_cache[i].cs_sector == sector)
+        {
+          return &fs->fs_cache[i];
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: fat_fscachesave
+ *
+ * Description:
+ *   Move the current sector out of fs_buffer into the least recently used
+ *   cache slot, writing back the previous contents of that slot if they
+ *   are dirty.  On return, fs_buffer may be reused for another sector.
+ *
+ ****************************************************************************/
+
+static int fat_fscachesave(FAR struct fat_mountpt_s *fs)
+{
+  FAR struct fat_cacheslot_s *victim = &fs->fs_cache[0];
+  int ret;
+  int i;
+
+  if (fs->fs_currentsector < 0)
+    {
+      fs->fs_dirty = false;
+      return OK;
+    }
+
+  /* Prefer an empty slot, otherwise take the least recently used one */
+
+  for (i = 0; i < FAT_NCACHESLOTS && victim->cs_sector >= 0; i++)
+    {
+      FAR struct fat_cacheslot_s *slot = &fs->fs_cache[i];
+
+      if (slot->cs_sector < 0 ||
+          (int32_t)(slot->cs_age - victim->cs_age) < 0)
+        {
+          victim = slot;
+        }
+    }
+
+  if (victim->cs_dirty)
+    {
+      ret = fat_fscachewrite(fs, victim->cs_buffer, victim->cs_sector);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  memcpy(victim->cs_buffer, fs->fs_buffer, fs->fs_hwsectorsize);
+  victim->cs_sector    = fs->fs_currentsector;
+  victim->cs_dirty     = fs->fs_dirty;
+  victim->cs_age       = ++fs->fs_cacheage;
+
+  fs->fs_currentsector = -1;
+  fs->fs_dirty         = false;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_fscacheswap
+ *
+ * Description:
+ *   Exchange the current sector in fs_buffer with the sector held in
+ *   'slot'.  The data is copied so that fs_buffer itself never moves:
+ *   callers keep pointers into fs_buffer.
+ *
+ ****************************************************************************/
+
+static void fat_fscacheswap(FAR struct fat_mountpt_s *fs,
+                            FAR struct fat_cacheslot_s *slot)
+{
+  FAR uint32_t *src = (FAR uint32_t *)slot->cs_buffer;
+  FAR uint32_t *dest = (FAR uint32_t *)fs->fs_buffer;
+  off_t sector = slot->cs_sector;
+  bool dirty = slot->cs_dirty;
+  int i;
+
+  for (i = 0; i < fs->fs_hwsectorsize / sizeof(uint32_t); i++)
+    {
+      uint32_t tmp = dest[i];
+      dest[i]      = src[i];
+      src[i]       = tmp;
+    }
+
+  slot->cs_sector      = fs->fs_currentsector;
+  slot->cs_dirty       = fs->fs_dirty;
+  slot->cs_age         = ++fs->fs_cacheage;
+
+  fs->fs_currentsector = sector;
+  fs->fs_dirty         = dirty;
+}
+#endif
+
+#ifdef CONFIG_FAT_FREEMAP
+/****************************************************************************
+ * Name: fat_freemapbuild
+ *
+ * Description:
+ *   Build the free cluster bitmap with one pass over the FAT, if this has
+ *   not already been done.
+ *
+ * Returned Value:
+ *   OK if fs_freemap is available; a negated errno value otherwise.
+ *
+ ****************************************************************************/
+
+static int fat_freemapbuild(FAR struct fat_mountpt_s *fs)
+{
+  FAR uint32_t *freemap;
+  uint32_t nwords;
+  uint32_t nfree;
+  uint32_t cluster;
+  off_t next;
+
+  if (fs->fs_freemap != NULL)
+    {
+      return OK;
+    }
+
+  nwords  = (fs->fs_nclusters + 31) >> 5;
+  freemap = (FAR uint32_t *)kmm_zalloc(nwords * sizeof(uint32_t));
+  if (freemap == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* Clusters 0 and 1 and the bits beyond the last cluster never hold a
+   * free cluster.
+   */
+
+  freemap[0] = 3;
+  for (cluster = fs->fs_nclusters; cluster < (nwords << 5); cluster++)
+    {
+      freemap[cluster >> 5] |= 1u << (cluster & 31);
+    }
+
+  nfree = 0;
+  for (cluster = 2; cluster < fs->fs_nclusters; cluster++)
+    {
+      next = fat_getcluster(fs, cluster);
+      if (next < 0)
+        {
+          kmm_free(freemap);
+          return next;
+        }
+      else if (next == 0)
+        {
+          nfree++;
+        }
+      else
+        {
+          freemap[cluster >> 5] |= 1u << (cluster & 31);
+        }
+    }
+
+  fs->fs_freemap  = freemap;
+  fs->fs_nfreemap = nfree;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_freemapupdate
+ *
+ * Description:
+ *   Record that 'cluster' has been allocated or freed in the FAT.
+ *
+ ****************************************************************************/
+
+static void fat_freemapupdate(FAR struct fat_mountpt_s *fs,
+                              uint32_t cluster, bool inuse)
+{
+  FAR uint32_t *word;
+  uint32_t bit;
+
+  if (fs->fs_freemap == NULL || cluster < 2 || cluster >= fs->fs_nclusters)
+    {
+      return;
+    }
+
+  word = &fs->fs_freemap[cluster >> 5];
+  bit  = 1u << (cluster & 31);
+
+  if (inuse && (*word & bit) == 0)
+    {
+      *word |= bit;
+      fs->fs_nfreemap--;
+    }
+  else if (!inuse && (*word & bit) != 0)
+    {
+      *word &= ~bit;
+      fs->fs_nfreemap++;
+    }
+}
+
+/****************************************************************************
+ * Name: fat_freemapsearch
+ *
+ * Description:
+ *   Find a free cluster in the free cluster bitmap, starting the search
+ *   near 'cluster' and wrapping around at the end of the volume.
+ *
+ * Returned Value:
+ *   The free cluster number or zero if there is no free cluster.
+ *
+ ****************************************************************************/
+
+static uint32_t fat_freemapsearch(FAR struct fat_mountpt_s *fs,
+                                  uint32_t cluster)
+{
+  uint32_t nwords = (fs->fs_nclusters + 31) >> 5;
+  uint32_t ndx;
+  uint32_t i;
+
+  if (fs->fs_nfreemap == 0)
+    {
+      return 0;
+    }
+
+  ndx = cluster < fs->fs_nclusters ? cluster >> 5 : 0;
+  for (i = 0; i <= nwords; i++, ndx++)
+    {
+      uint32_t word;
+
+      if (ndx >= nwords)
+        {
+          ndx = 0;
+        }
+
+      word = fs->fs_freemap[ndx];
+      if (word != 0xffffffff)
+        {
+          return (ndx << 5) + ffs(~word) - 1;
+        }
+    }
+
+  return 0;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -516,12 +862,11 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
   fs->fs_hwsectorsize = geo.geo_sectorsize;
   fs->fs_hwnsectors   = geo.geo_nsectors;
 
-  /* Allocate a buffer to hold one hardware sector */
+  /* Allocate the buffers of the sector cache */
 
-  fs->fs_buffer = (FAR uint8_t *)fat_io_alloc(fs->fs_hwsectorsize);
-  if (!fs->fs_buffer)
+  ret = fat_fscachealloc(fs);
+  if (ret < 0)
     {
-      ret = -ENOMEM;
       goto errout;
     }
 
@@ -653,8 +998,7 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
   return OK;
 
 errout_with_buffer:
-  fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
-  fs->fs_buffer = 0;
+  fat_fscachefree(fs);
 
 errout:
   fs->fs_mounted = false;
@@ -756,7 +1100,10 @@ int fat_hwwrite(struct fat_mountpt_s *fs, uint8_t *buffer, off_t sector,
       struct inode *inode = fs->fs_blkdriver;
       if (inode && inode->u.i_bops && inode->u.i_bops->write)
         {
-          ssize_t nsectorswritten =
+          ssize_t nsectorswritten;
+
+          fat_fscacheinval(fs, buffer, sector, nsectors);
+          nsectorswritten =
               inode->u.i_bops->write(inode, buffer, sector, nsectors);
 
           if (nsectorswritten == nsectors)
@@ -1094,6 +1441,9 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
       /* Mark the modified sector as "dirty" and return success */
 
       fs->fs_dirty = true;
+#ifdef CONFIG_FAT_FREEMAP
+      fat_freemapupdate(fs, clusterno, nextcluster != 0);
+#endif
       return OK;
     }
 
@@ -1217,6 +1567,23 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
       startcluster = cluster;
     }
 
+#ifdef CONFIG_FAT_FREEMAP
+  /* If the free cluster bitmap is available, there is no need to search
+   * the FAT for the next free cluster.
+   */
+
+  if (fat_freemapbuild(fs) == OK)
+    {
+      newcluster = fat_freemapsearch(fs, startcluster);
+      if (newcluster == 0)
+        {
+          return 0;
+        }
+
+      goto found;
+    }
+#endif
+
   /* Loop until (1) we discover that there are not free clusters
    * (return 0), an errors occurs (return -errno), or (3) we find
    * the next cluster (return the new cluster number).
@@ -1279,6 +1646,9 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
    * number in 'newcluster'  Now mark that cluster as in-use.
    */
 
+#ifdef CONFIG_FAT_FREEMAP
+found:
+#endif
   ret = fat_putcluster(fs, newcluster, 0x0fffffff);
   if (ret < 0)
     {
@@ -1749,17 +2119,96 @@ int fat_dirextend(FAR struct fat_mountpt_s *fs, FAR struct fat_file_s *ff,
   return OK;
 }
 
+/****************************************************************************
+ * Name: fat_fscachealloc
+ *
+ * Description:
+ *   Allocate the buffers of the mountpoint sector cache.  fs_hwsectorsize
+ *   must be valid.
+ *
+ ****************************************************************************/
+
+int fat_fscachealloc(struct fat_mountpt_s *fs)
+{
+#ifdef FAT_NCACHESLOTS
+  FAR uint8_t *buffer;
+  int i;
+#endif
+
+  /* Allocate a buffer to hold one hardware sector */
+
+  fs->fs_buffer = (FAR uint8_t *)fat_io_alloc(fs->fs_hwsectorsize);
+  if (!fs->fs_buffer)
+    {
+      return -ENOMEM;
+    }
+
+  fs->fs_currentsector = -1;
+  fs->fs_dirty         = false;
+
+#ifdef FAT_NCACHESLOTS
+  /* And one more buffer for each of the other cached sectors */
+
+  buffer = (FAR uint8_t *)
+    fat_io_alloc(FAT_NCACHESLOTS * fs->fs_hwsectorsize);
+  if (!buffer)
+    {
+      fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
+      fs->fs_buffer = NULL;
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < FAT_NCACHESLOTS; i++)
+    {
+      fs->fs_cache[i].cs_sector = -1;
+      fs->fs_cache[i].cs_age    = 0;
+      fs->fs_cache[i].cs_dirty  = false;
+      fs->fs_cache[i].cs_buffer = buffer;
+      buffer                   += fs->fs_hwsectorsize;
+    }
+#endif
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_fscachefree
+ *
+ * Description:
+ *   Free the buffers of the mountpoint sector cache.  Dirty sectors are
+ *   discarded.
+ *
+ ****************************************************************************/
+
+void fat_fscachefree(struct fat_mountpt_s *fs)
+{
+  if (fs->fs_buffer)
+    {
+      fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
+      fs->fs_buffer = NULL;
+
+#ifdef FAT_NCACHESLOTS
+      fat_io_free(fs->fs_cache[0].cs_buffer,
+                  FAT_NCACHESLOTS * fs->fs_hwsectorsize);
+      fs->fs_cache[0].cs_buffer = NULL;
+#endif
+    }
+}
+
 /****************************************************************************
  * Name: fat_fscacheflush
  *
  * Description:
- *   Flush any dirty sector if fs_buffer as necessary
+ *   Flush all dirty sectors of the mountpoint cache as necessary
  *
  ****************************************************************************/
 
 int fat_fscacheflush(struct fat_mountpt_s *fs)
 {
   int ret;
+#ifdef FAT_NCACHESLOTS
+  int i;
+#endif
 
   /* Check if the fs_buffer is dirty.  In this case, we will write back the
    * contents of fs_buffer.
@@ -1767,38 +2216,36 @@ int fat_fscacheflush(struct fat_mountpt_s *fs)
 
   if (fs->fs_dirty)
     {
-      /* Write the dirty sector */
-
-      ret = fat_hwwrite(fs, fs->fs_buffer, fs->fs_currentsector, 1);
+      ret = fat_fscachewrite(fs, fs->fs_buffer, fs->fs_currentsector);
       if (ret < 0)
         {
           return ret;
         }
 
-      /* Does the sector lie in the FAT region? */
+      /* No longer dirty */
 
-      if (fs->fs_currentsector >= fs->fs_fatbase &&
-          fs->fs_currentsector < fs->fs_fatbase + fs->fs_nfatsects)
-        {
-          int i;
+      fs->fs_dirty = false;
+    }
 
-          /* Yes, then make the change in the FAT copy as well */
+#ifdef FAT_NCACHESLOTS
+  /* Then do the same for the other cached sectors */
 
-          for (i = fs->fs_fatnumfats; i >= 2; i--)
+  for (i = 0; i < FAT_NCACHESLOTS; i++)
+    {
+      FAR struct fat_cacheslot_s *slot = &fs->fs_cache[i];
+
+      if (slot->cs_dirty)
+        {
+          ret = fat_fscachewrite(fs, slot->cs_buffer, slot->cs_sector);
+          if (ret < 0)
             {
-              fs->fs_currentsector += fs->fs_nfatsects;
-              ret = fat_hwwrite(fs, fs->fs_buffer, fs->fs_currentsector, 1);
-              if (ret < 0)
-                {
-                  return ret;
-                }
+              return ret;
             }
-        }
-
-      /* No longer dirty */
 
-      fs->fs_dirty = false;
+          slot->cs_dirty = false;
+        }
     }
+#endif
 
   return OK;
 }
@@ -1807,13 +2254,17 @@ int fat_fscacheflush(struct fat_mountpt_s *fs)
  * Name: fat_fscacheread
  *
  * Description:
- *   Read the specified sector into the sector cache, flushing any existing
- *   dirty sectors as necessary.
+ *   Make the specified sector the current sector in fs_buffer, reading it
+ *   from the media if it is not already cached and writing back dirty
+ *   sectors as necessary.
  *
  ****************************************************************************/
 
 int fat_fscacheread(struct fat_mountpt_s *fs, off_t sector)
 {
+#ifdef FAT_NCACHESLOTS
+  FAR struct fat_cacheslot_s *slot;
+#endif
   int ret;
 
   /* fs->fs_currentsector holds the current sector that is buffered in
@@ -1823,11 +2274,30 @@ int fat_fscacheread(struct fat_mountpt_s *fs, off_t sector)
 
   if (fs->fs_currentsector != sector)
     {
+#ifdef FAT_NCACHESLOTS
+      /* Is the sector held in one of the other cache slots? */
+
+      slot = fat_fscachefind(fs, sector);
+      if (slot != NULL)
+        {
+          /* Yes.. just exchange it with the current sector */
+
+          fat_fscacheswap(fs, slot);
+          return OK;
+        }
+
+      /* No.. we will need to read the new sector.  First, move the current
+       * sector out of the way.
+       */
+
+      ret = fat_fscachesave(fs);
+#else
       /* We will need to read the new sector.  First, flush the cached
        * sector if it is dirty.
        */
 
       ret = fat_fscacheflush(fs);
+#endif
       if (ret < 0)
         {
           return ret;
@@ -1838,6 +2308,7 @@ int fat_fscacheread(struct fat_mountpt_s *fs, off_t sector)
       ret = fat_hwread(fs, fs->fs_buffer, sector, 1);
       if (ret < 0)
         {
+          fs->fs_currentsector = -1;
           return ret;
         }
 
@@ -1849,6 +2320,58 @@ int fat_fscacheread(struct fat_mountpt_s *fs, off_t sector)
   return OK;
 }
 
+/****************************************************************************
+ * Name: fat_fscacheclear
+ *
+ * Description:
+ *   Make the specified sector the current sector in fs_buffer without
+ *   reading it from the media.  fs_buffer is filled with zeroes and is not
+ *   dirty.  This is used when the caller is about to overwrite the whole
+ *   sector.
+ *
+ ****************************************************************************/
+
+int fat_fscacheclear(struct fat_mountpt_s *fs, off_t sector)
+{
+#ifdef FAT_NCACHESLOTS
+  FAR struct fat_cacheslot_s *slot;
+#endif
+  int ret;
+
+  if (fs->fs_currentsector != sector)
+    {
+#ifdef FAT_NCACHESLOTS
+      /* Move the current sector out of the way and discard any other copy
+       * of the new sector.
+       */
+
+      ret = fat_fscachesave(fs);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      slot = fat_fscachefind(fs, sector);
+      if (slot != NULL)
+        {
+          slot->cs_sector = -1;
+          slot->cs_dirty  = false;
+        }
+#else
+      ret = fat_fscacheflush(fs);
+      if (ret < 0)
+        {
+          return ret;
+        }
+#endif
+    }
+
+  memset(fs->fs_buffer, 0, fs->fs_hwsectorsize);
+  fs->fs_currentsector = sector;
+  fs->fs_dirty         = false;
+  return OK;
+}
+
 /****************************************************************************
  * Name: fat_ffcacheflush
  *
@@ -1994,7 +2517,12 @@ int fat_updatefsinfo(struct fat_mountpt_s *fs)
         {
           /* Create an image of the FSINFO sector in the fs_buffer */
 
-          memset(fs->fs_buffer, 0, fs->fs_hwsectorsize);
+          ret = fat_fscacheclear(fs, fs->fs_fsinfo);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
           FSI_PUTLEADSIG(fs->fs_buffer, 0x41615252);
           FSI_PUTSTRUCTSIG(fs->fs_buffer, 0x61417272);
           FSI_PUTFREECOUNT(fs->fs_buffer, fs->fs_fsifreecount);
@@ -2003,9 +2531,8 @@ int fat_updatefsinfo(struct fat_mountpt_s *fs)
 
           /* Then flush this to disk */
 
-          fs->fs_currentsector = fs->fs_fsinfo;
-          fs->fs_dirty         = true;
-          ret                  = fat_fscacheflush(fs);
+          fs->fs_dirty = true;
+          ret          = fat_fscacheflush(fs);
 
           /* No longer dirty */
 
@@ -2028,6 +2555,29 @@ int fat_nfreeclusters(struct fat_mountpt_s *fs, off_t *pfreeclusters)
 {
   uint32_t nfreeclusters;
 
+#ifdef CONFIG_FAT_FREEMAP
+  /* The free cluster bitmap holds the exact count.  Don't build it just
+   * for this if the FSINFO sector already provides the count.
+   */
+
+  if ((fs->fs_freemap != NULL ||
+       fs->fs_fsifreecount > fs->fs_nclusters - 2) &&
+      fat_freemapbuild(fs) == OK)
+    {
+      if (fs->fs_fsifreecount != fs->fs_nfreemap)
+        {
+          fs->fs_fsifreecount = fs->fs_nfreemap;
+          if (fs->fs_type == FSTYPE_FAT32)
+            {
+              fs->fs_fsidirty = true;
+            }
+        }
+
+      *pfreeclusters = fs->fs_nfreemap;
+      return OK;
+    }
+#endif
+
   /* If number of the first free cluster is valid, then just return that
    * value.
    */
@@ -2079,7 +2629,7 @@ int fat_nfreeclusters(struct fat_mountpt_s *fs, off_t *pfreeclusters)
 
           if (offset >= fs->fs_hwsectorsize)
             {
-              ret = fat_fscacheread(fs, fatsector++);
+              ret = fat_fscacheread(fs, fatsector);
               if (ret < 0)
                 {
                   return ret;
@@ -76,6 +76,10 @@ static int _files_close(FAR struct file *filep)
 
   if (inode)
     {
+      /* Remove the file from any epoll instance that watches it */
+
+      epoll_remove(filep);
+
       /* Close the file, driver, or mountpoint. */
 
       if (inode->u.i_ops && inode->u.i_ops->close)
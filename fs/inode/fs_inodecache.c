@@ -0,0 +1,469 @@
+/****************************************************************************
+ * fs/inode/fs_inodecache.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "inode/inode.h"
+
+#ifdef HAVE_INODE_CACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define INODE_CACHE_MASK  (CONFIG_PSEUDOFS_LOOKUP_CACHE - 1)
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_INODECACHE)
+#  define HAVE_INODECACHE_PROCFS 1
+#endif
+
+/* Size of the buffer that holds the text of fs/inodecache */
+
+#define INODECACHE_LINELEN 128
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One entry of the direct-mapped lookup cache.  The key is the pair
+ * (parent, name of node).  An entry with node == NULL is empty.
+ */
+
+struct inode_cacheentry_s
+{
+  FAR struct inode *parent;    /* Inode "above" node (NULL at the root) */
+  FAR struct inode *node;      /* The cached inode */
+  FAR struct inode *peer;      /* Inode to the "left" of node */
+};
+
+/* Lookup cache statistics */
+
+struct inode_cachestats_s
+{
+  unsigned long hits;          /* Segments found in the cache */
+  unsigned long misses;        /* Segments that required a list search */
+  unsigned long flushes;       /* Number of times the cache was flushed */
+};
+
+#ifdef HAVE_INODECACHE_PROCFS
+/* This structure describes one open "file" */
+
+struct inodecache_file_s
+{
+  struct procfs_file_s base;      /* Base open file structure */
+  unsigned int linesize;          /* Number of valid characters in line[] */
+  char line[INODECACHE_LINELEN];  /* Buffer for the formatted text */
+};
+#endif
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static unsigned int inode_cachehash(FAR struct inode *parent,
+                                    FAR const char *name);
+static bool inode_cachematch(FAR const char *name,
+                             FAR struct inode *node);
+
+#ifdef HAVE_INODECACHE_PROCFS
+/* File system methods */
+
+static int     inodecache_open(FAR struct file *filep,
+                 FAR const char *relpath, int oflags, mode_t mode);
+static int     inodecache_close(FAR struct file *filep);
+static ssize_t inodecache_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+
+static int     inodecache_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+
+static int     inodecache_stat(FAR const char *relpath,
+                 FAR struct stat *buf);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct inode_cacheentry_s g_inode_cache[CONFIG_PSEUDOFS_LOOKUP_CACHE];
+static struct inode_cachestats_s g_inode_cachestats;
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef HAVE_INODECACHE_PROCFS
+/* See fs_procfs.c -- this structure is explicitly externed there. */
+
+const struct procfs_operations inodecache_operations =
+{
+  inodecache_open,       /* open */
+  inodecache_close,      /* close */
+  inodecache_read,       /* read */
+  NULL,                  /* write */
+
+  inodecache_dup,        /* dup */
+
+  NULL,                  /* opendir */
+  NULL,                  /* closedir */
+  NULL,                  /* readdir */
+  NULL,                  /* rewinddir */
+
+  inodecache_stat        /* stat */
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_cachehash
+ *
+ * Description:
+ *   Hash the parent inode address and the first path segment of 'name'
+ *   into an index of g_inode_cache[].
+ *
+ ****************************************************************************/
+
+static unsigned int inode_cachehash(FAR struct inode *parent,
+                                    FAR const char *name)
+{
+  uint32_t hash = 2166136261u ^ (uint32_t)((uintptr_t)parent >> 2);
+
+  for (; *name != '\0' && *name != '/'; name++)
+    {
+      hash = (hash ^ (uint8_t)*name) * 16777619u;
+    }
+
+  return (unsigned int)(hash ^ (hash >> 16)) & INODE_CACHE_MASK;
+}
+
+/****************************************************************************
+ * Name: inode_cachematch
+ *
+ * Description:
+ *   Return true if the first path segment of 'name' is the name of 'node'.
+ *
+ ****************************************************************************/
+
+static bool inode_cachematch(FAR const char *name, FAR struct inode *node)
+{
+  FAR const char *nname = node->i_name;
+
+  while (*nname != '\0' && *nname == *name)
+    {
+      nname++;
+      name++;
+    }
+
+  return *nname == '\0' && (*name == '\0' || *name == '/');
+}
+
+#ifdef HAVE_INODECACHE_PROCFS
+/****************************************************************************
+ * Name: inodecache_open
+ ****************************************************************************/
+
+static int inodecache_open(FAR struct file *filep, FAR const char *relpath,
+                           int oflags, mode_t mode)
+{
+  FAR struct inodecache_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* "fs/inodecache" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "fs/inodecache") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = (FAR struct inodecache_file_s *)
+    kmm_zalloc(sizeof(struct inodecache_file_s));
+
+  if (attr == NULL)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: inodecache_close
+ ****************************************************************************/
+
+static int inodecache_close(FAR struct file *filep)
+{
+  FAR struct inodecache_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct inodecache_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  kmm_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: inodecache_read
+ ****************************************************************************/
+
+static ssize_t inodecache_read(FAR struct file *filep, FAR char *buffer,
+                               size_t buflen)
+{
+  FAR struct inodecache_file_s *attr;
+  struct inode_cachestats_s stats;
+  off_t offset;
+  ssize_t ret;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct inodecache_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  if (filep->f_pos == 0)
+    {
+      /* Take a consistent snapshot of the statistics */
+
+      ret = inode_semtake();
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      stats = g_inode_cachestats;
+      inode_semgive();
+
+      attr->linesize =
+        snprintf(attr->line, INODECACHE_LINELEN,
+                 "Entries: %d\nHits:    %lu\nMisses:  %lu\nFlushes: %lu\n",
+                 CONFIG_PSEUDOFS_LOOKUP_CACHE, stats.hits, stats.misses,
+                 stats.flushes);
+    }
+
+  offset = filep->f_pos;
+  ret = procfs_memcpy(attr->line, attr->linesize, buffer, buflen, &offset);
+
+  /* Update the file offset */
+
+  if (ret > 0)
+    {
+      filep->f_pos += ret;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: inodecache_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int inodecache_dup(FAR const struct file *oldp,
+                          FAR struct file *newp)
+{
+  FAR struct inodecache_file_s *oldattr;
+  FAR struct inodecache_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct inodecache_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the file attributes */
+
+  newattr = (FAR struct inodecache_file_s *)
+    kmm_malloc(sizeof(struct inodecache_file_s));
+
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct inodecache_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: inodecache_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int inodecache_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "fs/inodecache" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "fs/inodecache") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "fs/inodecache" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+#endif /* HAVE_INODECACHE_PROCFS */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_cachefind
+ *
+ * Description:
+ *   Look up the child of 'parent' whose name is the first path segment of
+ *   'name' in the lookup cache.  On a hit, the inode to the "left" of the
+ *   child is returned in 'peer'.
+ *
+ * Returned Value:
+ *   The cached inode or NULL if the segment is not in the cache.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+FAR struct inode *inode_cachefind(FAR struct inode *parent,
+                                  FAR const char *name,
+                                  FAR struct inode **peer)
+{
+  FAR struct inode_cacheentry_s *entry;
+
+  entry = &g_inode_cache[inode_cachehash(parent, name)];
+  if (entry->node != NULL && entry->parent == parent &&
+      inode_cachematch(name, entry->node))
+    {
+      g_inode_cachestats.hits++;
+      *peer = entry->peer;
+      return entry->node;
+    }
+
+  g_inode_cachestats.misses++;
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: inode_cacheadd
+ *
+ * Description:
+ *   Remember that 'node', with 'peer' to its "left", is the child of
+ *   'parent' named by the first path segment of 'name'.  Any entry that
+ *   hashes to the same slot is replaced.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+void inode_cacheadd(FAR struct inode *parent, FAR const char *name,
+                    FAR struct inode *node, FAR struct inode *peer)
+{
+  FAR struct inode_cacheentry_s *entry;
+
+  entry         = &g_inode_cache[inode_cachehash(parent, name)];
+  entry->parent = parent;
+  entry->node   = node;
+  entry->peer   = peer;
+}
+
+/****************************************************************************
+ * Name: inode_cacheflush
+ *
+ * Description:
+ *   Discard all lookup cache entries.  This must be called whenever an
+ *   inode is linked into or unlinked from the inode tree:  Both change the
+ *   "left" peer of a neighbouring inode and an unlinked inode may be freed.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+void inode_cacheflush(void)
+{
+  memset(g_inode_cache, 0, sizeof(g_inode_cache));
+  g_inode_cachestats.flushes++;
+}
+
+#endif /* HAVE_INODE_CACHE */
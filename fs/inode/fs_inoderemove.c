@@ -109,6 +109,10 @@ FAR struct inode *inode_unlink(FAR const char *path)
         }
 
       node->i_peer = NULL;
+
+      /* The node may be freed as soon as the caller releases it */
+
+      inode_cacheflush();
     }
 
   RELEASE_SEARCH(&desc);
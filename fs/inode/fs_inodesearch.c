@@ -260,7 +260,27 @@ static int _inode_search(FAR struct inode_search_s *desc)
 
   while (node != NULL)
     {
-      int result = _inode_compare(name, node);
+      int result;
+
+#ifdef HAVE_INODE_CACHE
+      /* At the head of a list of peers, try the lookup cache before
+       * searching the list.
+       */
+
+      if (left == NULL)
+        {
+          FAR struct inode *peer;
+          FAR struct inode *cached = inode_cachefind(above, name, &peer);
+
+          if (cached != NULL)
+            {
+              node = cached;
+              left = peer;
+            }
+        }
+#endif
+
+      result = _inode_compare(name, node);
 
       /* Case 1:  The name is less than the name of the node.
        * Since the names are ordered, these means that there
@@ -298,6 +318,10 @@ static int _inode_search(FAR struct inode_search_s *desc)
            *       below this one
            */
 
+#ifdef HAVE_INODE_CACHE
+          inode_cacheadd(above, name, node, left);
+#endif
+
           name = inode_nextname(name);
           if (*name == '\0' || INODE_IS_MOUNTPT(node))
             {
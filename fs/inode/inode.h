@@ -40,6 +40,19 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Size of the pseudo-file system lookup cache.  Zero disables the cache. */
+
+#ifndef CONFIG_PSEUDOFS_LOOKUP_CACHE
+#  define CONFIG_PSEUDOFS_LOOKUP_CACHE 0
+#endif
+
+#if CONFIG_PSEUDOFS_LOOKUP_CACHE > 0
+#  if (CONFIG_PSEUDOFS_LOOKUP_CACHE & (CONFIG_PSEUDOFS_LOOKUP_CACHE - 1)) != 0
+#    error CONFIG_PSEUDOFS_LOOKUP_CACHE must be a power of two
+#  endif
+#  define HAVE_INODE_CACHE 1
+#endif
+
 #define SETUP_SEARCH(d,p,n) \
   do \
     { \
@@ -414,6 +427,63 @@ int files_close(int fd);
 
 void files_release(int fd);
 
+/****************************************************************************
+ * Name: inode_cachefind
+ *
+ * Description:
+ *   Look up the child of 'parent' whose name is the first path segment of
+ *   'name' in the lookup cache.  On a hit, the inode to the "left" of the
+ *   child is returned in 'peer'.
+ *
+ * Returned Value:
+ *   The cached inode or NULL if the segment is not in the cache.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_INODE_CACHE
+FAR struct inode *inode_cachefind(FAR struct inode *parent,
+                                  FAR const char *name,
+                                  FAR struct inode **peer);
+#endif
+
+/****************************************************************************
+ * Name: inode_cacheadd
+ *
+ * Description:
+ *   Remember that 'node', with 'peer' to its "left", is the child of
+ *   'parent' named by the first path segment of 'name'.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_INODE_CACHE
+void inode_cacheadd(FAR struct inode *parent, FAR const char *name,
+                    FAR struct inode *node, FAR struct inode *peer);
+#endif
+
+/****************************************************************************
+ * Name: inode_cacheflush
+ *
+ * Description:
+ *   Discard all lookup cache entries.  This must be called whenever an
+ *   inode is linked into or unlinked from the inode tree.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_INODE_CACHE
+void inode_cacheflush(void);
+#else
+#  define inode_cacheflush()
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
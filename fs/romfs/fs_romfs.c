@@ -1151,6 +1151,10 @@ static int romfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
 
       /* Release the mountpoint private data */
 
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+      romfs_freedirindex(rm);
+#endif
+
       if (!rm->rm_xipbase && rm->rm_buffer)
         {
           kmm_free(rm->rm_buffer);
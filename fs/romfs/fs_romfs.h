@@ -131,6 +131,15 @@
 
 #define ROMF_MAX_LINKS 64
 
+/* Directory index */
+
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+#  ifndef CONFIG_FS_ROMFS_DIRINDEX_NBUCKETS
+#    define CONFIG_FS_ROMFS_DIRINDEX_NBUCKETS 256
+#  endif
+#  define ROMFS_DIRINDEX_MASK (CONFIG_FS_ROMFS_DIRINDEX_NBUCKETS - 1)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -141,6 +150,7 @@
  */
 
 struct romfs_file_s;
+struct romfs_dirent_s;
 struct romfs_mountpt_s
 {
   struct inode        *rm_blkdriver; /* The block driver inode that hosts the FAT32 fs */
@@ -155,8 +165,28 @@ struct romfs_mountpt_s
   uint32_t rm_cachesector;          /* Current sector in the rm_buffer */
   uint8_t *rm_xipbase;              /* Base address of directly accessible media */
   uint8_t *rm_buffer;               /* Device sector buffer, allocated if rm_xipbase==0 */
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+  FAR struct romfs_dirent_s **rm_dirindex; /* Hash table of directory entries */
+#endif
 };
 
+/* This structure describes one entry in the directory index.  An entry with
+ * an empty name marks a directory whose entries have all been indexed.
+ */
+
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+struct romfs_dirent_s
+{
+  FAR struct romfs_dirent_s *de_flink;  /* Next entry in the hash bucket */
+  uint32_t de_dir;                      /* Offset of the first directory entry */
+  uint32_t de_offset;                   /* Offset of the file header */
+  uint32_t de_next;                     /* Offset of the next header+flags */
+  uint32_t de_info;                     /* Info (first entry if a directory) */
+  uint32_t de_size;                     /* Size (if file) */
+  char     de_name[1];                  /* Name, NUL terminated */
+};
+#endif
+
 /* This structure represents on open file under the mountpoint.  An instance
  * of this structure is retained as struct file specific information on each
  * opened file.
@@ -229,6 +259,9 @@ int  romfs_parsefilename(FAR struct romfs_mountpt_s *rm, uint32_t offset,
        FAR char *pname);
 int  romfs_datastart(FAR struct romfs_mountpt_s *rm, uint32_t offset,
        FAR uint32_t *start);
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+void romfs_freedirindex(FAR struct romfs_mountpt_s *rm);
+#endif
 
 #undef EXTERN
 #if defined(__cplusplus)
@@ -261,6 +261,257 @@ static int romfs_followhardlinks(struct romfs_mountpt_s *rm, uint32_t offset,
   return -ELOOP;
 }
 
+/****************************************************************************
+ * Name: romfs_dirhash
+ *
+ * Description:
+ *   Return the directory index hash bucket for a name in a directory
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+static unsigned int romfs_dirhash(uint32_t dir, const char *name, int len)
+{
+  uint32_t hash = 2166136261u ^ dir;
+  int i;
+
+  for (i = 0; i < len; i++)
+    {
+      hash = (hash ^ (uint8_t)name[i]) * 16777619u;
+    }
+
+  return (unsigned int)(hash ^ (hash >> 16)) & ROMFS_DIRINDEX_MASK;
+}
+
+/****************************************************************************
+ * Name: romfs_indexfind
+ *
+ * Description:
+ *   Find the directory index entry for a name in a directory.  A zero
+ *   length name finds the marker of an indexed directory.
+ *
+ ****************************************************************************/
+
+static FAR struct romfs_dirent_s *
+romfs_indexfind(struct romfs_mountpt_s *rm, uint32_t dir,
+                const char *name, int len)
+{
+  FAR struct romfs_dirent_s *de;
+
+  for (de = rm->rm_dirindex[romfs_dirhash(dir, name, len)];
+       de != NULL;
+       de = de->de_flink)
+    {
+      if (de->de_dir == dir && memcmp(de->de_name, name, len) == 0 &&
+          de->de_name[len] == '\0')
+        {
+          return de;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: romfs_indexadd
+ *
+ * Description:
+ *   Add an entry to the directory index
+ *
+ ****************************************************************************/
+
+static int romfs_indexadd(struct romfs_mountpt_s *rm, uint32_t dir,
+                          uint32_t offset, uint32_t next, uint32_t info,
+                          uint32_t size, const char *name)
+{
+  FAR struct romfs_dirent_s *de;
+  unsigned int ndx;
+  int len = strlen(name);
+
+  de = (FAR struct romfs_dirent_s *)
+    kmm_malloc(sizeof(struct romfs_dirent_s) + len);
+  if (!de)
+    {
+      return -ENOMEM;
+    }
+
+  de->de_dir    = dir;
+  de->de_offset = offset;
+  de->de_next   = next;
+  de->de_info   = info;
+  de->de_size   = size;
+  memcpy(de->de_name, name, len + 1);
+
+  ndx                  = romfs_dirhash(dir, name, len);
+  de->de_flink         = rm->rm_dirindex[ndx];
+  rm->rm_dirindex[ndx] = de;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: romfs_indexremove
+ *
+ * Description:
+ *   Remove all of the entries of a directory from the directory index
+ *
+ ****************************************************************************/
+
+static void romfs_indexremove(struct romfs_mountpt_s *rm, uint32_t dir)
+{
+  FAR struct romfs_dirent_s **pde;
+  FAR struct romfs_dirent_s *de;
+  int i;
+
+  for (i = 0; i < CONFIG_FS_ROMFS_DIRINDEX_NBUCKETS; i++)
+    {
+      for (pde = &rm->rm_dirindex[i]; (de = *pde) != NULL; )
+        {
+          if (de->de_dir == dir)
+            {
+              *pde = de->de_flink;
+              kmm_free(de);
+            }
+          else
+            {
+              pde = &de->de_flink;
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: romfs_indexdir
+ *
+ * Description:
+ *   Read all of the directory and file entries of the directory beginning
+ *   at 'dir' into the directory index, followed by the marker that shows
+ *   that the directory is indexed.
+ *
+ ****************************************************************************/
+
+static int romfs_indexdir(struct romfs_mountpt_s *rm, uint32_t dir)
+{
+  char name[NAME_MAX + 1];
+  uint32_t offset;
+  uint32_t linkoffset;
+  uint32_t next;
+  uint32_t info;
+  uint32_t size;
+  int ret;
+
+  offset = dir;
+  do
+    {
+      /* Parse the entry, following hard links to the real file header */
+
+      ret = romfs_parsedirentry(rm, offset, &linkoffset, &next, &info,
+                                &size);
+      if (ret < 0)
+        {
+          goto errout;
+        }
+
+      /* Only directories and files can be found by romfs_checkentry() */
+
+      if (IS_DIRECTORY(next) || IS_FILE(next))
+        {
+          ret = romfs_parsefilename(rm, offset, name);
+          if (ret >= 0 && name[0] != '\0')
+            {
+              ret = romfs_indexadd(rm, dir, offset, next, info, size, name);
+            }
+
+          if (ret < 0)
+            {
+              goto errout;
+            }
+        }
+
+      /* Select the offset to the next entry */
+
+      offset = next & RFNEXT_OFFSETMASK;
+    }
+  while (offset != 0);
+
+  ret = romfs_indexadd(rm, dir, dir, 0, 0, 0, "");
+  if (ret >= 0)
+    {
+      return OK;
+    }
+
+errout:
+  romfs_indexremove(rm, dir);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: romfs_searchindex
+ *
+ * Description:
+ *   Search the directory index for entryname, indexing the directory
+ *   beginning at dirinfo->fr_firstoffset first if necessary.  Returns
+ *   -ENOENT if the directory is indexed and has no such entry.  Other
+ *   errors mean that the directory must be searched on the media.
+ *
+ ****************************************************************************/
+
+static int romfs_searchindex(struct romfs_mountpt_s *rm,
+                             const char *entryname, int entrylen,
+                             struct romfs_dirinfo_s *dirinfo)
+{
+  FAR struct romfs_dirent_s *de;
+  uint32_t dir = dirinfo->rd_dir.fr_firstoffset;
+  int ret;
+
+  /* Allocate the hash table on first use */
+
+  if (!rm->rm_dirindex)
+    {
+      rm->rm_dirindex = (FAR struct romfs_dirent_s **)
+        kmm_zalloc(CONFIG_FS_ROMFS_DIRINDEX_NBUCKETS *
+                   sizeof(FAR struct romfs_dirent_s *));
+      if (!rm->rm_dirindex)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  /* Index the directory if this is the first search in it */
+
+  if (!romfs_indexfind(rm, dir, "", 0))
+    {
+      ret = romfs_indexdir(rm, dir);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  de = romfs_indexfind(rm, dir, entryname, entrylen);
+  if (!de || entrylen == 0)
+    {
+      return -ENOENT;
+    }
+
+  /* Found it -- save the component info as romfs_checkentry() would */
+
+  if (IS_DIRECTORY(de->de_next))
+    {
+      dirinfo->rd_dir.fr_firstoffset = de->de_info;
+      dirinfo->rd_dir.fr_curroffset  = de->de_info;
+      dirinfo->rd_size               = 0;
+    }
+  else
+    {
+      dirinfo->rd_dir.fr_curroffset  = de->de_offset;
+      dirinfo->rd_size               = de->de_size;
+    }
+
+  dirinfo->rd_next                   = de->de_next;
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: romfs_searchdir
  *
@@ -279,6 +530,16 @@ static inline int romfs_searchdir(struct romfs_mountpt_s *rm,
   int16_t  ndx;
   int      ret;
 
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+  /* Try the directory index first */
+
+  ret = romfs_searchindex(rm, entryname, entrylen, dirinfo);
+  if (ret == OK || ret == -ENOENT)
+    {
+      return ret;
+    }
+#endif
+
   /* Then loop through the current directory until the directory
    * with the matching name is found.  Or until all of the entries
    * the directory have been examined.
@@ -998,3 +1259,34 @@ int romfs_datastart(struct romfs_mountpt_s *rm, uint32_t offset,
 
   return -EINVAL; /* Won't get here */
 }
+
+/****************************************************************************
+ * Name: romfs_freedirindex
+ *
+ * Description:
+ *   Release the directory index of the mountpoint
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+void romfs_freedirindex(struct romfs_mountpt_s *rm)
+{
+  FAR struct romfs_dirent_s *de;
+  int i;
+
+  if (rm->rm_dirindex)
+    {
+      for (i = 0; i < CONFIG_FS_ROMFS_DIRINDEX_NBUCKETS; i++)
+        {
+          while ((de = rm->rm_dirindex[i]) != NULL)
+            {
+              rm->rm_dirindex[i] = de->de_flink;
+              kmm_free(de);
+            }
+        }
+
+      kmm_free(rm->rm_dirindex);
+      rm->rm_dirindex = NULL;
+    }
+}
+#endif
@@ -204,7 +204,7 @@
 #  define CONFIG_SMARTFS_DIRDEPTH 8
 #endif
 
-/* Buffer flags (when CRC enabled) */
+/* Buffer flags (when the sector buffer is used) */
 
 #define SMARTFS_BFLAG_DIRTY       0x01    /* Set if data changed in the sector */
 #define SMARTFS_BFLAG_NEWALLOC    0x02    /* Set if sector not written since alloc */
@@ -225,8 +225,9 @@
 #define SMARTFS_NEXTSECTOR(h)    (*((uint16_t *)h->nextsector))
 #define SMARTFS_USED(h)          (*((uint16_t *)h->used))
 
-#ifdef CONFIG_MTD_SMART_ENABLE_CRC
-#define CONFIG_SMARTFS_USE_SECTOR_BUFFER
+#if defined(CONFIG_MTD_SMART_ENABLE_CRC) && \
+    !defined(CONFIG_SMARTFS_USE_SECTOR_BUFFER)
+#  define CONFIG_SMARTFS_USE_SECTOR_BUFFER
 #endif
 
 /****************************************************************************
@@ -852,6 +852,11 @@ static size_t smartfs_status_read(FAR struct file *filep, FAR char *buffer,
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
                          "Uneven Wear Count: %d\n"
 #endif
+                         "GC Blocks:         %d\n"
+#ifdef CONFIG_MTD_SMART_BGGC
+                         "Background GC:     %d\n"
+#endif
+                         "Relocated Sectors: %d\n"
                   ,
                   procfs_data.formatversion, procfs_data.namelen,
                   procfs_data.totalsectors, procfs_data.sectorsize,
@@ -862,6 +867,11 @@ static size_t smartfs_status_read(FAR struct file *filep, FAR char *buffer,
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
                   , procfs_data.uneven_wearcount
 #endif
+                  , procfs_data.gcblocks
+#ifdef CONFIG_MTD_SMART_BGGC
+                  , procfs_data.bggcblocks
+#endif
+                  , procfs_data.relocsectors
            );
         }
 
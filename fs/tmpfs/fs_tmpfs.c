@@ -51,10 +51,6 @@
 #  warning CONFIG_FS_TMPFS_DIRECTORY_FREEGUARD needs to be > ALLOCGUARD
 #endif
 
-#if CONFIG_FS_TMPFS_FILE_FREEGUARD <= CONFIG_FS_TMPFS_FILE_ALLOCGUARD
-#  warning CONFIG_FS_TMPFS_FILE_FREEGUARD needs to be > ALLOCGUARD
-#endif
-
 #define tmpfs_lock_file(tfo) \
            (tmpfs_lock_object((FAR struct tmpfs_object_s *)tfo))
 #define tmpfs_lock_directory(tdo) \
@@ -78,8 +74,15 @@ static int  tmpfs_lock_object(FAR struct tmpfs_object_s *to);
 static void tmpfs_unlock_object(FAR struct tmpfs_object_s *to);
 static int  tmpfs_realloc_directory(FAR struct tmpfs_directory_s **tdo,
               unsigned int nentries);
-static int  tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo,
+static void tmpfs_update_alloc(FAR struct tmpfs_file_s *tfo);
+static void tmpfs_free_pages(FAR struct tmpfs_file_s *tfo, size_t first);
+static void tmpfs_free_file(FAR struct tmpfs_file_s *tfo);
+static int  tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
               size_t newsize);
+static void tmpfs_copyin(FAR struct tmpfs_file_s *tfo, size_t offset,
+              FAR const uint8_t *src, size_t len);
+static void tmpfs_copyout(FAR struct tmpfs_file_s *tfo, FAR uint8_t *dest,
+              size_t offset, size_t len);
 static void tmpfs_release_lockedobject(FAR struct tmpfs_object_s *to);
 static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo);
 static int  tmpfs_find_dirent(FAR struct tmpfs_directory_s *tdo,
@@ -345,72 +348,195 @@ static int tmpfs_realloc_directory(FAR struct tmpfs_directory_s **tdo,
 }
 
 /****************************************************************************
- * Name: tmpfs_realloc_file
+ * Name: tmpfs_update_alloc
  ****************************************************************************/
 
-static int tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo,
-                              size_t newsize)
+static void tmpfs_update_alloc(FAR struct tmpfs_file_s *tfo)
 {
-  FAR struct tmpfs_file_s *oldtfo = *tfo;
-  FAR struct tmpfs_file_s *newtfo;
-  size_t objsize;
-  size_t allocsize;
-  size_t delta;
+  tfo->tfo_alloc = sizeof(struct tmpfs_file_s) +
+                   tfo->tfo_ntable * sizeof(FAR uint8_t *) +
+                   tfo->tfo_npages * TMPFS_PAGESIZE;
+}
 
-  /* Check if the current allocation is sufficient */
+/****************************************************************************
+ * Name: tmpfs_free_pages
+ *
+ * Description:
+ *   Release all pages of the file from page 'first' on.
+ *
+ ****************************************************************************/
+
+static void tmpfs_free_pages(FAR struct tmpfs_file_s *tfo, size_t first)
+{
+  size_t i;
 
-  objsize = SIZEOF_TMPFS_FILE(newsize);
+  for (i = first; i < tfo->tfo_npages; i++)
+    {
+      kmm_free(tfo->tfo_pages[i]);
+    }
 
-  /* Are we growing or shrinking the object? */
+  if (first < tfo->tfo_npages)
+    {
+      tfo->tfo_npages = first;
+    }
 
-  if (objsize <= oldtfo->tfo_alloc)
+  if (tfo->tfo_npages == 0)
     {
-      /* Shrinking ... Shrink unconditionally if the size is shrinking to
-       * zero.
+      if (tfo->tfo_pages != NULL)
+        {
+          kmm_free(tfo->tfo_pages);
+          tfo->tfo_pages  = NULL;
+          tfo->tfo_ntable = 0;
+        }
+    }
+
+  tmpfs_update_alloc(tfo);
+}
+
+/****************************************************************************
+ * Name: tmpfs_free_file
+ ****************************************************************************/
+
+static void tmpfs_free_file(FAR struct tmpfs_file_s *tfo)
+{
+  tmpfs_free_pages(tfo, 0);
+  kmm_free(tfo);
+}
+
+/****************************************************************************
+ * Name: tmpfs_realloc_file
+ *
+ * Description:
+ *   Add or release pages so that the file can hold 'newsize' bytes.  The
+ *   contents of added pages are undefined.
+ *
+ ****************************************************************************/
+
+static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
+                              size_t newsize)
+{
+  size_t npages = (newsize + TMPFS_PAGESIZE - 1) / TMPFS_PAGESIZE;
+
+  if (npages < tfo->tfo_npages)
+    {
+      /* Shrinking... release the pages beyond the new end of the file */
+
+      tmpfs_free_pages(tfo, npages);
+    }
+  else if (npages > tfo->tfo_npages)
+    {
+      /* Growing... first make room in the page table.  The table grows by
+       * doubling so that appending to a file reallocates it only rarely.
        */
 
-      if (newsize > 0)
+      if (npages > tfo->tfo_ntable)
         {
-          /* Otherwise, don't realloc unless the object has shrunk by a
-           * lot.
-           */
+          FAR uint8_t **pages;
+          size_t ntable = tfo->tfo_ntable > 0 ? 2 * tfo->tfo_ntable : 4;
 
-          delta = oldtfo->tfo_alloc - objsize;
-          if (delta <= CONFIG_FS_TMPFS_FILE_FREEGUARD)
+          while (ntable < npages)
             {
-              /* Hasn't shrunk enough.. Return doing nothing for now */
+              ntable *= 2;
+            }
 
-              oldtfo->tfo_size = newsize;
-              return OK;
+          pages = (FAR uint8_t **)
+            kmm_realloc(tfo->tfo_pages, ntable * sizeof(FAR uint8_t *));
+          if (pages == NULL)
+            {
+              return -ENOMEM;
             }
+
+          tfo->tfo_pages  = pages;
+          tfo->tfo_ntable = ntable;
         }
-    }
 
-  /* Added some additional amount to the new size to account frequent
-   * reallocations.
-   */
+      /* Then add the pages */
 
-  allocsize = objsize + CONFIG_FS_TMPFS_FILE_ALLOCGUARD;
+      while (tfo->tfo_npages < npages)
+        {
+          FAR uint8_t *page = (FAR uint8_t *)kmm_malloc(TMPFS_PAGESIZE);
 
-  /* Realloc the file object */
+          if (page == NULL)
+            {
+              tmpfs_update_alloc(tfo);
+              return -ENOMEM;
+            }
 
-  newtfo = (FAR struct tmpfs_file_s *)kmm_realloc(oldtfo, allocsize);
-  if (newtfo == NULL)
+          tfo->tfo_pages[tfo->tfo_npages++] = page;
+        }
+
+      tmpfs_update_alloc(tfo);
+    }
+
+  tfo->tfo_size = newsize;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tmpfs_copyin
+ *
+ * Description:
+ *   Copy 'len' bytes from 'src' into the file pages at 'offset'.  If 'src'
+ *   is NULL, the range is cleared instead.
+ *
+ ****************************************************************************/
+
+static void tmpfs_copyin(FAR struct tmpfs_file_s *tfo, size_t offset,
+                         FAR const uint8_t *src, size_t len)
+{
+  while (len > 0)
     {
-      return -ENOMEM;
+      FAR uint8_t *page = tfo->tfo_pages[offset / TMPFS_PAGESIZE];
+      size_t pgoff = offset % TMPFS_PAGESIZE;
+      size_t ncopy = TMPFS_PAGESIZE - pgoff;
+
+      if (ncopy > len)
+        {
+          ncopy = len;
+        }
+
+      if (src != NULL)
+        {
+          memcpy(page + pgoff, src, ncopy);
+          src += ncopy;
+        }
+      else
+        {
+          memset(page + pgoff, 0, ncopy);
+        }
+
+      offset += ncopy;
+      len    -= ncopy;
     }
+}
 
-  /* Adjust the reference in the parent directory entry */
+/****************************************************************************
+ * Name: tmpfs_copyout
+ *
+ * Description:
+ *   Copy 'len' bytes from the file pages at 'offset' to 'dest'.
+ *
+ ****************************************************************************/
 
-  DEBUGASSERT(newtfo->tfo_dirent);
-  newtfo->tfo_dirent->tde_object = (FAR struct tmpfs_object_s *)newtfo;
+static void tmpfs_copyout(FAR struct tmpfs_file_s *tfo, FAR uint8_t *dest,
+                          size_t offset, size_t len)
+{
+  while (len > 0)
+    {
+      FAR const uint8_t *page = tfo->tfo_pages[offset / TMPFS_PAGESIZE];
+      size_t pgoff = offset % TMPFS_PAGESIZE;
+      size_t ncopy = TMPFS_PAGESIZE - pgoff;
 
-  /* Return the new address of the reallocated file object */
+      if (ncopy > len)
+        {
+          ncopy = len;
+        }
 
-  newtfo->tfo_alloc = allocsize;
-  newtfo->tfo_size  = newsize;
-  *tfo              = newtfo;
-  return OK;
+      memcpy(dest, page + pgoff, ncopy);
+      dest   += ncopy;
+      offset += ncopy;
+      len    -= ncopy;
+    }
 }
 
 /****************************************************************************
@@ -449,7 +575,7 @@ static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo)
   if (tfo->tfo_refs == 1 && (tfo->tfo_flags & TFO_FLAG_UNLINKED) != 0)
     {
       nxsem_destroy(&tfo->tfo_exclsem.ts_sem);
-      kmm_free(tfo);
+      tmpfs_free_file(tfo);
     }
 
   /* Otherwise, just decrement the reference count on the file object */
@@ -595,12 +721,12 @@ static int tmpfs_add_dirent(FAR struct tmpfs_directory_s **tdo,
 static FAR struct tmpfs_file_s *tmpfs_alloc_file(void)
 {
   FAR struct tmpfs_file_s *tfo;
-  size_t allocsize;
 
-  /* Create a new zero length file object */
+  /* Create a new zero length file object.  No pages are allocated until
+   * data is written to the file.
+   */
 
-  allocsize = SIZEOF_TMPFS_FILE(CONFIG_FS_TMPFS_FILE_ALLOCGUARD);
-  tfo = (FAR struct tmpfs_file_s *)kmm_malloc(allocsize);
+  tfo = (FAR struct tmpfs_file_s *)kmm_malloc(sizeof(struct tmpfs_file_s));
   if (tfo == NULL)
     {
       return NULL;
@@ -610,11 +736,14 @@ static FAR struct tmpfs_file_s *tmpfs_alloc_file(void)
    * locked with one reference count.
    */
 
-  tfo->tfo_alloc = allocsize;
-  tfo->tfo_type  = TMPFS_REGULAR;
-  tfo->tfo_refs  = 1;
-  tfo->tfo_flags = 0;
-  tfo->tfo_size  = 0;
+  tfo->tfo_alloc   = sizeof(struct tmpfs_file_s);
+  tfo->tfo_type    = TMPFS_REGULAR;
+  tfo->tfo_refs    = 1;
+  tfo->tfo_flags   = 0;
+  tfo->tfo_size    = 0;
+  tfo->tfo_npages  = 0;
+  tfo->tfo_ntable  = 0;
+  tfo->tfo_pages   = NULL;
 
   tfo->tfo_exclsem.ts_holder = getpid();
   tfo->tfo_exclsem.ts_count  = 1;
@@ -1280,7 +1409,15 @@ static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
   /* Free the object now */
 
   nxsem_destroy(&to->to_exclsem.ts_sem);
-  kmm_free(to);
+  if (to->to_type == TMPFS_REGULAR)
+    {
+      tmpfs_free_file((FAR struct tmpfs_file_s *)to);
+    }
+  else
+    {
+      kmm_free(to);
+    }
+
   return TMPFS_DELETED;
 }
 
@@ -1441,7 +1578,7 @@ static int tmpfs_open(FAR struct file *filep, FAR const char *relpath,
 
           if (tfo->tfo_size > 0)
             {
-              ret = tmpfs_realloc_file(&tfo, 0);
+              ret = tmpfs_realloc_file(tfo, 0);
               if (ret < 0)
                 {
                   goto errout_with_filelock;
@@ -1561,7 +1698,7 @@ static int tmpfs_close(FAR struct file *filep)
        * have any other references.
        */
 
-      kmm_free(tfo);
+      tmpfs_free_file(tfo);
       return OK;
     }
 
@@ -1606,7 +1743,11 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
   nread    = buflen;
   endpos   = startpos + buflen;
 
-  if (endpos > tfo->tfo_size)
+  if (startpos >= tfo->tfo_size)
+    {
+      nread = 0;
+    }
+  else if (endpos > tfo->tfo_size)
     {
       endpos = tfo->tfo_size;
       nread  = endpos - startpos;
@@ -1614,7 +1755,7 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
 
   /* Copy data from the memory object to the user buffer */
 
-  memcpy(buffer, &tfo->tfo_data[startpos], nread);
+  tmpfs_copyout(tfo, (FAR uint8_t *)buffer, startpos, nread);
   filep->f_pos += nread;
 
   /* Release the lock on the file */
@@ -1632,6 +1773,7 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
 {
   FAR struct tmpfs_file_s *tfo;
   ssize_t nwritten;
+  size_t oldsize;
   off_t startpos;
   off_t endpos;
   int ret;
@@ -1658,22 +1800,29 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
   nwritten = buflen;
   endpos   = startpos + buflen;
 
-  if (endpos > tfo->tfo_size)
+  oldsize  = tfo->tfo_size;
+
+  if (endpos > oldsize)
     {
-      /* Reallocate the file to handle the write past the end of the file. */
+      /* Add pages to handle the write past the end of the file. */
 
-      ret = tmpfs_realloc_file(&tfo, (size_t)endpos);
+      ret = tmpfs_realloc_file(tfo, (size_t)endpos);
       if (ret < 0)
         {
           goto errout_with_lock;
         }
 
-      filep->f_priv = tfo;
+      /* Clear any gap between the old end of the file and the write */
+
+      if (startpos > oldsize)
+        {
+          tmpfs_copyin(tfo, oldsize, NULL, startpos - oldsize);
+        }
     }
 
-  /* Copy data from the memory object to the user buffer */
+  /* Copy data from the user buffer to the memory object */
 
-  memcpy(&tfo->tfo_data[startpos], buffer, nwritten);
+  tmpfs_copyin(tfo, startpos, (FAR const uint8_t *)buffer, nwritten);
   filep->f_pos += nwritten;
 
   /* Release the lock on the file */
@@ -1754,6 +1903,7 @@ static int tmpfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 {
   FAR struct tmpfs_file_s *tfo;
   FAR void **ppv = (FAR void**)arg;
+  int ret;
 
   finfo("filep: %p cmd: %d arg: %08lx\n", filep, cmd, arg);
   DEBUGASSERT(filep->f_priv != NULL && filep->f_inode != NULL);
@@ -1768,12 +1918,29 @@ static int tmpfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
   if (cmd == FIOC_MMAP && ppv != NULL)
     {
-      /* Return the address on the media corresponding to the start of
-       * the file.
+      /* Return the address in memory corresponding to the start of the
+       * file.  This is only possible if the file data is contiguous, that
+       * is, if it fits in one page.  Larger files are not copied into a
+       * contiguous block; the caller has to read them instead.
        */
 
-      *ppv = (FAR void *)tfo->tfo_data;
-      return OK;
+      ret = tmpfs_lock_file(tfo);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      if (tfo->tfo_npages == 1)
+        {
+          *ppv = (FAR void *)tfo->tfo_pages[0];
+        }
+      else
+        {
+          ret = -ENOTTY;
+        }
+
+      tmpfs_unlock_file(tfo);
+      return ret;
     }
 
   ferr("ERROR: Invalid cmd: %d\n", cmd);
@@ -1890,23 +2057,21 @@ static int tmpfs_truncate(FAR struct file *filep, off_t length)
   oldsize = tfo->tfo_size;
   if (oldsize != length)
     {
-      /* The size is changing.. up or down.  Reallocate the file memory. */
+      /* The size is changing.. up or down.  Add or release pages. */
 
-      ret = tmpfs_realloc_file(&tfo, (size_t)length);
+      ret = tmpfs_realloc_file(tfo, (size_t)length);
       if (ret < 0)
         {
           goto errout_with_lock;
         }
 
-      filep->f_priv = tfo;
-
       /* If the size has increased, then we need to zero the newly added
        * memory.
        */
 
       if (length > oldsize)
         {
-          memset(&tfo->tfo_data[oldsize], 0, length - oldsize);
+          tmpfs_copyin(tfo, oldsize, NULL, length - oldsize);
         }
 
       ret = OK;
@@ -2334,7 +2499,7 @@ static int tmpfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
   else
     {
       nxsem_destroy(&tfo->tfo_exclsem.ts_sem);
-      kmm_free(tfo);
+      tmpfs_free_file(tfo);
     }
 
   /* Release the reference and lock on the parent directory */
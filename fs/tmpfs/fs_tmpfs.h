@@ -59,6 +59,14 @@
 
 #define TFO_FLAG_UNLINKED (1 << 0)  /* Bit 0: File is unlinked */
 
+/* File data is held in pages of this size */
+
+#ifndef CONFIG_FS_TMPFS_PAGESIZE
+#  define CONFIG_FS_TMPFS_PAGESIZE 512
+#endif
+
+#define TMPFS_PAGESIZE    CONFIG_FS_TMPFS_PAGESIZE
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -138,6 +146,12 @@ struct tmpfs_directory_s
  * state.  The file memory object also serves as the open file object,
  * saving an allocation.  This has the negative side effect that no per-
  * open state can be retained (such as open flags).
+ *
+ * The file data is held in separately allocated pages of TMPFS_PAGESIZE
+ * bytes so that a file grows without copying its data and without needing
+ * a contiguous free block the size of the file.  tfo_pages[] holds the
+ * address of each page.  Only a file that fits in one page can be mapped
+ * with FIOC_MMAP.
  */
 
 struct tmpfs_file_s
@@ -155,10 +169,13 @@ struct tmpfs_file_s
 
   uint8_t  tfo_flags;    /* See TFO_FLAG_* definitions */
   size_t   tfo_size;     /* Valid file size */
-  uint8_t  tfo_data[1];  /* File data starts here */
-};
+  size_t   tfo_npages;   /* Number of pages holding file data */
+  size_t   tfo_ntable;   /* Number of entries allocated in tfo_pages */
 
-#define SIZEOF_TMPFS_FILE(n) (sizeof(struct tmpfs_file_s) + (n) - 1)
+  /* Address of each page */
+
+  FAR uint8_t **tfo_pages;
+};
 
 /* This structure represents one instance of a TMPFS file system */
 
@@ -42,25 +42,378 @@
 #include <sys/epoll.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <poll.h>
+#include <queue.h>
+#include <signal.h>
 #include <errno.h>
-#include <string.h>
+#include <assert.h>
 #include <debug.h>
 
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/signal.h>
+#include <nuttx/cancelpt.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The events that are passed on to the poll logic of the descriptor */
+
+#define EPOLL_POLLEVENTS (EPOLLIN | EPOLLPRI | EPOLLOUT)
 
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+struct epoll_head;
+
+/* One registered file descriptor.  The poll operation of the descriptor is
+ * set up when the descriptor is added and stays set up, so that each event
+ * reported by the driver moves the node to the ready list of the epoll
+ * instance through epoll_callback().
+ *
+ * The node does not hold a reference to the open file (or socket) of the
+ * descriptor.  When the descriptor is closed, epoll_remove() tears down
+ * the poll operation and frees the node.
+ */
+
+struct epoll_node
+{
+  dq_entry_t link;               /* Link in the ready list */
+  FAR struct epoll_head *eph;    /* The epoll instance */
+  FAR void *ptr;                 /* The open file or socket */
+  struct pollfd pfd;             /* Poll descriptor given to the driver */
+  struct pollcb_s pcb;           /* Makes poll_notify() call the callback */
+  epoll_data_t data;             /* User data returned with the events */
+  uint32_t events;               /* EPOLL* flags of EPOLL_CTL_ADD/MOD */
+  bool inuse;                    /* The node holds a file descriptor */
+  bool armed;                    /* The poll operation is set up */
+  volatile bool ready;           /* The node is in the ready list */
+  volatile bool quiet;           /* Ignore notifications while re-arming */
+};
+
 struct epoll_head
 {
-  int size;
-  int occupied;
-  FAR epoll_data_t *data;
-  FAR struct pollfd *poll;
+  sq_entry_t link;               /* Link in g_epoll_heads */
+  int size;                      /* Number of nodes */
+  int occupied;                  /* Number of nodes in use */
+  sem_t lock;                    /* Serializes epoll_ctl and epoll_wait */
+  sem_t sem;                     /* Posted by epoll_callback() */
+  dq_queue_t ready;              /* Nodes with pending notifications */
+  FAR struct epoll_node *nodes;  /* Array of 'size' nodes */
 };
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* All epoll instances, so that a file can be removed from them when it is
+ * closed.
+ */
+
+static sq_queue_t g_epoll_heads;
+static sem_t g_epoll_lock = SEM_INITIALIZER(1);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: epoll_callback
+ *
+ * Description:
+ *   Called by poll_notify() when the driver reports events on the file
+ *   descriptor of a node.  Moves the node to the ready list.  This may run
+ *   in an interrupt handler.
+ *
+ ****************************************************************************/
+
+static void epoll_callback(FAR void *arg)
+{
+  FAR struct epoll_node *node = (FAR struct epoll_node *)arg;
+  irqstate_t flags;
+  int semcount;
+
+  flags = enter_critical_section();
+  if (!node->ready && !node->quiet)
+    {
+      node->ready = true;
+      dq_addlast(&node->link, &node->eph->ready);
+
+      /* The waiter only needs to know that the ready list changed */
+
+      nxsem_get_value(&node->eph->sem, &semcount);
+      if (semcount < 1)
+        {
+          nxsem_post(&node->eph->sem);
+        }
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: epoll_poll
+ *
+ * Description:
+ *   Set up or tear down the poll operation on the file descriptor of a
+ *   node.
+ *
+ ****************************************************************************/
+
+static int epoll_poll(FAR struct epoll_node *node, bool setup)
+{
+#ifdef CONFIG_NET
+  if (node->pfd.fd >= CONFIG_NFILE_DESCRIPTORS)
+    {
+      return psock_poll((FAR struct socket *)node->ptr, &node->pfd, setup);
+    }
+#endif
+
+  return file_poll((FAR struct file *)node->ptr, &node->pfd, setup);
+}
+
+/****************************************************************************
+ * Name: epoll_lookup
+ *
+ * Description:
+ *   Find the open file (or socket) of 'fd' for a node.
+ *
+ ****************************************************************************/
+
+static int epoll_lookup(FAR struct epoll_node *node, int fd)
+{
+  FAR struct file *filep;
+  int ret;
+
+#ifdef CONFIG_NET
+  if (fd >= CONFIG_NFILE_DESCRIPTORS)
+    {
+      FAR struct socket *psock = sockfd_socket(fd);
+
+      if (psock == NULL || psock->s_crefs <= 0)
+        {
+          return -EBADF;
+        }
+
+      node->ptr = psock;
+      return OK;
+    }
+#endif
+
+  ret = fs_getfilep(fd, &filep);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  node->ptr = filep;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: epoll_arm
+ *
+ * Description:
+ *   Set up the poll operation on the file descriptor of a node.  If the
+ *   descriptor is already ready, the driver reports that immediately,
+ *   which puts the node on the ready list unless 'quiet' is true.
+ *
+ ****************************************************************************/
+
+static int epoll_arm(FAR struct epoll_node *node, bool quiet)
+{
+  int ret;
+
+  node->pfd.revents = 0;
+  node->pfd.priv    = NULL;
+  node->quiet       = quiet;
+
+  ret = epoll_poll(node, true);
+
+  node->quiet       = false;
+  node->armed       = (ret >= 0);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: epoll_disarm
+ *
+ * Description:
+ *   Tear down the poll operation on the file descriptor of a node and
+ *   remove the node from the ready list.
+ *
+ ****************************************************************************/
+
+static void epoll_disarm(FAR struct epoll_node *node)
+{
+  irqstate_t flags;
+
+  if (node->armed)
+    {
+      epoll_poll(node, false);
+      node->armed = false;
+    }
+
+  flags = enter_critical_section();
+  if (node->ready)
+    {
+      dq_rem(&node->link, &node->eph->ready);
+      node->ready = false;
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: epoll_find
+ *
+ * Description:
+ *   Return the node holding 'fd' or NULL.
+ *
+ ****************************************************************************/
+
+static FAR struct epoll_node *epoll_find(FAR struct epoll_head *eph, int fd)
+{
+  int i;
+
+  for (i = 0; i < eph->size; i++)
+    {
+      if (eph->nodes[i].inuse && eph->nodes[i].pfd.fd == fd)
+        {
+          return &eph->nodes[i];
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: epoll_setup
+ *
+ * Description:
+ *   Apply the events and data of 'ev' to a node.
+ *
+ ****************************************************************************/
+
+static void epoll_setup(FAR struct epoll_node *node,
+                        FAR struct epoll_event *ev)
+{
+  node->data       = ev->data;
+  node->events     = ev->events;
+  node->pfd.events = (ev->events & EPOLL_POLLEVENTS) | POLLERR | POLLHUP;
+}
+
+/****************************************************************************
+ * Name: epoll_collect
+ *
+ * Description:
+ *   Return the events of up to 'maxevents' nodes of the ready list.  Only
+ *   the nodes on the ready list are examined, so the cost does not depend
+ *   on the number of registered file descriptors.
+ *
+ *   Level triggered nodes are re-armed after they are reported; if the
+ *   descriptor is still ready, the driver reports it again at once and the
+ *   node goes back to the ready list.  EPOLLET nodes are re-armed quietly
+ *   so that only new events are reported.  EPOLLONESHOT nodes stay
+ *   disarmed until they are modified with EPOLL_CTL_MOD.
+ *
+ * Assumptions:
+ *   The caller holds eph->lock.
+ *
+ ****************************************************************************/
+
+static int epoll_collect(FAR struct epoll_head *eph,
+                         FAR struct epoll_event *evs, int maxevents)
+{
+  FAR struct epoll_node *node;
+  dq_queue_t pending;
+  irqstate_t flags;
+  pollevent_t revents;
+  int nevents = 0;
+
+  /* Detach the ready list so that nodes that are re-armed below do not
+   * show up again in this pass.
+   */
+
+  flags   = enter_critical_section();
+  pending = eph->ready;
+  dq_init(&eph->ready);
+  leave_critical_section(flags);
+
+  while (nevents < maxevents)
+    {
+      flags = enter_critical_section();
+      node  = (FAR struct epoll_node *)dq_remfirst(&pending);
+      if (node != NULL)
+        {
+          node->ready = false;
+        }
+
+      leave_critical_section(flags);
+
+      if (node == NULL)
+        {
+          break;
+        }
+
+      /* Tear down the poll to collect the final event set */
+
+      if (node->armed)
+        {
+          epoll_poll(node, false);
+          node->armed = false;
+        }
+
+      revents = node->pfd.revents & node->pfd.events;
+      if (revents != 0)
+        {
+          evs[nevents].events = revents;
+          evs[nevents].data   = node->data;
+          nevents++;
+
+          if ((node->events & EPOLLONESHOT) != 0)
+            {
+              /* The node stays disarmed.  Drop the events reported
+               * above, and the node itself if the driver put it back on
+               * the ready list before the poll was torn down.
+               */
+
+              flags = enter_critical_section();
+              node->pfd.revents = 0;
+              if (node->ready)
+                {
+                  dq_rem(&node->link, &eph->ready);
+                  node->ready = false;
+                }
+
+              leave_critical_section(flags);
+              continue;
+            }
+        }
+
+      epoll_arm(node, revents != 0 && (node->events & EPOLLET) != 0);
+    }
+
+  /* Put the nodes that did not fit back at the head of the ready list */
+
+  if (!dq_empty(&pending))
+    {
+      flags = enter_critical_section();
+      dq_cat(&eph->ready, &pending);
+      eph->ready = pending;
+      leave_critical_section(flags);
+    }
+
+  return nevents;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -69,24 +422,60 @@ struct epoll_head
  * Name: epoll_create
  *
  * Description:
+ *   Create an epoll instance that can hold up to 'size' file descriptors.
  *
  * Input Parameters:
+ *   size - The maximum number of file descriptors
  *
  * Returned Value:
+ *   A handle of the epoll instance is returned on success.  On failure,
+ *   -1 (ERROR) is returned and the errno value is set appropriately.
  *
  ****************************************************************************/
 
 int epoll_create(int size)
 {
-  FAR struct epoll_head *eph =
-    (FAR struct epoll_head *)kmm_malloc(sizeof(struct epoll_head) +
-                                        sizeof(epoll_data_t) * size +
-                                        sizeof(struct pollfd) * size);
+  FAR struct epoll_head *eph;
+  int i;
+
+  if (size <= 0)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  eph = (FAR struct epoll_head *)kmm_zalloc(sizeof(struct epoll_head) +
+                                            sizeof(struct epoll_node) *
+                                            size);
+  if (eph == NULL)
+    {
+      set_errno(ENOMEM);
+      return ERROR;
+    }
+
+  eph->size  = size;
+  eph->nodes = (FAR struct epoll_node *)(eph + 1);
+
+  for (i = 0; i < size; i++)
+    {
+      eph->nodes[i].eph = eph;
+      nxsem_init(&eph->nodes[i].pcb.pc_sem, 0, POLLCB_SEMCOUNT);
+      eph->nodes[i].pcb.pc_cb  = epoll_callback;
+      eph->nodes[i].pcb.pc_arg = &eph->nodes[i];
+    }
 
-  eph->size = size;
-  eph->occupied = 0;
-  eph->data = (FAR epoll_data_t *)(eph + 1);
-  eph->poll = (FAR struct pollfd *)(eph->data + size);
+  nxsem_init(&eph->lock, 0, 1);
+
+  /* This semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  nxsem_init(&eph->sem, 0, 0);
+  nxsem_set_protocol(&eph->sem, SEM_PRIO_NONE);
+
+  nxsem_wait_uninterruptible(&g_epoll_lock);
+  sq_addlast(&eph->link, &g_epoll_heads);
+  nxsem_post(&g_epoll_lock);
 
   /* REVISIT: This will not work on machines where:
    * sizeof(struct epoll_head *) > sizeof(int)
@@ -99,10 +488,14 @@ int epoll_create(int size)
  * Name: epoll_create1
  *
  * Description:
+ *   Create an epoll instance that can hold up to
+ *   CONFIG_FS_NEPOLL_DESCRIPTORS file descriptors.
  *
  * Input Parameters:
+ *   flags - Zero or EPOLL_CLOEXEC
  *
  * Returned Value:
+ *   See epoll_create().
  *
  ****************************************************************************/
 
@@ -112,9 +505,10 @@ int epoll_create1(int flags)
    * the handle of epoll(2) is not a real file handle.
    */
 
-  if (flags != EPOLL_CLOEXEC)
+  if (flags != 0 && flags != EPOLL_CLOEXEC)
     {
-      return EINVAL;
+      set_errno(EINVAL);
+      return ERROR;
     }
 
   return epoll_create(CONFIG_FS_NEPOLL_DESCRIPTORS);
@@ -124,10 +518,13 @@ int epoll_create1(int flags)
  * Name: epoll_close
  *
  * Description:
+ *   Tear down all registered file descriptors and free the epoll instance.
  *
  * Input Parameters:
+ *   epfd - The epoll instance
  *
  * Returned Value:
+ *   None
  *
  ****************************************************************************/
 
@@ -138,7 +535,26 @@ void epoll_close(int epfd)
    */
 
   FAR struct epoll_head *eph = (FAR struct epoll_head *)((intptr_t)epfd);
+  int i;
+
+  nxsem_wait_uninterruptible(&g_epoll_lock);
+  sq_rem(&eph->link, &g_epoll_heads);
+  nxsem_post(&g_epoll_lock);
 
+  nxsem_wait_uninterruptible(&eph->lock);
+
+  for (i = 0; i < eph->size; i++)
+    {
+      if (eph->nodes[i].inuse)
+        {
+          epoll_disarm(&eph->nodes[i]);
+        }
+
+      nxsem_destroy(&eph->nodes[i].pcb.pc_sem);
+    }
+
+  nxsem_destroy(&eph->sem);
+  nxsem_destroy(&eph->lock);
   kmm_free(eph);
 }
 
@@ -146,82 +562,153 @@ void epoll_close(int epfd)
  * Name: epoll_ctl
  *
  * Description:
+ *   Add, modify or remove a file descriptor of an epoll instance.  A file
+ *   descriptor that is closed is removed from the epoll instance
+ *   automatically.
  *
  * Input Parameters:
+ *   epfd - The epoll instance
+ *   op   - EPOLL_CTL_ADD, EPOLL_CTL_MOD or EPOLL_CTL_DEL
+ *   fd   - The file descriptor
+ *   ev   - The events and user data (unused with EPOLL_CTL_DEL)
  *
  * Returned Value:
+ *   Zero (OK) is returned on success.  On failure, -1 (ERROR) is returned
+ *   and the errno value is set appropriately.
  *
  ****************************************************************************/
 
-int epoll_ctl(int epfd, int op, int fd, struct epoll_event *ev)
+int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
 {
   /* REVISIT: This will not work on machines where:
    * sizeof(struct epoll_head *) > sizeof(int)
    */
 
   FAR struct epoll_head *eph = (FAR struct epoll_head *)((intptr_t)epfd);
+  FAR struct epoll_node *node;
+  int ret = OK;
+
+  if (op != EPOLL_CTL_DEL && ev == NULL)
+    {
+      set_errno(EFAULT);
+      return ERROR;
+    }
 
+  nxsem_wait_uninterruptible(&eph->lock);
+
+  node = epoll_find(eph, fd);
   switch (op)
     {
       case EPOLL_CTL_ADD:
         finfo("%08x CTL ADD(%d): fd=%d ev=%08x\n",
               epfd, eph->occupied, fd, ev->events);
 
-        eph->data[eph->occupied]        = ev->data;
-        eph->poll[eph->occupied].events = ev->events | POLLERR | POLLHUP;
-        eph->poll[eph->occupied++].fd   = fd;
-        return 0;
+        if (node != NULL)
+          {
+            ret = -EEXIST;
+            break;
+          }
+
+        if (eph->occupied >= eph->size)
+          {
+            ret = -ENOMEM;
+            break;
+          }
+
+        node = eph->nodes;
+        while (node->inuse)
+          {
+            node++;
+          }
+
+        node->pfd.fd  = fd;
+        node->pfd.sem = &node->pcb.pc_sem;
+        epoll_setup(node, ev);
+
+        ret = epoll_lookup(node, fd);
+        if (ret < 0)
+          {
+            break;
+          }
+
+        ret = epoll_arm(node, false);
+        if (ret < 0)
+          {
+            epoll_disarm(node);
+            break;
+          }
+
+        node->inuse = true;
+        eph->occupied++;
+        break;
 
       case EPOLL_CTL_DEL:
-        {
-          int i;
+        finfo("%08x CTL DEL(%d): fd=%d\n", epfd, eph->occupied, fd);
 
-          for (i = 0; i < eph->occupied; i++)
-            {
-              if (eph->poll[i].fd == fd)
-                {
-                  if (i != eph->occupied - 1)
-                    {
-                      memmove(&eph->data[i], &eph->data[i + 1],
-                              sizeof(epoll_data_t) * (eph->occupied - i));
-                      memmove(&eph->poll[i], &eph->poll[i + 1],
-                              sizeof(struct pollfd) * (eph->occupied - i));
-                    }
-
-                  eph->occupied--;
-                  return 0;
-                }
-            }
+        if (node == NULL)
+          {
+            ret = -ENOENT;
+            break;
+          }
 
-          return -ENOENT;
-        }
+        epoll_disarm(node);
+        node->inuse = false;
+        eph->occupied--;
+        break;
 
       case EPOLL_CTL_MOD:
-        {
-          int i;
+        finfo("%08x CTL MOD(%d): fd=%d ev=%08x\n",
+              epfd, eph->occupied, fd, ev->events);
 
-          finfo("%08x CTL MOD(%d): fd=%d ev=%08x\n",
-                epfd, eph->occupied, fd, ev->events);
+        if (node == NULL)
+          {
+            ret = -ENOENT;
+            break;
+          }
+
+        epoll_disarm(node);
+        epoll_setup(node, ev);
+        ret = epoll_arm(node, false);
+        if (ret < 0)
+          {
+            epoll_disarm(node);
+          }
+        break;
+
+      default:
+        ret = -EINVAL;
+        break;
+    }
 
-          for (i = 0; i < eph->occupied; i++)
-            {
-              if (eph->poll[i].fd == fd)
-                {
-                  eph->data[i]        = ev->data;
-                  eph->poll[i].events = ev->events | POLLERR | POLLHUP;
-                  return 0;
-                }
-            }
+  nxsem_post(&eph->lock);
 
-          return -ENOENT;
-        }
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      return ERROR;
     }
 
-  return -EINVAL;
+  return OK;
 }
 
 /****************************************************************************
  * Name: epoll_pwait
+ *
+ * Description:
+ *   Wait for events on the file descriptors of an epoll instance.
+ *
+ * Input Parameters:
+ *   epfd      - The epoll instance
+ *   evs       - Location to return the events
+ *   maxevents - The maximum number of events to return
+ *   timeout   - The timeout in milliseconds; -1 waits forever
+ *   sigmask   - The signal mask to use while waiting (may be NULL)
+ *
+ * Returned Value:
+ *   The number of events returned in 'evs' or zero on a timeout.  On
+ *   failure, -1 (ERROR) is returned and the errno value is set
+ *   appropriately.
+ *
  ****************************************************************************/
 
 int epoll_pwait(int epfd, FAR struct epoll_event *evs,
@@ -232,76 +719,154 @@ int epoll_pwait(int epfd, FAR struct epoll_event *evs,
    */
 
   FAR struct epoll_head *eph = (FAR struct epoll_head *)((intptr_t)epfd);
-  int counter;
-  int rc;
-  int i;
+  sigset_t oldmask;
+  clock_t start;
+  clock_t ticks = 0;
+  int ret;
 
-  if (timeout < 0)
+  if (evs == NULL || maxevents <= 0)
     {
-      rc = ppoll(eph->poll, eph->occupied, NULL, sigmask);
+      set_errno(EINVAL);
+      return ERROR;
     }
-  else
+
+  /* epoll_pwait() is a cancellation point */
+
+  enter_cancellation_point();
+
+  if (sigmask != NULL)
     {
-      struct timespec timeout_ts;
+      nxsig_procmask(SIG_SETMASK, sigmask, &oldmask);
+    }
 
-      timeout_ts.tv_sec  = timeout / 1000;
-      timeout_ts.tv_nsec = timeout % 1000 * 1000;
+  /* Round the timeout up to the next full tick as in poll() */
 
-      rc = ppoll(eph->poll, eph->occupied, &timeout_ts, sigmask);
+  start = clock_systime_ticks();
+  if (timeout > 0)
+    {
+#if (MSEC_PER_TICK * USEC_PER_MSEC) != USEC_PER_TICK && \
+    defined(CONFIG_HAVE_LONG_LONG)
+      ticks = (((unsigned long long)timeout * USEC_PER_MSEC) +
+               (USEC_PER_TICK - 1)) /
+              USEC_PER_TICK;
+#else
+      ticks = ((unsigned int)timeout + (MSEC_PER_TICK - 1)) /
+              MSEC_PER_TICK;
+#endif
     }
 
-  if (rc <= 0)
+  for (; ; )
     {
-      if (rc < 0)
+      ret = nxsem_wait(&eph->lock);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      ret = epoll_collect(eph, evs, maxevents);
+      nxsem_post(&eph->lock);
+
+      if (ret > 0 || timeout == 0)
         {
-          ferr("ERROR: %08x poll fail: %d for %d, %d msecs\n",
-               epfd, rc, eph->occupied, timeout);
+          break;
+        }
+
+      /* Wait for the next notification.  The semaphore may also have
+       * been posted for nodes that were already reported, so go around
+       * and check the ready list again.
+       */
 
-          for (i = 0; i < eph->occupied; i++)
+      if (timeout > 0)
+        {
+          ret = nxsem_tickwait(&eph->sem, start, ticks);
+          if (ret == -ETIMEDOUT)
             {
-              ferr("  %02d: fd=%d\n", i, eph->poll[i].fd);
+              ret = 0;
+              break;
             }
         }
+      else
+        {
+          ret = nxsem_wait(&eph->sem);
+        }
 
-      return rc;
+      if (ret < 0)
+        {
+          break;
+        }
     }
 
-  /* Iterate over non NULL event fds */
-
-  if (rc > maxevents)
+  if (sigmask != NULL)
     {
-      rc = maxevents;
+      nxsig_procmask(SIG_SETMASK, &oldmask, NULL);
     }
 
-  for (i = 0, counter = 0; i < rc && counter < eph->occupied; counter++)
+  leave_cancellation_point();
+
+  if (ret < 0)
     {
-      if (eph->poll[counter].revents != 0)
-        {
-          evs[i].data     = eph->data[counter];
-          evs[i++].events = eph->poll[counter].revents;
-          if (eph->poll[counter].events & EPOLLONESHOT)
-            {
-              eph->poll[counter].events = 0; /* Disable oneshot internally */
-            }
-        }
+      ferr("ERROR: %08x wait failed: %d\n", epfd, ret);
+      set_errno(-ret);
+      return ERROR;
     }
 
-  return i;
+  return ret;
 }
 
 /****************************************************************************
  * Name: epoll_wait
  *
  * Description:
+ *   Equivalent to epoll_pwait() without a signal mask.
+ *
+ ****************************************************************************/
+
+int epoll_wait(int epfd, FAR struct epoll_event *evs,
+               int maxevents, int timeout)
+{
+  return epoll_pwait(epfd, evs, maxevents, timeout, NULL);
+}
+
+/****************************************************************************
+ * Name: epoll_remove
+ *
+ * Description:
+ *   Remove an open file or socket that is being closed from all epoll
+ *   instances that watch it.
  *
  * Input Parameters:
+ *   ptr - The struct file or struct socket being closed
  *
  * Returned Value:
+ *   None
  *
  ****************************************************************************/
 
-int epoll_wait(int epfd, FAR struct epoll_event *evs,
-               int maxevents, int timeout)
+void epoll_remove(FAR void *ptr)
 {
-  return epoll_pwait(epfd, evs, maxevents, timeout, NULL);
+  FAR struct epoll_head *eph;
+  int i;
+
+  nxsem_wait_uninterruptible(&g_epoll_lock);
+
+  for (eph = (FAR struct epoll_head *)sq_peek(&g_epoll_heads);
+       eph != NULL;
+       eph = (FAR struct epoll_head *)sq_next(&eph->link))
+    {
+      nxsem_wait_uninterruptible(&eph->lock);
+
+      for (i = 0; i < eph->size && eph->occupied > 0; i++)
+        {
+          if (eph->nodes[i].inuse && eph->nodes[i].ptr == ptr)
+            {
+              epoll_disarm(&eph->nodes[i]);
+              eph->nodes[i].inuse = false;
+              eph->occupied--;
+            }
+        }
+
+      nxsem_post(&eph->lock);
+    }
+
+  nxsem_post(&g_epoll_lock);
 }
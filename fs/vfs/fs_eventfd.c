@@ -169,7 +169,7 @@ static void eventfd_pollnotify(FAR struct eventfd_priv_s *dev,
 
           if (fds->revents != 0)
             {
-              nxsem_post(fds->sem);
+              poll_notify(fds);
             }
         }
     }
@@ -45,6 +45,7 @@
 #include <assert.h>
 #include <errno.h>
 
+#include <nuttx/irq.h>
 #include <nuttx/clock.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/cancelpt.h>
@@ -347,7 +348,7 @@ int file_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
               fds->revents |= (fds->events & (POLLIN | POLLOUT));
               if (fds->revents != 0)
                 {
-                  nxsem_post(fds->sem);
+                  poll_notify(fds);
                 }
             }
 
@@ -397,6 +398,50 @@ int fs_poll(int fd, FAR struct pollfd *fds, bool setup)
   return file_poll(filep, fds, setup);
 }
 
+/****************************************************************************
+ * Name: poll_notify
+ *
+ * Description:
+ *   Report the events that have been set in fds->revents to the poll
+ *   logic.  If fds->sem is the semaphore of a struct pollcb_s, the callback
+ *   is called.  Otherwise the semaphore is posted, unless it has already
+ *   been posted and not yet taken.  Drivers call this instead of posting
+ *   fds->sem directly.  This may be called from an interrupt handler.
+ *
+ * Input Parameters:
+ *   fds - The poll descriptor with pending events
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void poll_notify(FAR struct pollfd *fds)
+{
+  FAR struct pollcb_s *pcb;
+  irqstate_t flags;
+  int semcount;
+
+  /* Limit the number of times that the semaphore is posted.  The waiter
+   * only needs to know that there is something to look at.  The critical
+   * section is needed to make the following operation atomic.
+   */
+
+  flags = enter_critical_section();
+  nxsem_get_value(fds->sem, &semcount);
+  if (semcount == POLLCB_SEMCOUNT)
+    {
+      pcb = (FAR struct pollcb_s *)fds->sem;
+      pcb->pc_cb(pcb->pc_arg);
+    }
+  else if (semcount < 1)
+    {
+      poll_semgive(fds->sem);
+    }
+
+  leave_critical_section(flags);
+}
+
 /****************************************************************************
  * Name: nx_poll
  *
@@ -116,10 +116,20 @@
 #define LIO_NOWAIT      0
 #define LIO_WAIT        1
 
+/* Non-standard value of aio_sigevent.sigev_notify:  Completion of the
+ * request adds one to the counter of the eventfd whose descriptor is held
+ * in aio_sigevent.sigev_value.sival_int.
+ */
+
+#ifdef CONFIG_FS_AIO_EVENTFD
+#  define SIGEV_EVENTFD 4
+#endif
+
 /****************************************************************************
  * Type Definitions
  ****************************************************************************/
 
+struct file;
 struct aiocb
 {
   /* Standard fields required by POSIX */
@@ -143,6 +153,9 @@ struct aiocb
   struct sigwork_s aio_sigwork;  /* Signal work */
   volatile ssize_t aio_result;   /* Support for aio_error() and aio_return() */
   FAR void *aio_priv;            /* Used by signal handlers */
+#ifdef CONFIG_FS_AIO_EVENTFD
+  FAR struct file *aio_evfilep;  /* eventfd to notify (SIGEV_EVENTFD) */
+#endif
 };
 
 /****************************************************************************
@@ -101,6 +101,17 @@ int     mq_setattr(mqd_t mqdes, FAR const struct mq_attr *mq_stat,
                    FAR struct mq_attr *oldstat);
 int     mq_getattr(mqd_t mqdes, FAR struct mq_attr *mq_stat);
 
+/* Non-standard zero-copy extensions */
+
+#ifdef CONFIG_MQ_ZEROCOPY
+int     mq_alloc_buffer(mqd_t mqdes, FAR void **buffer);
+int     mq_send_buffer(mqd_t mqdes, FAR void *buffer, size_t msglen,
+                       unsigned int prio);
+ssize_t mq_receive_buffer(mqd_t mqdes, FAR void **buffer,
+                          FAR unsigned int *prio);
+void    mq_free_buffer(mqd_t mqdes, FAR void *buffer);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -32,6 +32,7 @@
 #include <stdarg.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <limits.h>
 #include <semaphore.h>
 
 #ifdef CONFIG_FS_NAMED_SEMAPHORES
@@ -192,6 +193,13 @@
 
 #define umount(t)       umount2(t,0)
 
+/* The count of the semaphore of a struct pollcb_s.  A semaphore that is
+ * used to wait for poll events never gets this far, because poll_notify()
+ * posts it only while its count is below one.
+ */
+
+#define POLLCB_SEMCOUNT SEM_VALUE_MAX
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -490,6 +498,26 @@ struct streamlist
 };
 #endif /* CONFIG_FILE_STREAM */
 
+/* Kernel logic that wants a callback, rather than a semaphore post, when
+ * events are reported on a poll descriptor points the sem field of the
+ * struct pollfd at the sem member of this structure.  struct pollfd is
+ * left unchanged so that its layout in user space stays the same, and a
+ * copy of the poll descriptor made by a driver still reaches the
+ * callback.  The semaphore is never waited on.  It must be initialized
+ * with the count POLLCB_SEMCOUNT, which is how poll_notify() tells it
+ * apart from an ordinary poll semaphore.  The callback may be called from
+ * an interrupt handler.
+ */
+
+typedef CODE void (*pollcb_t)(FAR void *arg);
+
+struct pollcb_s
+{
+  sem_t                   pc_sem;   /* Marks the structure, never waited on */
+  pollcb_t                pc_cb;    /* Called when events are reported */
+  FAR void               *pc_arg;   /* Argument of the callback */
+};
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -1399,6 +1427,44 @@ int file_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup);
 
 int fs_poll(int fd, FAR struct pollfd *fds, bool setup);
 
+/****************************************************************************
+ * Name: poll_notify
+ *
+ * Description:
+ *   Report the events that have been set in fds->revents to the poll
+ *   logic.  If fds->sem belongs to a struct pollcb_s, its callback is
+ *   called.  Otherwise the semaphore of the poll descriptor is posted.
+ *   Drivers call this instead of posting fds->sem directly.  This may be
+ *   called from an interrupt handler.
+ *
+ * Input Parameters:
+ *   fds - The poll descriptor with pending events
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void poll_notify(FAR struct pollfd *fds);
+
+/****************************************************************************
+ * Name: epoll_remove
+ *
+ * Description:
+ *   Remove an open file or socket that is being closed from all epoll
+ *   instances that watch it, as Linux does.  This is called by
+ *   file_close() and psock_close() before the driver is closed.
+ *
+ * Input Parameters:
+ *   ptr - The struct file or struct socket being closed
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void epoll_remove(FAR void *ptr);
+
 /****************************************************************************
  * Name: nx_poll
  *
@@ -140,7 +140,8 @@
 #define FIOC_MMAP       _FIOC(0x0001)     /* IN:  Location to return address (void **)
                                            * OUT: If media is directly accessible,
                                            *      return (void*) base address
-                                           *      of file
+                                           *      of file.  The file must not be
+                                           *      copied to make it accessible.
                                            */
 #define FIOC_REFORMAT   _FIOC(0x0002)     /* IN:  None
                                            * OUT: None
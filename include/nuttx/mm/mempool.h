@@ -0,0 +1,200 @@
+/****************************************************************************
+ * include/nuttx/mm/mempool.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_MM_MEMPOOL_H
+#define __INCLUDE_NUTTX_MM_MEMPOOL_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <queue.h>
+#include <semaphore.h>
+
+#ifdef CONFIG_MM_MEMPOOL
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* This structure describes one pool of fixed-size blocks.  The
+ * configuration fields must be set by the caller before mempool_init() is
+ * called.  All other fields are private to the memory pool logic.
+ */
+
+struct mempool_s
+{
+  /* Configuration */
+
+  size_t bsize;              /* Size of one block in bytes */
+  size_t ninitial;           /* Number of blocks allocated at init time */
+  size_t nexpand;            /* Number of blocks added when the pool is
+                              * empty.  Zero:  The pool never grows. */
+  bool interrupt;            /* True:  Blocks may be allocated and freed
+                              * from interrupt handlers */
+
+  /* Private data */
+
+  FAR const char *name;      /* Name shown in /proc/mempool */
+  sq_entry_t node;           /* Link in the list of all pools */
+  sq_queue_t freelist;       /* List of free blocks */
+  sq_queue_t chunklist;      /* List of memory chunks holding the blocks */
+  sem_t lock;                /* Mutual exclusion (thread-only pools) */
+  size_t ntotal;             /* Total number of blocks */
+  size_t nused;              /* Number of blocks in use */
+  size_t maxused;            /* High water mark of nused */
+  size_t nfail;              /* Number of failed allocations */
+};
+
+/* Statistics returned by mempool_info() */
+
+struct mempoolinfo_s
+{
+  size_t bsize;              /* Size of one block in bytes */
+  size_t ntotal;             /* Total number of blocks */
+  size_t nused;              /* Number of blocks in use */
+  size_t maxused;            /* High water mark of nused */
+  size_t nfail;              /* Number of failed allocations */
+};
+
+/* Callback used with mempool_foreach() */
+
+typedef CODE void (*mempool_handler_t)(FAR struct mempool_s *pool,
+                                       FAR void *arg);
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: mempool_init
+ *
+ * Description:
+ *   Initialize a memory pool.  The bsize, ninitial, nexpand and interrupt
+ *   fields of the pool structure must be set by the caller.  ninitial
+ *   blocks are allocated from the kernel heap.
+ *
+ * Input Parameters:
+ *   pool - The memory pool to initialize
+ *   name - The name of the pool as shown in /proc/mempool
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+int mempool_init(FAR struct mempool_s *pool, FAR const char *name);
+
+/****************************************************************************
+ * Name: mempool_alloc
+ *
+ * Description:
+ *   Allocate one block from the memory pool.  If the pool is empty, it is
+ *   grown by nexpand blocks, unless this is called from an interrupt
+ *   handler.
+ *
+ * Input Parameters:
+ *   pool - The memory pool to allocate from
+ *
+ * Returned Value:
+ *   The allocated block or NULL if no block is available.
+ *
+ ****************************************************************************/
+
+FAR void *mempool_alloc(FAR struct mempool_s *pool);
+
+/****************************************************************************
+ * Name: mempool_free
+ *
+ * Description:
+ *   Return a block to the memory pool that it was allocated from.
+ *
+ * Input Parameters:
+ *   pool - The memory pool
+ *   blk  - The block to free
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mempool_free(FAR struct mempool_s *pool, FAR void *blk);
+
+/****************************************************************************
+ * Name: mempool_deinit
+ *
+ * Description:
+ *   Release all memory held by a memory pool.  All blocks must have been
+ *   freed.
+ *
+ * Input Parameters:
+ *   pool - The memory pool to deinitialize
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; -EBUSY is returned if blocks of the
+ *   pool are still in use.
+ *
+ ****************************************************************************/
+
+int mempool_deinit(FAR struct mempool_s *pool);
+
+/****************************************************************************
+ * Name: mempool_info
+ *
+ * Description:
+ *   Return the usage statistics of a memory pool.
+ *
+ ****************************************************************************/
+
+void mempool_info(FAR struct mempool_s *pool,
+                  FAR struct mempoolinfo_s *info);
+
+/****************************************************************************
+ * Name: mempool_foreach
+ *
+ * Description:
+ *   Call 'handler' for each initialized memory pool.  This is used by the
+ *   procfs logic.
+ *
+ ****************************************************************************/
+
+void mempool_foreach(mempool_handler_t handler, FAR void *arg);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_MM_MEMPOOL */
+#endif /* __INCLUDE_NUTTX_MM_MEMPOOL_H */
@@ -163,6 +163,36 @@
 #define MM_IS_ALLOCATED(n) \
   ((int)((struct mm_allocnode_s*)(n)->preceding) < 0)
 
+/* Two-level segregated fit (TLSF) free lists.  The first level index
+ * selects a power-of-two size range and the second level index selects one
+ * of MM_TLSF_SLCOUNT linear subdivisions of that range.  Chunks smaller
+ * than (MM_TLSF_SLCOUNT << MM_MIN_SHIFT) bytes are kept in exact-size lists
+ * at first level index zero.  All chunks of MM_MAX_CHUNK bytes or more are
+ * kept in the single list of the last first level index.
+ */
+
+#ifdef CONFIG_MM_TLSF
+#  define MM_TLSF_SLI      CONFIG_MM_TLSF_SLI
+#  define MM_TLSF_SLCOUNT  (1 << MM_TLSF_SLI)
+#  define MM_TLSF_FLCOUNT  (MM_MAX_SHIFT - MM_MIN_SHIFT - MM_TLSF_SLI + 2)
+#endif
+
+/* Per-CPU small allocation cache.  Size class 'n' holds chunks of at least
+ * (MM_MIN_CHUNK << n) bytes, so MM_CPUCACHE_MAXCHUNK is the largest chunk
+ * size (including the allocated node header) that is served from the
+ * cache.
+ */
+
+#ifdef CONFIG_MM_CPUCACHE
+#  ifdef CONFIG_SMP
+#    define MM_CPUCACHE_NCPUS  CONFIG_SMP_NCPUS
+#  else
+#    define MM_CPUCACHE_NCPUS  1
+#  endif
+#  define MM_CPUCACHE_MAXCHUNK \
+     (MM_MIN_CHUNK << (CONFIG_MM_CPUCACHE_NCLASSES - 1))
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -214,6 +244,19 @@ struct mm_delaynode_s
   struct mm_delaynode_s *flink;
 };
 
+#ifdef CONFIG_MM_CPUCACHE
+/* This describes the small allocation cache of one CPU.  Cached chunks are
+ * still marked as allocated in the heap and are linked through their
+ * payload, just like the entries of the delay list.
+ */
+
+struct mm_cpucache_s
+{
+  FAR struct mm_delaynode_s *mc_list[CONFIG_MM_CPUCACHE_NCLASSES];
+  uint16_t mc_count[CONFIG_MM_CPUCACHE_NCLASSES];
+};
+#endif
+
 /* What is the size of the freenode? */
 
 #define MM_PTR_SIZE sizeof(FAR struct mm_freenode_s *)
@@ -247,16 +290,34 @@ struct mm_heap_s
   int mm_nregions;
 #endif
 
+#ifdef CONFIG_MM_TLSF
+  /* All free nodes are maintained in segregated doubly linked lists.  The
+   * bitmaps record which of the lists are not empty.
+   */
+
+  uint32_t mm_flbitmap;
+  uint32_t mm_slbitmap[MM_TLSF_FLCOUNT];
+  FAR struct mm_freenode_s *mm_freelist[MM_TLSF_FLCOUNT][MM_TLSF_SLCOUNT];
+#else
   /* All free nodes are maintained in a doubly linked list.  This
    * array provides some hooks into the list at various points to
    * speed searches for free nodes.
    */
 
   struct mm_freenode_s mm_nodelist[MM_NNODES];
+#endif
 
   /* Free delay list, for some situation can't do free immdiately */
 
   struct mm_delaynode_s *mm_delaylist;
+
+#ifdef CONFIG_MM_CPUCACHE
+  /* Small chunks cached on each CPU.  These are accessed only with local
+   * interrupts disabled and without the MM semaphore.
+   */
+
+  struct mm_cpucache_s mm_cpucache[MM_CPUCACHE_NCPUS];
+#endif
 };
 
 /****************************************************************************
@@ -360,6 +421,7 @@ void kmm_givesemaphore(void);
 /* Functions contained in mm_malloc.c ***************************************/
 
 FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size);
+FAR void *mm_mallocchunk(FAR struct mm_heap_s *heap, size_t alignsize);
 
 /* Functions contained in kmm_malloc.c **************************************/
 
@@ -370,6 +432,7 @@ FAR void *kmm_malloc(size_t size);
 /* Functions contained in mm_free.c *****************************************/
 
 void mm_free(FAR struct mm_heap_s *heap, FAR void *mem);
+void mm_freechunk(FAR struct mm_heap_s *heap, FAR void *mem);
 
 /* Functions contained in kmm_free.c ****************************************/
 
@@ -497,10 +560,33 @@ void mm_shrinkchunk(FAR struct mm_heap_s *heap,
 void mm_addfreechunk(FAR struct mm_heap_s *heap,
                      FAR struct mm_freenode_s *node);
 
+/* Functions contained in mm_delfreechunk.c *********************************/
+
+void mm_delfreechunk(FAR struct mm_heap_s *heap,
+                     FAR struct mm_freenode_s *node);
+
 /* Functions contained in mm_size2ndx.c.c ***********************************/
 
 int mm_size2ndx(size_t size);
 
+/* Functions contained in mm_tlsf.c *****************************************/
+
+#ifdef CONFIG_MM_TLSF
+void mm_tlsf_mapping(size_t size, FAR int *fl, FAR int *sl);
+FAR struct mm_freenode_s *mm_tlsf_search(FAR struct mm_heap_s *heap,
+                                         size_t size);
+#endif
+
+/* Functions contained in mm_cpucache.c *************************************/
+
+#ifdef CONFIG_MM_CPUCACHE
+void mm_cpucache_initialize(FAR struct mm_heap_s *heap);
+FAR void *mm_cpucache_malloc(FAR struct mm_heap_s *heap, size_t alignsize);
+bool mm_cpucache_free(FAR struct mm_heap_s *heap, FAR void *mem);
+void mm_cpucache_trim(FAR struct mm_heap_s *heap);
+void mm_cpucache_flush(FAR struct mm_heap_s *heap);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -117,6 +117,13 @@ struct mqueue_inode_s
   pid_t ntpid;                /* Notification: Receiving Task's PID */
   struct sigevent ntevent;    /* Notification description */
   struct sigwork_s ntwork;    /* Notification work */
+#ifdef CONFIG_MQ_MSGPOOL
+  sq_queue_t msgfree;         /* Free messages of the message pool */
+  FAR void *msgpool;          /* The messages allocated with the queue */
+#endif
+#ifdef CONFIG_MQ_ZEROCOPY
+  int16_t nloaned;            /* Number of message buffers on loan */
+#endif
 };
 
 /* This describes the message queue descriptor that is held in the
@@ -382,6 +389,108 @@ ssize_t nxmq_timedreceive(mqd_t mqdes, FAR char *msg, size_t msglen,
                           FAR unsigned int *prio,
                           FAR const struct timespec *abstime);
 
+/****************************************************************************
+ * Name: nxmq_alloc_buffer
+ *
+ * Description:
+ *   Loan a message buffer from the message queue.  The caller may fill up
+ *   to mq_msgsize bytes of the buffer and then pass it to
+ *   nxmq_send_buffer() so that the message is sent without being copied.
+ *   A buffer that is not sent must be returned with nxmq_free_buffer().
+ *
+ *   All loaned buffers must be returned before the message queue is
+ *   destroyed.
+ *
+ * Input Parameters:
+ *   mqdes  - Message queue descriptor
+ *   buffer - The location to return the buffer
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned
+ *   on failure:
+ *
+ *   EINVAL   Either buffer or mqdes is NULL.
+ *   EPERM    Message queue opened not opened for writing.
+ *   ENOMEM   No message buffer is available.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MQ_ZEROCOPY
+int nxmq_alloc_buffer(mqd_t mqdes, FAR void **buffer);
+#endif
+
+/****************************************************************************
+ * Name: nxmq_send_buffer
+ *
+ * Description:
+ *   Send a message buffer that was loaned with nxmq_alloc_buffer().  This
+ *   behaves like nxmq_send() except that the message data is not copied.
+ *   The buffer belongs to the message queue if the message is sent.
+ *   Otherwise, the caller still owns it.
+ *
+ * Input Parameters:
+ *   mqdes  - Message queue descriptor
+ *   buffer - The message buffer that holds the message
+ *   msglen - The length of the message in bytes
+ *   prio   - The priority of the message
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned
+ *   on failure (see mq_send() for the list list valid return values).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MQ_ZEROCOPY
+int nxmq_send_buffer(mqd_t mqdes, FAR void *buffer, size_t msglen,
+                     unsigned int prio);
+#endif
+
+/****************************************************************************
+ * Name: nxmq_receive_buffer
+ *
+ * Description:
+ *   Receive the oldest of the highest priority messages from the message
+ *   queue without copying it.  This behaves like nxmq_receive() except that
+ *   a pointer to the message buffer is returned.  The caller owns the
+ *   buffer and must return it with nxmq_free_buffer().
+ *
+ * Input Parameters:
+ *   mqdes  - Message Queue Descriptor
+ *   buffer - The location to return the message buffer
+ *   prio   - If not NULL, the location to store message priority.
+ *
+ * Returned Value:
+ *   The length of the message is returned on success.  A negated errno
+ *   value is returned on failure (see mq_receive() for the list list valid
+ *   return values).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MQ_ZEROCOPY
+ssize_t nxmq_receive_buffer(mqd_t mqdes, FAR void **buffer,
+                            FAR unsigned int *prio);
+#endif
+
+/****************************************************************************
+ * Name: nxmq_free_buffer
+ *
+ * Description:
+ *   Return a message buffer obtained from nxmq_alloc_buffer() or
+ *   nxmq_receive_buffer() to the message queue.
+ *
+ * Input Parameters:
+ *   mqdes  - Message Queue Descriptor
+ *   buffer - The message buffer
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MQ_ZEROCOPY
+void nxmq_free_buffer(mqd_t mqdes, FAR void *buffer);
+#endif
+
 /****************************************************************************
  * Name: nxmq_free_msgq
  *
@@ -85,6 +85,9 @@ struct mtd_smart_procfs_data_s
   uint8_t             formatversion;    /* Version of the volume format */
   uint32_t            unusedsectors;    /* Number of unused sectors (free when erased) */
   uint32_t            blockerases;      /* Number block erase operations */
+  uint32_t            gcblocks;         /* Blocks collected in the write path */
+  uint32_t            bggcblocks;       /* Blocks collected in the background */
+  uint32_t            relocsectors;     /* Number of sectors relocated */
 
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
   FAR const uint8_t*  erasecounts;      /* Array of erase counts per erase block */
@@ -35,6 +35,10 @@
 #include <semaphore.h>
 #include <queue.h>
 
+#ifdef CONFIG_NET_FINE_LOCKING
+#  include <nuttx/mutex.h>
+#endif
+
 #ifdef CONFIG_MM_IOB
 #  include <nuttx/mm/iob.h>
 #endif
@@ -361,8 +365,35 @@ void net_initialize(void);
  *                       momentarily to wait for an IOB to become
  *                       available.
  *
+ * With CONFIG_NET_FINE_LOCKING, some data structures are also protected by
+ * a lock of their own (a connection table, the read-ahead buffers of a
+ * connection, ...):
+ *
+ *   net_finelock()    - Locks one such data structure.
+ *   net_fineunlock()  - Unlocks it.
+ *
+ * These locks are always the innermost locks:  They may be taken while the
+ * network lock is held but the network lock (or another fine-grained lock)
+ * must never be taken while holding one, and the holder must not wait for
+ * anything.  Without CONFIG_NET_FINE_LOCKING, all of them are the network
+ * lock itself.
+ *
  ****************************************************************************/
 
+#ifdef CONFIG_NET_FINE_LOCKING
+typedef mutex_t net_finelock_t;
+
+#  define net_finelock_init(l)    nxmutex_init(l)
+#  define net_finelock_destroy(l) nxmutex_destroy(l)
+#  define net_finelock(l)         nxmutex_lock(l)
+#  define net_fineunlock(l)       nxmutex_unlock(l)
+#else
+#  define net_finelock_init(l)
+#  define net_finelock_destroy(l)
+#  define net_finelock(l)         net_lock()
+#  define net_fineunlock(l)       net_unlock()
+#endif
+
 /****************************************************************************
  * Name: net_lock
  *
@@ -0,0 +1,107 @@
+/****************************************************************************
+ * include/nuttx/note/notepcpu_driver.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_NOTE_NOTEPCPU_DRIVER_H
+#define __INCLUDE_NUTTX_NOTE_NOTEPCPU_DRIVER_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The stream read from /dev/note begins with a struct notepcpu_header_s.
+ * It is followed by any number of records, each consisting of a struct
+ * notepcpu_record_s immediately followed by the note itself (the note
+ * length is in the first byte of the note).  All multi-byte values are
+ * little endian.  tools/note2json.c converts this stream into the Chrome
+ * trace event format.
+ */
+
+#define NOTEPCPU_MAGIC0      'N'
+#define NOTEPCPU_MAGIC1      'X'
+#define NOTEPCPU_MAGIC2      'N'
+#define NOTEPCPU_MAGIC3      'T'
+#define NOTEPCPU_VERSION     1
+
+/* Values of the nh_flags field of the stream header */
+
+#define NOTEPCPU_FLAG_SMP    (1 << 0) /* Notes include the nc_cpu field */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Header at the beginning of the stream */
+
+struct notepcpu_header_s
+{
+  uint8_t nh_magic[4];         /* NOTEPCPU_MAGIC0-3 */
+  uint8_t nh_version;          /* NOTEPCPU_VERSION */
+  uint8_t nh_ncpus;            /* Number of CPUs */
+  uint8_t nh_flags;            /* See NOTEPCPU_FLAG_* definitions */
+  uint8_t nh_reserved;
+};
+
+/* Header that precedes each note in the stream */
+
+struct notepcpu_record_s
+{
+  uint8_t nr_cpu;              /* CPU that generated the note */
+  uint8_t nr_reserved;
+  uint8_t nr_dropped[2];       /* Notes lost on this CPU before this one */
+  uint8_t nr_sec[4];           /* Time of the note (seconds) */
+  uint8_t nr_nsec[4];          /* Time of the note (nanoseconds) */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#if defined(__KERNEL__) || defined(CONFIG_BUILD_FLAT)
+
+/****************************************************************************
+ * Name: notepcpu_register
+ *
+ * Description:
+ *   Register the per-CPU RAM note driver at /dev/note that can be used by
+ *   an application to read the merged note streams of all CPUs.
+ *
+ * Input Parameters:
+ *   None.
+ *
+ * Returned Value:
+ *   Zero on success. A negated errno value is returned on a failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRIVER_NOTEPCPU
+int notepcpu_register(void);
+#endif
+
+#endif /* defined(__KERNEL__) || defined(CONFIG_BUILD_FLAT) */
+
+#endif /* __INCLUDE_NUTTX_NOTE_NOTEPCPU_DRIVER_H */
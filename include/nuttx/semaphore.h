@@ -87,6 +87,22 @@
 #  define _SEM_ERRVAL(r)        (-errno)
 #endif
 
+/* Increment or decrement the count of a semaphore and return the previous
+ * count.  With CONFIG_SEM_FASTPATH, the semaphore count may be changed
+ * outside of the critical section, so logic that adjusts the count
+ * directly must do so atomically, even in a critical section.
+ */
+
+#ifdef CONFIG_SEM_FASTPATH
+#  define NXSEM_COUNT_INC(s) \
+     __atomic_fetch_add(&(s)->semcount, 1, __ATOMIC_ACQ_REL)
+#  define NXSEM_COUNT_DEC(s) \
+     __atomic_fetch_sub(&(s)->semcount, 1, __ATOMIC_ACQ_REL)
+#else
+#  define NXSEM_COUNT_INC(s)    ((s)->semcount++)
+#  define NXSEM_COUNT_DEC(s)    ((s)->semcount--)
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
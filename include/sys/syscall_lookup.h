@@ -341,6 +341,12 @@ SYSCALL_LOOKUP(telldir,                    1)
   SYSCALL_LOOKUP(mq_timedreceive,          5)
   SYSCALL_LOOKUP(mq_timedsend,             5)
   SYSCALL_LOOKUP(mq_unlink,                1)
+#ifdef CONFIG_MQ_ZEROCOPY
+  SYSCALL_LOOKUP(mq_alloc_buffer,          2)
+  SYSCALL_LOOKUP(mq_free_buffer,           2)
+  SYSCALL_LOOKUP(mq_receive_buffer,        3)
+  SYSCALL_LOOKUP(mq_send_buffer,           4)
+#endif
 #endif
 
 /* The following are defined only if environment variables are supported */
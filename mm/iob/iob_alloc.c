@@ -175,11 +175,11 @@ static FAR struct iob_s *iob_allocwait(bool throttled,
             {
               if (throttled)
                 {
-                  g_iob_sem.semcount--;
+                  NXSEM_COUNT_DEC(&g_iob_sem);
                 }
               else
                 {
-                  g_throttle_sem.semcount--;
+                  NXSEM_COUNT_DEC(&g_throttle_sem);
                 }
             }
 #endif
@@ -274,7 +274,7 @@ FAR struct iob_s *iob_tryalloc(bool throttled, enum iob_user_e consumerid)
            * so a simple decrement is all that is needed.
            */
 
-          g_iob_sem.semcount--;
+          NXSEM_COUNT_DEC(&g_iob_sem);
           DEBUGASSERT(g_iob_sem.semcount >= 0);
 
 #if CONFIG_IOB_THROTTLE > 0
@@ -282,7 +282,7 @@ FAR struct iob_s *iob_tryalloc(bool throttled, enum iob_user_e consumerid)
            * it can be negative!  Decrementing is still safe, however.
            */
 
-          g_throttle_sem.semcount--;
+          NXSEM_COUNT_DEC(&g_throttle_sem);
           DEBUGASSERT(g_throttle_sem.semcount >= -CONFIG_IOB_THROTTLE);
 #endif
 
@@ -0,0 +1,368 @@
+/****************************************************************************
+ * mm/mempool/mempool.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/nuttx.h>
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/mm/mempool.h>
+
+/* The memory pools use kernel locks and the kernel heap.  In the PROTECTED
+ * and KERNEL builds they are only built into the kernel.
+ */
+
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* All blocks are aligned to MEMPOOL_ALIGN bytes.  Each chunk of blocks
+ * allocated from the kernel heap begins with a header that links it into
+ * the chunk list of the pool.
+ */
+
+#define MEMPOOL_ALIGN        8
+#define MEMPOOL_ALIGN_MASK   (MEMPOOL_ALIGN - 1)
+#define MEMPOOL_ALIGN_UP(n)  (((n) + MEMPOOL_ALIGN_MASK) & ~MEMPOOL_ALIGN_MASK)
+#define MEMPOOL_CHUNKHDR     MEMPOOL_ALIGN_UP(sizeof(sq_entry_t))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The list of all initialized pools (for procfs) */
+
+static sq_queue_t g_mempool_list;
+static sem_t g_mempool_sem = SEM_INITIALIZER(1);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mempool_lock and mempool_unlock
+ *
+ * Description:
+ *   Get exclusive access to the pool.  Pools that may be used from
+ *   interrupt handlers are protected with a critical section; all other
+ *   pools are protected with a semaphore.
+ *
+ ****************************************************************************/
+
+static irqstate_t mempool_lock(FAR struct mempool_s *pool)
+{
+  if (pool->interrupt)
+    {
+      return enter_critical_section();
+    }
+
+  nxsem_wait_uninterruptible(&pool->lock);
+  return 0;
+}
+
+static void mempool_unlock(FAR struct mempool_s *pool, irqstate_t flags)
+{
+  if (pool->interrupt)
+    {
+      leave_critical_section(flags);
+    }
+  else
+    {
+      nxsem_post(&pool->lock);
+    }
+}
+
+/****************************************************************************
+ * Name: mempool_expand
+ *
+ * Description:
+ *   Allocate a chunk of 'nblocks' blocks from the kernel heap and add them
+ *   to the free list of the pool.  The caller must not hold the pool lock.
+ *
+ ****************************************************************************/
+
+static int mempool_expand(FAR struct mempool_s *pool, size_t nblocks)
+{
+  FAR char *chunk;
+  FAR char *blk;
+  sq_queue_t blocks;
+  irqstate_t flags;
+  size_t i;
+
+  chunk = kmm_malloc(MEMPOOL_CHUNKHDR + nblocks * pool->bsize);
+  if (chunk == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* Link the new blocks together before taking the lock */
+
+  sq_init(&blocks);
+  for (i = 0, blk = chunk + MEMPOOL_CHUNKHDR; i < nblocks;
+       i++, blk += pool->bsize)
+    {
+      sq_addlast((FAR sq_entry_t *)blk, &blocks);
+    }
+
+  flags = mempool_lock(pool);
+  sq_addlast((FAR sq_entry_t *)chunk, &pool->chunklist);
+  sq_cat(&blocks, &pool->freelist);
+  pool->ntotal += nblocks;
+  mempool_unlock(pool, flags);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mempool_init
+ *
+ * Description:
+ *   Initialize a memory pool.  The bsize, ninitial, nexpand and interrupt
+ *   fields of the pool structure must be set by the caller.  ninitial
+ *   blocks are allocated from the kernel heap.
+ *
+ ****************************************************************************/
+
+int mempool_init(FAR struct mempool_s *pool, FAR const char *name)
+{
+  int ret;
+
+  DEBUGASSERT(pool != NULL && pool->bsize > 0);
+
+  /* Each free block must be able to hold the free list link */
+
+  if (pool->bsize < sizeof(sq_entry_t))
+    {
+      pool->bsize = sizeof(sq_entry_t);
+    }
+
+  pool->bsize   = MEMPOOL_ALIGN_UP(pool->bsize);
+  pool->name    = name;
+  pool->ntotal  = 0;
+  pool->nused   = 0;
+  pool->maxused = 0;
+  pool->nfail   = 0;
+
+  sq_init(&pool->freelist);
+  sq_init(&pool->chunklist);
+  nxsem_init(&pool->lock, 0, 1);
+
+  if (pool->ninitial > 0)
+    {
+      ret = mempool_expand(pool, pool->ninitial);
+      if (ret < 0)
+        {
+          merr("ERROR: Failed to allocate %s pool: %d\n", name, ret);
+          nxsem_destroy(&pool->lock);
+          return ret;
+        }
+    }
+
+  /* Make the pool visible in /proc/mempool */
+
+  nxsem_wait_uninterruptible(&g_mempool_sem);
+  sq_addlast(&pool->node, &g_mempool_list);
+  nxsem_post(&g_mempool_sem);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mempool_alloc
+ *
+ * Description:
+ *   Allocate one block from the memory pool.  If the pool is empty, it is
+ *   grown by nexpand blocks, unless this is called from an interrupt
+ *   handler.
+ *
+ ****************************************************************************/
+
+FAR void *mempool_alloc(FAR struct mempool_s *pool)
+{
+  FAR sq_entry_t *blk;
+  irqstate_t flags;
+  int ret;
+
+  DEBUGASSERT(pool != NULL);
+  DEBUGASSERT(pool->interrupt || !up_interrupt_context());
+
+  flags = mempool_lock(pool);
+  while ((blk = sq_remfirst(&pool->freelist)) == NULL)
+    {
+      /* The pool is empty.  Fixed-size pools cannot grow and the heap
+       * cannot be used from interrupt handlers.
+       */
+
+      if (pool->nexpand == 0 || up_interrupt_context())
+        {
+          break;
+        }
+
+      mempool_unlock(pool, flags);
+      ret   = mempool_expand(pool, pool->nexpand);
+      flags = mempool_lock(pool);
+
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  if (blk != NULL)
+    {
+      pool->nused++;
+      if (pool->nused > pool->maxused)
+        {
+          pool->maxused = pool->nused;
+        }
+    }
+  else
+    {
+      pool->nfail++;
+    }
+
+  mempool_unlock(pool, flags);
+  return blk;
+}
+
+/****************************************************************************
+ * Name: mempool_free
+ *
+ * Description:
+ *   Return a block to the memory pool that it was allocated from.
+ *
+ ****************************************************************************/
+
+void mempool_free(FAR struct mempool_s *pool, FAR void *blk)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(pool != NULL && blk != NULL);
+  DEBUGASSERT(pool->interrupt || !up_interrupt_context());
+
+  flags = mempool_lock(pool);
+
+  DEBUGASSERT(pool->nused > 0);
+  sq_addfirst((FAR sq_entry_t *)blk, &pool->freelist);
+  pool->nused--;
+
+  mempool_unlock(pool, flags);
+}
+
+/****************************************************************************
+ * Name: mempool_deinit
+ *
+ * Description:
+ *   Release all memory held by a memory pool.  All blocks must have been
+ *   freed.
+ *
+ ****************************************************************************/
+
+int mempool_deinit(FAR struct mempool_s *pool)
+{
+  FAR sq_entry_t *chunk;
+
+  DEBUGASSERT(pool != NULL);
+
+  if (pool->nused > 0)
+    {
+      return -EBUSY;
+    }
+
+  nxsem_wait_uninterruptible(&g_mempool_sem);
+  sq_rem(&pool->node, &g_mempool_list);
+  nxsem_post(&g_mempool_sem);
+
+  while ((chunk = sq_remfirst(&pool->chunklist)) != NULL)
+    {
+      kmm_free(chunk);
+    }
+
+  sq_init(&pool->freelist);
+  pool->ntotal = 0;
+  nxsem_destroy(&pool->lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mempool_info
+ *
+ * Description:
+ *   Return the usage statistics of a memory pool.
+ *
+ ****************************************************************************/
+
+void mempool_info(FAR struct mempool_s *pool, FAR struct mempoolinfo_s *info)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(pool != NULL && info != NULL);
+
+  flags = mempool_lock(pool);
+  info->bsize   = pool->bsize;
+  info->ntotal  = pool->ntotal;
+  info->nused   = pool->nused;
+  info->maxused = pool->maxused;
+  info->nfail   = pool->nfail;
+  mempool_unlock(pool, flags);
+}
+
+/****************************************************************************
+ * Name: mempool_foreach
+ *
+ * Description:
+ *   Call 'handler' for each initialized memory pool.  This is used by the
+ *   procfs logic.
+ *
+ ****************************************************************************/
+
+void mempool_foreach(mempool_handler_t handler, FAR void *arg)
+{
+  FAR sq_entry_t *node;
+
+  nxsem_wait_uninterruptible(&g_mempool_sem);
+
+  for (node = sq_peek(&g_mempool_list); node != NULL; node = sq_next(node))
+    {
+      handler(container_of(node, struct mempool_s, node), arg);
+    }
+
+  nxsem_post(&g_mempool_sem);
+}
+
+#endif /* CONFIG_BUILD_FLAT || __KERNEL__ */
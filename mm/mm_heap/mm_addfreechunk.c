@@ -58,6 +58,33 @@
 
 void mm_addfreechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node)
 {
+#ifdef CONFIG_MM_TLSF
+  FAR struct mm_freenode_s *next;
+  int fl;
+  int sl;
+
+  DEBUGASSERT(node->size >= SIZEOF_MM_FREENODE);
+  DEBUGASSERT((node->preceding & MM_ALLOC_BIT) == 0);
+
+  /* Convert the size to segregated list indices and put the new node at
+   * the head of that list.  The lists are not sorted.
+   */
+
+  mm_tlsf_mapping(node->size, &fl, &sl);
+
+  next        = heap->mm_freelist[fl][sl];
+  node->blink = NULL;
+  node->flink = next;
+
+  if (next)
+    {
+      next->blink = node;
+    }
+
+  heap->mm_freelist[fl][sl] = node;
+  heap->mm_slbitmap[fl]    |= (1 << sl);
+  heap->mm_flbitmap        |= (1 << fl);
+#else
   FAR struct mm_freenode_s *next;
   FAR struct mm_freenode_s *prev;
   int ndx;
@@ -87,4 +114,5 @@ void mm_addfreechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node)
 
       next->blink = node;
     }
+#endif
 }
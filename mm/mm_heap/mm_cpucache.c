@@ -0,0 +1,339 @@
+/****************************************************************************
+ * mm/mm_heap/mm_cpucache.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/mm/mm.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if CONFIG_MM_CPUCACHE_BATCH > CONFIG_MM_CPUCACHE_DEPTH
+#  error CONFIG_MM_CPUCACHE_BATCH must not exceed CONFIG_MM_CPUCACHE_DEPTH
+#endif
+
+#ifdef CONFIG_SMP
+#  define mm_cpucache_this(h) (&(h)->mm_cpucache[up_cpu_index()])
+#else
+#  define mm_cpucache_this(h) (&(h)->mm_cpucache[0])
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_cpucache_pop
+ *
+ * Description:
+ *   Remove one chunk of size class 'ndx' from the cache of this CPU.
+ *   Returns NULL if the cache for that size class is empty.
+ *
+ ****************************************************************************/
+
+static FAR void *mm_cpucache_pop(FAR struct mm_heap_s *heap, int ndx)
+{
+  FAR struct mm_cpucache_s *cache;
+  FAR struct mm_delaynode_s *node;
+  irqstate_t flags;
+
+  /* Disabling local interrupts is sufficient:  The cache is never accessed
+   * by any other CPU and this task cannot be preempted or migrated.
+   */
+
+  flags = up_irq_save();
+
+  cache = mm_cpucache_this(heap);
+  node  = cache->mc_list[ndx];
+  if (node != NULL)
+    {
+      cache->mc_list[ndx] = node->flink;
+      cache->mc_count[ndx]--;
+    }
+
+  up_irq_restore(flags);
+  return node;
+}
+
+/****************************************************************************
+ * Name: mm_cpucache_push
+ *
+ * Description:
+ *   Add one chunk of size class 'ndx' to the cache of this CPU.  Returns
+ *   false if the cache for that size class is already full.
+ *
+ ****************************************************************************/
+
+static bool mm_cpucache_push(FAR struct mm_heap_s *heap, int ndx,
+                             FAR void *mem)
+{
+  FAR struct mm_cpucache_s *cache;
+  FAR struct mm_delaynode_s *node = mem;
+  irqstate_t flags;
+  bool ret = false;
+
+  flags = up_irq_save();
+
+  cache = mm_cpucache_this(heap);
+  if (cache->mc_count[ndx] < CONFIG_MM_CPUCACHE_DEPTH)
+    {
+      node->flink         = cache->mc_list[ndx];
+      cache->mc_list[ndx] = node;
+      cache->mc_count[ndx]++;
+      ret = true;
+    }
+
+  up_irq_restore(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mm_cpucache_release
+ *
+ * Description:
+ *   Return cached chunks of this CPU to the heap free lists.  Every size
+ *   class holding at least 'limit' chunks is reduced to 'keep' chunks.
+ *
+ * Assumptions:
+ *   The caller holds the MM semaphore.
+ *
+ ****************************************************************************/
+
+static void mm_cpucache_release(FAR struct mm_heap_s *heap, int limit,
+                                int keep)
+{
+  FAR struct mm_cpucache_s *cache;
+  FAR struct mm_delaynode_s *list;
+  FAR struct mm_delaynode_s *node;
+  irqstate_t flags;
+  int ndx;
+
+  for (ndx = 0; ndx < CONFIG_MM_CPUCACHE_NCLASSES; ndx++)
+    {
+      /* Detach the batch with interrupts disabled ... */
+
+      list  = NULL;
+      flags = up_irq_save();
+
+      cache = mm_cpucache_this(heap);
+      if (cache->mc_count[ndx] >= limit)
+        {
+          while (cache->mc_count[ndx] > keep)
+            {
+              node                = cache->mc_list[ndx];
+              cache->mc_list[ndx] = node->flink;
+              cache->mc_count[ndx]--;
+
+              node->flink         = list;
+              list                = node;
+            }
+        }
+
+      up_irq_restore(flags);
+
+      /* ... then merge it back into the heap with interrupts enabled */
+
+      while (list != NULL)
+        {
+          node = list;
+          list = list->flink;
+
+          mm_freechunk(heap, node);
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_cpucache_initialize
+ *
+ * Description:
+ *   Initialize the (empty) small allocation caches of all CPUs.
+ *
+ ****************************************************************************/
+
+void mm_cpucache_initialize(FAR struct mm_heap_s *heap)
+{
+  memset(heap->mm_cpucache, 0, sizeof(heap->mm_cpucache));
+}
+
+/****************************************************************************
+ * Name: mm_cpucache_malloc
+ *
+ * Description:
+ *   Allocate a chunk of at least 'alignsize' bytes (including the allocated
+ *   node header) from the cache of this CPU.  On a cache miss, the MM
+ *   semaphore is taken once and the cache is refilled with a batch of
+ *   chunks of the size class.
+ *
+ *   Chunks are allocated with the full size of their size class so that
+ *   they return to the same size class when they are freed.
+ *
+ ****************************************************************************/
+
+FAR void *mm_cpucache_malloc(FAR struct mm_heap_s *heap, size_t alignsize)
+{
+  FAR void *chunk;
+  FAR void *ret;
+  size_t chunksize;
+  int ndx;
+  int i;
+
+  /* Get the smallest size class whose chunks all satisfy the request */
+
+  ndx = mm_size2ndx(alignsize);
+  if (alignsize > (MM_MIN_CHUNK << ndx))
+    {
+      ndx++;
+    }
+
+  DEBUGASSERT(ndx < CONFIG_MM_CPUCACHE_NCLASSES);
+
+  ret = mm_cpucache_pop(heap, ndx);
+  if (ret != NULL)
+    {
+      return ret;
+    }
+
+  /* Cache miss.  Refill from the heap free lists */
+
+  chunksize = MM_MIN_CHUNK << ndx;
+
+  mm_takesemaphore(heap);
+
+  ret = mm_mallocchunk(heap, chunksize);
+  if (ret != NULL)
+    {
+      for (i = 1; i < CONFIG_MM_CPUCACHE_BATCH; i++)
+        {
+          chunk = mm_mallocchunk(heap, chunksize);
+          if (chunk == NULL)
+            {
+              break;
+            }
+
+          if (!mm_cpucache_push(heap, ndx, chunk))
+            {
+              mm_freechunk(heap, chunk);
+              break;
+            }
+        }
+    }
+  else
+    {
+      /* The heap may be exhausted because of the chunks cached on this
+       * CPU.  Give them back and retry with the exact size.
+       */
+
+      mm_cpucache_flush(heap);
+      ret = mm_mallocchunk(heap, alignsize);
+    }
+
+  mm_givesemaphore(heap);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mm_cpucache_free
+ *
+ * Description:
+ *   Try to add a freed chunk to the cache of this CPU.  Returns false if
+ *   the chunk is too large to be cached or if the cache for its size class
+ *   is full.  In that case the caller must free the chunk to the heap and
+ *   call mm_cpucache_trim().
+ *
+ *   This may be called from interrupt level logic.
+ *
+ ****************************************************************************/
+
+bool mm_cpucache_free(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+  FAR struct mm_allocnode_s *node;
+  int ndx;
+
+  DEBUGASSERT(mm_heapmember(heap, mem));
+
+  node = (FAR struct mm_allocnode_s *)
+         ((FAR char *)mem - SIZEOF_MM_ALLOCNODE);
+
+  /* Sanity check against double-frees */
+
+  DEBUGASSERT(node->preceding & MM_ALLOC_BIT);
+
+  /* Size class 'ndx' holds chunks with sizes in the range
+   * [MM_MIN_CHUNK << ndx, MM_MIN_CHUNK << (ndx + 1))
+   */
+
+  ndx = mm_size2ndx(node->size);
+  if (ndx >= CONFIG_MM_CPUCACHE_NCLASSES)
+    {
+      return false;
+    }
+
+  return mm_cpucache_push(heap, ndx, mem);
+}
+
+/****************************************************************************
+ * Name: mm_cpucache_trim
+ *
+ * Description:
+ *   Return a batch of CONFIG_MM_CPUCACHE_BATCH chunks from each full size
+ *   class of this CPU to the heap free lists.
+ *
+ * Assumptions:
+ *   The caller holds the MM semaphore.
+ *
+ ****************************************************************************/
+
+void mm_cpucache_trim(FAR struct mm_heap_s *heap)
+{
+  mm_cpucache_release(heap, CONFIG_MM_CPUCACHE_DEPTH,
+                      CONFIG_MM_CPUCACHE_DEPTH - CONFIG_MM_CPUCACHE_BATCH);
+}
+
+/****************************************************************************
+ * Name: mm_cpucache_flush
+ *
+ * Description:
+ *   Return all chunks cached on this CPU to the heap free lists.
+ *
+ * Assumptions:
+ *   The caller holds the MM semaphore.
+ *
+ ****************************************************************************/
+
+void mm_cpucache_flush(FAR struct mm_heap_s *heap)
+{
+  mm_cpucache_release(heap, 1, 0);
+}
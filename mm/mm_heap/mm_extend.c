@@ -118,11 +118,12 @@ void mm_extend(FAR struct mm_heap_s *heap, FAR void *mem, size_t size,
   newnode->preceding = oldnode->size | MM_ALLOC_BIT;
 
   heap->mm_heapend[region] = newnode;
-  mm_givesemaphore(heap);
 
   /* Finally "free" the new block of memory where the old terminal node was
-   * located.
+   * located.  This goes directly to the free lists so that the new block
+   * is never held in a small allocation cache.
    */
 
-  mm_free(heap, (FAR void *)mem);
+  mm_freechunk(heap, (FAR void *)mem);
+  mm_givesemaphore(heap);
 }
@@ -113,13 +113,20 @@ int mm_mallinfo(FAR struct mm_heap_s *heap, FAR struct mallinfo *info)
               FAR struct mm_freenode_s *fnode = (FAR void *)node;
 #endif
               DEBUGASSERT(node->size >= SIZEOF_MM_FREENODE);
+#ifdef CONFIG_MM_TLSF
+              DEBUGASSERT(fnode->blink == NULL ||
+                          fnode->blink->flink == fnode);
+#else
               DEBUGASSERT(fnode->blink->flink == fnode);
               DEBUGASSERT(fnode->blink->size <= fnode->size);
+#endif
               DEBUGASSERT(fnode->flink == NULL ||
                           fnode->flink->blink == fnode);
+#ifndef CONFIG_MM_TLSF
               DEBUGASSERT(fnode->flink == NULL ||
                           fnode->flink->size == 0 ||
                           fnode->flink->size >= fnode->size);
+#endif
               ordblks++;
               fordblks += node->size;
               if (node->size > mxordblk)
@@ -99,47 +99,33 @@ static void mm_free_delaylist(FAR struct mm_heap_s *heap)
  ****************************************************************************/
 
 /****************************************************************************
- * Name: mm_malloc
+ * Name: mm_mallocchunk
  *
  * Description:
- *  Find the smallest chunk that satisfies the request. Take the memory from
- *  that chunk, save the remaining, smaller chunk (if any).
+ *  Find the smallest free chunk that satisfies the request of 'alignsize'
+ *  bytes (including the allocated node header).  Take the memory from that
+ *  chunk, save the remaining, smaller chunk (if any).
  *
- *  8-byte alignment of the allocated data is assured.
+ * Assumptions:
+ *   The caller holds the MM semaphore.
  *
  ****************************************************************************/
 
-FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
+FAR void *mm_mallocchunk(FAR struct mm_heap_s *heap, size_t alignsize)
 {
   FAR struct mm_freenode_s *node;
-  size_t alignsize;
   void *ret = NULL;
+#ifndef CONFIG_MM_TLSF
   int ndx;
+#endif
 
-  /* Firstly, free mm_delaylist */
-
-  mm_free_delaylist(heap);
-
-  /* Ignore zero-length allocations */
-
-  if (size < 1)
-    {
-      return NULL;
-    }
-
-  /* Adjust the size to account for (1) the size of the allocated node and
-   * (2) to make sure that it is an even multiple of our granule size.
+#ifdef CONFIG_MM_TLSF
+  /* Find a large enough chunk in the segregated free lists in constant
+   * time.
    */
 
-  alignsize = MM_ALIGN_UP(size + SIZEOF_MM_ALLOCNODE);
-  DEBUGASSERT(alignsize >= size);  /* Check for integer overflow */
-  DEBUGASSERT(alignsize >= MM_MIN_CHUNK);
-  DEBUGASSERT(alignsize >= SIZEOF_MM_FREENODE);
-
-  /* We need to hold the MM semaphore while we muck with the nodelist. */
-
-  mm_takesemaphore(heap);
-
+  node = mm_tlsf_search(heap, alignsize);
+#else
   /* Get the location in the node list to start the search. Special case
    * really big allocations
    */
@@ -166,10 +152,12 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
     {
       DEBUGASSERT(node->blink->flink == node);
     }
+#endif
 
   /* If we found a node with non-zero size, then this is one to use. Since
    * the list is ordered, we know that is must be best fitting chunk
-   * available.
+   * available (the TLSF search returns a good, but not necessarily the
+   * best, fit).
    */
 
   if (node)
@@ -178,16 +166,9 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
       FAR struct mm_freenode_s *next;
       size_t remaining;
 
-      /* Remove the node.  There must be a predecessor, but there may not be
-       * a successor node.
-       */
+      /* Remove the node from the free list */
 
-      DEBUGASSERT(node->blink);
-      node->blink->flink = node->flink;
-      if (node->flink)
-        {
-          node->flink->blink = node->blink;
-        }
+      mm_delfreechunk(heap, node);
 
       /* Check if we have to split the free node into one of the allocated
        * size and another smaller freenode.  In some cases, the remaining
@@ -234,7 +215,65 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
     }
 
   DEBUGASSERT(ret == NULL || mm_heapmember(heap, ret));
-  mm_givesemaphore(heap);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mm_malloc
+ *
+ * Description:
+ *  Find the smallest chunk that satisfies the request. Take the memory from
+ *  that chunk, save the remaining, smaller chunk (if any).
+ *
+ *  8-byte alignment of the allocated data is assured.
+ *
+ ****************************************************************************/
+
+FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
+{
+  size_t alignsize;
+  void *ret;
+
+  /* Firstly, free mm_delaylist */
+
+  mm_free_delaylist(heap);
+
+  /* Ignore zero-length allocations */
+
+  if (size < 1)
+    {
+      return NULL;
+    }
+
+  /* Adjust the size to account for (1) the size of the allocated node and
+   * (2) to make sure that it is an even multiple of our granule size.
+   */
+
+  alignsize = MM_ALIGN_UP(size + SIZEOF_MM_ALLOCNODE);
+  DEBUGASSERT(alignsize >= size);  /* Check for integer overflow */
+  DEBUGASSERT(alignsize >= MM_MIN_CHUNK);
+  DEBUGASSERT(alignsize >= SIZEOF_MM_FREENODE);
+
+#ifdef CONFIG_MM_CPUCACHE
+  /* Small allocations are served from the per-CPU cache, which only takes
+   * the MM semaphore when it needs to be refilled.
+   */
+
+  if (alignsize <= MM_CPUCACHE_MAXCHUNK)
+    {
+      ret = mm_cpucache_malloc(heap, alignsize);
+    }
+  else
+#endif
+    {
+      /* We need to hold the MM semaphore while we muck with the
+       * nodelist.
+       */
+
+      mm_takesemaphore(heap);
+      ret = mm_mallocchunk(heap, alignsize);
+      mm_givesemaphore(heap);
+    }
 
 #ifdef CONFIG_MM_FILL_ALLOCATIONS
   if (ret)
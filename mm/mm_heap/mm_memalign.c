@@ -123,6 +123,7 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
     {
       FAR struct mm_allocnode_s *newnode;
       FAR struct mm_allocnode_s *next;
+      FAR struct mm_freenode_s *prev;
       size_t precedingsize;
 
       /* Get the node the next node after the allocation. */
@@ -170,6 +171,23 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
       node->size = precedingsize;
       node->preceding &= ~MM_ALLOC_BIT;
 
+      /* If the chunk before the original chunk is also free, then merge
+       * the newly freed space into it.
+       */
+
+      prev = (FAR struct mm_freenode_s *)
+        ((FAR char *)node - node->preceding);
+      if ((prev->preceding & MM_ALLOC_BIT) == 0)
+        {
+          /* Remove the previous node from the free list */
+
+          mm_delfreechunk(heap, prev);
+
+          prev->size        += node->size;
+          newnode->preceding = prev->size | MM_ALLOC_BIT;
+          node               = (FAR struct mm_allocnode_s *)prev;
+        }
+
       /* Fix the preceding size of the next node */
 
       next->preceding = newnode->size | (next->preceding & MM_ALLOC_BIT);
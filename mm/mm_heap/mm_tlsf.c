@@ -0,0 +1,149 @@
+/****************************************************************************
+ * mm/mm_heap/mm_tlsf.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <strings.h>
+#include <assert.h>
+
+#include <nuttx/mm/mm.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if MM_TLSF_SLI > 5 || MM_TLSF_FLCOUNT > 32
+#  error The TLSF bitmaps are limited to 32 lists
+#endif
+
+#if MM_TLSF_FLCOUNT < 2
+#  error CONFIG_MM_TLSF_SLI is too large for the heap chunk size range
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_tlsf_mapping
+ *
+ * Description:
+ *   Convert a chunk size into the first and second level indices of the
+ *   segregated list that holds free chunks of that size.
+ *
+ ****************************************************************************/
+
+void mm_tlsf_mapping(size_t size, FAR int *fl, FAR int *sl)
+{
+  size_t ngran;
+  int log2;
+
+  if (size >= MM_MAX_CHUNK)
+    {
+      *fl = MM_TLSF_FLCOUNT - 1;
+      *sl = 0;
+      return;
+    }
+
+  ngran = size >> MM_MIN_SHIFT;
+  if (ngran < MM_TLSF_SLCOUNT)
+    {
+      *fl = 0;
+      *sl = (int)ngran;
+    }
+  else
+    {
+      log2 = fls((int)ngran) - 1;
+      *fl  = log2 - MM_TLSF_SLI + 1;
+      *sl  = (int)(ngran >> (log2 - MM_TLSF_SLI)) - MM_TLSF_SLCOUNT;
+    }
+}
+
+/****************************************************************************
+ * Name: mm_tlsf_search
+ *
+ * Description:
+ *   Find a free chunk of at least 'size' bytes in constant time.  The
+ *   chunk is not removed from its free list.  Returns NULL if there is no
+ *   such chunk.
+ *
+ *   It is assumed that the caller holds the mm semaphore.
+ *
+ ****************************************************************************/
+
+FAR struct mm_freenode_s *mm_tlsf_search(FAR struct mm_heap_s *heap,
+                                         size_t size)
+{
+  FAR struct mm_freenode_s *node;
+  uint32_t bitmap;
+  size_t ngran;
+  int fl;
+  int sl;
+
+  if (size >= MM_MAX_CHUNK)
+    {
+      /* Huge chunks are not sorted.  Take the first one that fits. */
+
+      for (node = heap->mm_freelist[MM_TLSF_FLCOUNT - 1][0];
+           node && node->size < size;
+           node = node->flink);
+
+      return node;
+    }
+
+  /* Round the request up to the next list boundary so that every chunk in
+   * the list that we find is large enough.
+   */
+
+  ngran = size >> MM_MIN_SHIFT;
+  if (ngran >= MM_TLSF_SLCOUNT)
+    {
+      ngran += (1 << (fls((int)ngran) - 1 - MM_TLSF_SLI)) - 1;
+    }
+
+  mm_tlsf_mapping(ngran << MM_MIN_SHIFT, &fl, &sl);
+
+  /* Look for a non-empty list in the same first level range ... */
+
+  bitmap = heap->mm_slbitmap[fl] & ~((1u << sl) - 1);
+  if (bitmap == 0)
+    {
+      /* ... otherwise in the next non-empty first level range */
+
+      bitmap = heap->mm_flbitmap & ~((2u << fl) - 1);
+      if (bitmap == 0)
+        {
+          return NULL;
+        }
+
+      fl     = ffs((int)bitmap) - 1;
+      bitmap = heap->mm_slbitmap[fl];
+    }
+
+  sl = ffs((int)bitmap) - 1;
+
+  node = heap->mm_freelist[fl][sl];
+  DEBUGASSERT(node != NULL && node->size >= size);
+  return node;
+}
@@ -37,6 +37,7 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/wqueue.h>
+#include <nuttx/fs/fs.h>
 #include <nuttx/net/net.h>
 
 #include "can/can.h"
@@ -171,7 +172,7 @@ static uint16_t can_poll_eventhandler(FAR struct net_driver_s *dev,
       if (eventset)
         {
           info->fds->revents |= eventset;
-          nxsem_post(info->fds->sem);
+          poll_notify(info->fds);
         }
     }
 
@@ -646,7 +647,7 @@ static int can_poll_local(FAR struct socket *psock, FAR struct pollfd *fds,
         {
           /* Yes.. then signal the poll logic */
 
-          nxsem_post(fds->sem);
+          poll_notify(fds);
         }
 
 errout_with_lock:
@@ -41,6 +41,7 @@
 #include <nuttx/config.h>
 #ifdef CONFIG_NET
 
+#include <stdbool.h>
 #include <debug.h>
 
 #include <nuttx/clock.h>
@@ -565,22 +566,40 @@ static inline int devif_poll_tcp_connections(FAR struct net_driver_s *dev,
 {
   FAR struct tcp_conn_s *conn  = NULL;
   int bstop = 0;
+  int nsegs;
+  bool sent;
 
   /* Traverse all of the active TCP connections and perform the poll action */
 
   while (!bstop && (conn = tcp_nextconn(conn)))
     {
-      /* Perform the TCP TX poll */
+      nsegs = 0;
 
-      tcp_poll(dev, conn);
+      do
+        {
+          /* Perform the TCP TX poll */
 
-      /* Perform any necessary conversions on outgoing packets */
+          tcp_poll(dev, conn);
 
-      devif_packet_conversion(dev, DEVIF_TCP);
+          /* Perform any necessary conversions on outgoing packets */
 
-      /* Call back into the driver */
+          devif_packet_conversion(dev, DEVIF_TCP);
+          sent = (dev->d_len > 0);
 
-      bstop = callback(dev);
+          /* Call back into the driver */
+
+          bstop = callback(dev);
+
+          /* Keep polling the same connection while it produces segments,
+           * the driver can accept more of them, and the peer's receive
+           * window still has room for another full-sized segment.  This
+           * hands the driver a burst of up to CONFIG_NET_TCP_TXBURST
+           * back-to-back segments in one pass instead of one segment per
+           * connection per poll.
+           */
+        }
+      while (!bstop && sent && ++nsegs < CONFIG_NET_TCP_TXBURST &&
+             conn->tx_unacked + conn->mss <= conn->winsize);
     }
 
   return bstop;
@@ -32,6 +32,7 @@
 #include <debug.h>
 #include <assert.h>
 
+#include <nuttx/fs/fs.h>
 #include <nuttx/net/net.h>
 
 #include "socket/socket.h"
@@ -70,6 +71,10 @@ int psock_close(FAR struct socket *psock)
       return -EBADF;
     }
 
+  /* Remove the socket from any epoll instance that watches it */
+
+  epoll_remove(psock);
+
   /* We perform the close operation only if this is the last count on
    * the socket. (actually, I think the socket crefs only takes the values
    * 0 and 1 right now).
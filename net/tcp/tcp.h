@@ -47,6 +47,7 @@
 
 #include <nuttx/clock.h>
 #include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
 #include <nuttx/net/ip.h>
 
 #ifdef CONFIG_NET_TCP_NOTIFIER
@@ -166,6 +167,10 @@ struct tcp_conn_s
 
   /* TCP-specific content follows */
 
+  dq_entry_t hnode;       /* Links an active connection into its hash chain
+                           * (see tcp_active()) */
+  dq_entry_t pnode;       /* Links a connection with a local port into its
+                           * port hash chain */
   union ip_binding_u u;   /* IP address binding */
   uint8_t  rcvseq[4];     /* The sequence number that we expect to
                            * receive next */
@@ -209,9 +214,13 @@ struct tcp_conn_s
    *
    *   readahead - A singly linked list of type struct iob_qentry_s
    *               where the TCP/IP read-ahead data is retained.
+   *   rdlock    - Protects readahead with CONFIG_NET_FINE_LOCKING.
    */
 
   struct iob_queue_s readahead;   /* Read-ahead buffering */
+#ifdef CONFIG_NET_FINE_LOCKING
+  net_finelock_t rdlock;          /* Read-ahead buffer lock */
+#endif
 
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   /* Write buffering
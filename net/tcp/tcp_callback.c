@@ -45,6 +45,7 @@
 
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/netconfig.h>
+#include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/netstats.h>
 
@@ -274,7 +275,10 @@ uint16_t tcp_datahandler(FAR struct tcp_conn_s *conn, FAR uint8_t *buffer,
    * without waiting).
    */
 
+  net_finelock(&conn->rdlock);
   ret = iob_tryadd_queue(iob, &conn->readahead);
+  net_fineunlock(&conn->rdlock);
+
   if (ret < 0)
     {
       nerr("ERROR: Failed to queue the I/O buffer chain: %d\n", ret);
@@ -54,6 +54,7 @@
 
 #include <arch/irq.h>
 
+#include <nuttx/nuttx.h>
 #include <nuttx/clock.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
@@ -74,6 +75,12 @@
 #define IPv4BUF ((struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 #define IPv6BUF ((struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 
+#if (CONFIG_NET_TCP_HASHSIZE & (CONFIG_NET_TCP_HASHSIZE - 1)) != 0
+#  error CONFIG_NET_TCP_HASHSIZE must be a power of two
+#endif
+
+#define TCP_HASHMASK (CONFIG_NET_TCP_HASHSIZE - 1)
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -90,10 +97,173 @@ static dq_queue_t g_free_tcp_connections;
 
 static dq_queue_t g_active_tcp_connections;
 
+/* The active connections hashed on their remote address and their local
+ * and remote ports (see tcp_connhash())
+ */
+
+static dq_queue_t g_tcp_connhash[CONFIG_NET_TCP_HASHSIZE];
+
+/* All connections with a local port, hashed on the local port */
+
+static dq_queue_t g_tcp_porthash[CONFIG_NET_TCP_HASHSIZE];
+
+#ifdef CONFIG_NET_FINE_LOCKING
+/* Protects g_free_tcp_connections so that tcp_alloc() does not have to
+ * wait for the network lock.  g_active_tcp_connections is still protected
+ * by the network lock.
+ */
+
+static net_finelock_t g_tcp_tablelock;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_hashkey
+ *
+ * Description:
+ *   Return the hash chain index for a 32-bit key.
+ *
+ ****************************************************************************/
+
+static inline unsigned int tcp_hashkey(uint32_t key)
+{
+  key ^= key >> 16;
+  key *= 0x9e3779b1;
+  key ^= key >> 16;
+
+  return key & TCP_HASHMASK;
+}
+
+/****************************************************************************
+ * Name: tcp_ipv4_hash and tcp_ipv6_hash
+ *
+ * Description:
+ *   Return the index of the hash chain that holds the active connection
+ *   with this remote address and these ports (all in network order).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static inline unsigned int tcp_ipv4_hash(in_addr_t raddr, uint16_t lport,
+                                         uint16_t rport)
+{
+  return tcp_hashkey(raddr ^ ((uint32_t)rport << 16 | lport));
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static inline unsigned int tcp_ipv6_hash(const net_ipv6addr_t raddr,
+                                         uint16_t lport, uint16_t rport)
+{
+  uint32_t key = (uint32_t)rport << 16 | lport;
+  int i;
+
+  for (i = 0; i < 8; i += 2)
+    {
+      key ^= (uint32_t)raddr[i] << 16 | raddr[i + 1];
+    }
+
+  return tcp_hashkey(key);
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_connhash
+ *
+ * Description:
+ *   Return the index of the hash chain that holds an active connection.
+ *
+ ****************************************************************************/
+
+static unsigned int tcp_connhash(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (conn->domain == PF_INET)
+#endif
+    {
+      return tcp_ipv4_hash(conn->u.ipv4.raddr, conn->lport, conn->rport);
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      return tcp_ipv6_hash(conn->u.ipv6.raddr, conn->lport, conn->rport);
+    }
+#endif /* CONFIG_NET_IPv6 */
+}
+
+/****************************************************************************
+ * Name: tcp_hashconn and tcp_portconn
+ *
+ * Description:
+ *   Return the connection that contains a hash chain entry (or NULL).
+ *
+ ****************************************************************************/
+
+static inline FAR struct tcp_conn_s *tcp_hashconn(FAR dq_entry_t *entry)
+{
+  return entry ? container_of(entry, struct tcp_conn_s, hnode) : NULL;
+}
+
+static inline FAR struct tcp_conn_s *tcp_portconn(FAR dq_entry_t *entry)
+{
+  return entry ? container_of(entry, struct tcp_conn_s, pnode) : NULL;
+}
+
+/****************************************************************************
+ * Name: tcp_setlport
+ *
+ * Description:
+ *   Set the local port of a connection (in network order, zero if none)
+ *   and move the connection to the matching port hash chain.  The local
+ *   port must not be modified in any other way.
+ *
+ * Assumptions:
+ *   This function is called with the network locked.
+ *
+ ****************************************************************************/
+
+static void tcp_setlport(FAR struct tcp_conn_s *conn, uint16_t lport)
+{
+  if (conn->lport != 0)
+    {
+      dq_rem(&conn->pnode, &g_tcp_porthash[tcp_hashkey(conn->lport)]);
+    }
+
+  conn->lport = lport;
+
+  if (lport != 0)
+    {
+      dq_addlast(&conn->pnode, &g_tcp_porthash[tcp_hashkey(lport)]);
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_addactive
+ *
+ * Description:
+ *   Put a connection into the active list and into its hash chain.  The
+ *   addresses and the ports of the connection must not change while it is
+ *   active.
+ *
+ * Assumptions:
+ *   This function is called with the network locked.
+ *
+ ****************************************************************************/
+
+static void tcp_addactive(FAR struct tcp_conn_s *conn)
+{
+  dq_addlast(&conn->node, &g_active_tcp_connections);
+  dq_addlast(&conn->hnode, &g_tcp_connhash[tcp_connhash(conn)]);
+}
+
 /****************************************************************************
  * Name: tcp_ipv4_listener
  *
@@ -111,14 +281,15 @@ static inline FAR struct tcp_conn_s *tcp_ipv4_listener(in_addr_t ipaddr,
                                                        uint16_t portno)
 {
   FAR struct tcp_conn_s *conn;
-  int i;
 
-  /* Check if this port number is in use by any active UIP TCP connection */
+  /* Check if this port number is in use by any active UIP TCP connection.
+   * Only the connections in the hash chain of the port may use it.
+   */
 
-  for (i = 0; i < CONFIG_NET_TCP_CONNS; i++)
+  for (conn = tcp_portconn(g_tcp_porthash[tcp_hashkey(portno)].head);
+       conn != NULL;
+       conn = tcp_portconn(conn->pnode.flink))
     {
-      conn = &g_tcp_connections[i];
-
       /* Check if this connection is open and the local port assignment
        * matches the requested port number.
        */
@@ -162,14 +333,15 @@ static inline FAR struct tcp_conn_s *
 tcp_ipv6_listener(const net_ipv6addr_t ipaddr, uint16_t portno)
 {
   FAR struct tcp_conn_s *conn;
-  int i;
 
-  /* Check if this port number is in use by any active UIP TCP connection */
+  /* Check if this port number is in use by any active UIP TCP connection.
+   * Only the connections in the hash chain of the port may use it.
+   */
 
-  for (i = 0; i < CONFIG_NET_TCP_CONNS; i++)
+  for (conn = tcp_portconn(g_tcp_porthash[tcp_hashkey(portno)].head);
+       conn != NULL;
+       conn = tcp_portconn(conn->pnode.flink))
     {
-      conn = &g_tcp_connections[i];
-
       /* Check if this connection is open and the local port assignment
        * matches the requested port number.
        */
@@ -339,10 +511,14 @@ static inline FAR struct tcp_conn_s *
   in_addr_t srcipaddr;
   in_addr_t destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = net_ip4addr_conv32(ip->srcipaddr);
   destipaddr = net_ip4addr_conv32(ip->destipaddr);
 
+  /* Only the connections in this hash chain can match */
+
+  conn = tcp_hashconn(g_tcp_connhash[tcp_ipv4_hash(srcipaddr, tcp->destport,
+                                                   tcp->srcport)].head);
+
   while (conn)
     {
       /* Find an open connection matching the TCP input. The following
@@ -376,9 +552,9 @@ static inline FAR struct tcp_conn_s *
           break;
         }
 
-      /* Look at the next active connection */
+      /* Look at the next connection in the hash chain */
 
-      conn = (FAR struct tcp_conn_s *)conn->node.flink;
+      conn = tcp_hashconn(conn->hnode.flink);
     }
 
   return conn;
@@ -406,10 +582,14 @@ static inline FAR struct tcp_conn_s *
   net_ipv6addr_t *srcipaddr;
   net_ipv6addr_t *destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = (net_ipv6addr_t *)ip->srcipaddr;
   destipaddr = (net_ipv6addr_t *)ip->destipaddr;
 
+  /* Only the connections in this hash chain can match */
+
+  conn = tcp_hashconn(g_tcp_connhash[tcp_ipv6_hash(*srcipaddr, tcp->destport,
+                                                   tcp->srcport)].head);
+
   while (conn)
     {
       /* Find an open connection matching the TCP input. The following
@@ -443,9 +623,9 @@ static inline FAR struct tcp_conn_s *
           break;
         }
 
-      /* Look at the next active connection */
+      /* Look at the next connection in the hash chain */
 
-      conn = (FAR struct tcp_conn_s *)conn->node.flink;
+      conn = tcp_hashconn(conn->hnode.flink);
     }
 
   return conn;
@@ -486,12 +666,13 @@ static inline int tcp_ipv4_bind(FAR struct tcp_conn_s *conn,
   if (port < 0)
     {
       nerr("ERROR: tcp_selectport failed: %d\n", port);
+      net_unlock();
       return port;
     }
 
   /* Save the local address in the connection structure (network order). */
 
-  conn->lport = htons(port);
+  tcp_setlport(conn, htons(port));
   net_ipv4addr_copy(conn->u.ipv4.laddr, addr->sin_addr.s_addr);
 
   /* Find the device that can receive packets on the network associated with
@@ -507,8 +688,9 @@ static inline int tcp_ipv4_bind(FAR struct tcp_conn_s *conn,
 
       /* Back out the local address setting */
 
-      conn->lport = 0;
+      tcp_setlport(conn, 0);
       net_ipv4addr_copy(conn->u.ipv4.laddr, INADDR_ANY);
+      net_unlock();
       return ret;
     }
 
@@ -553,12 +735,13 @@ static inline int tcp_ipv6_bind(FAR struct tcp_conn_s *conn,
   if (port < 0)
     {
       nerr("ERROR: tcp_selectport failed: %d\n", port);
+      net_unlock();
       return port;
     }
 
   /* Save the local address in the connection structure (network order). */
 
-  conn->lport = htons(port);
+  tcp_setlport(conn, htons(port));
   net_ipv6addr_copy(conn->u.ipv6.laddr, addr->sin6_addr.in6_u.u6_addr16);
 
   /* Find the device that can receive packets on the network
@@ -574,8 +757,9 @@ static inline int tcp_ipv6_bind(FAR struct tcp_conn_s *conn,
 
       /* Back out the local address setting */
 
-      conn->lport = 0;
+      tcp_setlport(conn, 0);
       net_ipv6addr_copy(conn->u.ipv6.laddr, g_ipv6_unspecaddr);
+      net_unlock();
       return ret;
     }
 
@@ -606,6 +790,14 @@ void tcp_initialize(void)
   dq_init(&g_free_tcp_connections);
   dq_init(&g_active_tcp_connections);
 
+  for (i = 0; i < CONFIG_NET_TCP_HASHSIZE; i++)
+    {
+      dq_init(&g_tcp_connhash[i]);
+      dq_init(&g_tcp_porthash[i]);
+    }
+
+  net_finelock_init(&g_tcp_tablelock);
+
   /* Now initialize each connection structure */
 
   for (i = 0; i < CONFIG_NET_TCP_CONNS; i++)
@@ -633,15 +825,16 @@ FAR struct tcp_conn_s *tcp_alloc(uint8_t domain)
   FAR struct tcp_conn_s *conn;
 
   /* Because this routine is called from both event processing (with the
-   * network locked) and and from user level.  Make sure that the network
-   * locked in any cased while accessing g_free_tcp_connections[];
+   * network locked) and and from user level.  Make sure that the free list
+   * is locked in any cased while accessing g_free_tcp_connections[];
    */
 
-  net_lock();
+  net_finelock(&g_tcp_tablelock);
 
   /* Return the entry from the head of the free list */
 
   conn = (FAR struct tcp_conn_s *)dq_remfirst(&g_free_tcp_connections);
+  net_fineunlock(&g_tcp_tablelock);
 
 #ifndef CONFIG_NET_SOLINGER
   /* Is the free list empty? */
@@ -654,9 +847,13 @@ FAR struct tcp_conn_s *tcp_alloc(uint8_t domain)
        * that is about to be closed anyway.
        */
 
-      FAR struct tcp_conn_s *tmp =
-        (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+      FAR struct tcp_conn_s *tmp;
+
+      /* The active list is protected by the network lock */
 
+      net_lock();
+
+      tmp = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
       while (tmp)
         {
           ninfo("conn: %p state: %02x\n", tmp, tmp->tcpstateflags);
@@ -711,19 +908,22 @@ FAR struct tcp_conn_s *tcp_alloc(uint8_t domain)
 
           /* Now there is guaranteed to be one free connection.  Get it! */
 
+          net_finelock(&g_tcp_tablelock);
           conn = (FAR struct tcp_conn_s *)
             dq_remfirst(&g_free_tcp_connections);
+          net_fineunlock(&g_tcp_tablelock);
         }
+
+      net_unlock();
     }
 #endif
 
-  net_unlock();
-
   /* Mark the connection allocated */
 
   if (conn)
     {
       memset(conn, 0, sizeof(struct tcp_conn_s));
+      net_finelock_init(&conn->rdlock);
       conn->tcpstateflags = TCP_ALLOCATED;
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
       conn->domain        = domain;
@@ -783,11 +983,18 @@ void tcp_free(FAR struct tcp_conn_s *conn)
       /* Remove the connection from the active list */
 
       dq_rem(&conn->node, &g_active_tcp_connections);
+      dq_rem(&conn->hnode, &g_tcp_connhash[tcp_connhash(conn)]);
     }
 
+  /* Release the local port */
+
+  tcp_setlport(conn, 0);
+
   /* Release any read-ahead buffers attached to the connection */
 
+  net_finelock(&conn->rdlock);
   iob_free_queue(&conn->readahead, IOBUSER_NET_TCP_READAHEAD);
+  net_fineunlock(&conn->rdlock);
 
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   /* Release any write buffers attached to the connection */
@@ -826,7 +1033,10 @@ void tcp_free(FAR struct tcp_conn_s *conn)
   /* Mark the connection available and put it into the free list */
 
   conn->tcpstateflags = TCP_CLOSED;
+
+  net_finelock(&g_tcp_tablelock);
   dq_addlast(&conn->node, &g_free_tcp_connections);
+  net_fineunlock(&g_tcp_tablelock);
   net_unlock();
 }
 
@@ -1011,9 +1221,9 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
       conn->sa            = 0;
       conn->sv            = 4;
       conn->nrtx          = 0;
-      conn->lport         = tcp->destport;
       conn->rport         = tcp->srcport;
       conn->tcpstateflags = TCP_SYN_RCVD;
+      tcp_setlport(conn, tcp->destport);
 
       tcp_initsequence(conn->sndseq);
       conn->tx_unacked    = 1;
@@ -1043,7 +1253,7 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
        * Interrupts should already be disabled in this context.
        */
 
-      dq_addlast(&conn->node, &g_active_tcp_connections);
+      tcp_addactive(conn);
     }
 
   return conn;
@@ -1287,7 +1497,7 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
   conn->rto        = TCP_RTO;
   conn->sa         = 0;
   conn->sv         = 16;   /* Initial value of the RTT variance. */
-  conn->lport      = htons((uint16_t)port);
+  tcp_setlport(conn, htons((uint16_t)port));
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   conn->expired    = 0;
   conn->isn        = 0;
@@ -1308,7 +1518,7 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
 
   /* And, finally, put the connection structure into the active list. */
 
-  dq_addlast(&conn->node, &g_active_tcp_connections);
+  tcp_addactive(conn);
   ret = OK;
 
 errout_with_lock:
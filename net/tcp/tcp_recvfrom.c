@@ -228,7 +228,7 @@ static inline void tcp_newdata(FAR struct net_driver_s *dev,
  *   None
  *
  * Assumptions:
- *   The network is locked.
+ *   The network lock is not required.
  *
  ****************************************************************************/
 
@@ -243,6 +243,7 @@ static inline void tcp_readahead(struct tcp_recvfrom_s *pstate)
    * buffer.
    */
 
+  net_finelock(&conn->rdlock);
   while ((iob = iob_peek_queue(&conn->readahead)) != NULL &&
           pstate->ir_buflen > 0)
     {
@@ -292,6 +293,8 @@ static inline void tcp_readahead(struct tcp_recvfrom_s *pstate)
                              IOBUSER_NET_TCP_READAHEAD);
         }
     }
+
+  net_fineunlock(&conn->rdlock);
 }
 
 /****************************************************************************
@@ -639,18 +642,27 @@ ssize_t psock_tcp_recvfrom(FAR struct socket *psock, FAR void *buf,
   struct tcp_recvfrom_s state;
   int               ret;
 
-  /* Initialize the state structure.  This is done with the network locked
-   * because we don't want anything to happen until we are ready.
-   */
-
-  net_lock();
   tcp_recvfrom_initialize(psock, buf, len, from, fromlen, &state);
 
   /* Handle any any TCP data already buffered in a read-ahead buffer.  NOTE
    * that there may be read-ahead data to be retrieved even after the
-   * socket has been disconnected.
+   * socket has been disconnected.  If any data is obtained, it is returned
+   * without ever taking the network lock.
+   */
+
+  tcp_readahead(&state);
+  if (state.ir_recvlen > 0)
+    {
+      tcp_recvfrom_uninitialize(&state);
+      return (ssize_t)state.ir_recvlen;
+    }
+
+  /* Otherwise, lock the network because we don't want anything to happen
+   * until we are ready.  Data may have been buffered after we looked into
+   * the read-ahead buffers, so look again.
    */
 
+  net_lock();
   tcp_readahead(&state);
 
   /* The default return value is the number of bytes that we just copied
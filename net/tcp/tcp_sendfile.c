@@ -55,8 +55,10 @@
 #include <debug.h>
 
 #include <arch/irq.h>
+#include <nuttx/kmalloc.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/arp.h>
@@ -81,6 +83,10 @@
 #  define CONFIG_NET_TCP_SPLIT_SIZE 40
 #endif
 
+#ifndef CONFIG_NET_SENDFILE_BUFSIZE
+#  define CONFIG_NET_SENDFILE_BUFSIZE 0
+#endif
+
 #define TCPIPv4BUF ((struct tcp_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev) + IPv4_HDRLEN])
 #define TCPIPv6BUF ((struct tcp_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev) + IPv6_HDRLEN])
 
@@ -104,12 +110,111 @@ struct sendfile_s
   ssize_t            snd_sent;             /* The number of bytes sent */
   uint32_t           snd_isn;              /* Initial sequence number */
   uint32_t           snd_acked;            /* The number of bytes acked */
+  FAR const uint8_t *snd_map;              /* File data in memory or NULL */
+#if CONFIG_NET_SENDFILE_BUFSIZE > 0
+  FAR uint8_t       *snd_buf;              /* Read buffer or NULL */
+  size_t             snd_bufpos;           /* Value of snd_sent at snd_buf */
+  size_t             snd_buflen;           /* Number of bytes in snd_buf */
+#endif
 };
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: sendfile_copyout
+ *
+ * Description:
+ *   Copy up to 'len' bytes of the file, starting at the position that
+ *   corresponds to snd_sent, into the packet buffer.
+ *
+ *   Files in memory are copied directly.  Otherwise, the data is taken
+ *   from the read buffer, which is refilled with one large read when it
+ *   does not hold the data.  Without a read buffer, the data is read from
+ *   the file directly into the packet buffer.
+ *
+ * Returned Value:
+ *   The number of bytes copied (zero at the end of the file) or a negated
+ *   errno value on failure.
+ *
+ ****************************************************************************/
+
+static ssize_t sendfile_copyout(FAR struct sendfile_s *pstate,
+                                FAR uint8_t *dest, size_t len)
+{
+  ssize_t ret;
+
+  if (pstate->snd_map != NULL)
+    {
+      memcpy(dest, pstate->snd_map + pstate->snd_sent, len);
+      return len;
+    }
+
+#if CONFIG_NET_SENDFILE_BUFSIZE > 0
+  if (pstate->snd_buf != NULL)
+    {
+      size_t pos = pstate->snd_sent;
+
+      if (pos < pstate->snd_bufpos ||
+          pos >= pstate->snd_bufpos + pstate->snd_buflen)
+        {
+          size_t nread = pstate->snd_flen - pos;
+
+          if (nread > CONFIG_NET_SENDFILE_BUFSIZE)
+            {
+              nread = CONFIG_NET_SENDFILE_BUFSIZE;
+            }
+
+          pstate->snd_buflen = 0;
+          ret = file_seek(pstate->snd_file, pstate->snd_foffset + pos,
+                          SEEK_SET);
+          if (ret < 0)
+            {
+              nerr("ERROR: Failed to lseek: %d\n", (int)ret);
+              return ret;
+            }
+
+          ret = file_read(pstate->snd_file, pstate->snd_buf, nread);
+          if (ret < 0)
+            {
+              nerr("ERROR: Failed to read from input file: %d\n",
+                   (int)ret);
+              return ret;
+            }
+
+          pstate->snd_bufpos = pos;
+          pstate->snd_buflen = ret;
+        }
+
+      pos -= pstate->snd_bufpos;
+      if (len > pstate->snd_buflen - pos)
+        {
+          len = pstate->snd_buflen - pos;
+        }
+
+      memcpy(dest, pstate->snd_buf + pos, len);
+      return len;
+    }
+#endif
+
+  ret = file_seek(pstate->snd_file,
+                  pstate->snd_foffset + pstate->snd_sent, SEEK_SET);
+  if (ret < 0)
+    {
+      nerr("ERROR: Failed to lseek: %d\n", (int)ret);
+      return ret;
+    }
+
+  ret = file_read(pstate->snd_file, dest, len);
+  if (ret < 0)
+    {
+      nerr("ERROR: Failed to read from input file: %d\n", (int)ret);
+    }
+
+  return ret;
+}
+
 static uint16_t ack_eventhandler(FAR struct net_driver_s *dev,
                                  FAR void *pvconn,
                                  FAR void *pvpriv, uint16_t flags)
@@ -305,21 +410,18 @@ static uint16_t sendfile_eventhandler(FAR struct net_driver_s *dev,
            * happen until the polling cycle completes).
            */
 
-          ret = file_seek(pstate->snd_file,
-                          pstate->snd_foffset + pstate->snd_sent, SEEK_SET);
+          ret = sendfile_copyout(pstate, dev->d_appdata, sndlen);
           if (ret < 0)
             {
-              nerr("ERROR: Failed to lseek: %d\n", ret);
               pstate->snd_sent = ret;
               goto end_wait;
             }
-
-          ret = file_read(pstate->snd_file, dev->d_appdata, sndlen);
-          if (ret < 0)
+          else if (ret < sndlen)
             {
-              nerr("ERROR: Failed to read from input file: %d\n", (int)ret);
-              pstate->snd_sent = ret;
-              goto end_wait;
+              /* The file is shorter than expected.  Send what is left. */
+
+              sndlen           = ret;
+              pstate->snd_flen = pstate->snd_sent + ret;
             }
 
           dev->d_sndlen = sndlen;
@@ -450,7 +552,10 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
                       FAR off_t *offset, size_t count)
 {
   FAR struct tcp_conn_s *conn;
+  FAR const uint8_t *map = NULL;
   struct sendfile_s state;
+  struct stat st;
+  off_t foffset = offset ? *offset : 0;
   int ret;
 
   /* If this is an un-connected socket, then return ENOTCONN */
@@ -497,6 +602,30 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
     }
 #endif /* CONFIG_NET_ARP_SEND || CONFIG_NET_ICMPv6_NEIGHBOR */
 
+  /* If the data of a regular file already lies contiguously in memory
+   * (XIP romfs, a tmpfs file of one page), it can be copied into the
+   * packet buffer directly instead of being read from the file for each
+   * segment.  FIOC_MMAP must not copy the file to satisfy the request;
+   * file systems that cannot map a file in place fail it, and the file is
+   * then read through the read buffer below.
+   */
+
+  if (file_ioctl(infile, FIOC_MMAP, (unsigned long)((uintptr_t)&map)) >= 0 &&
+      map != NULL && file_fstat(infile, &st) >= 0 &&
+      S_ISREG(st.st_mode) && foffset <= st.st_size)
+    {
+      if (count > st.st_size - foffset)
+        {
+          count = st.st_size - foffset;
+        }
+
+      map += foffset;
+    }
+  else
+    {
+      map = NULL;
+    }
+
   /* Initialize the state structure.  This is done with the network
    * locked because we don't want anything to happen until we are
    * ready.
@@ -513,9 +642,19 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
   nxsem_set_protocol(&state.snd_sem, SEM_PRIO_NONE);
 
   state.snd_sock    = psock;                /* Socket descriptor to use */
-  state.snd_foffset = offset ? *offset : 0; /* Input file offset */
+  state.snd_foffset = foffset;              /* Input file offset */
   state.snd_flen    = count;                /* Number of bytes to send */
   state.snd_file    = infile;               /* File to read from */
+  state.snd_map     = map;                  /* File data in memory */
+
+#if CONFIG_NET_SENDFILE_BUFSIZE > 0
+  /* Otherwise, read the file in large chunks if a buffer is available */
+
+  if (map == NULL && count > 0)
+    {
+      state.snd_buf = kmm_malloc(CONFIG_NET_SENDFILE_BUFSIZE);
+    }
+#endif
 
   /* Allocate resources to receive a callback */
 
@@ -585,6 +724,13 @@ errout_locked:
   nxsem_destroy(&state.snd_sem);
   net_unlock();
 
+#if CONFIG_NET_SENDFILE_BUFSIZE > 0
+  if (state.snd_buf != NULL)
+    {
+      kmm_free(state.snd_buf);
+    }
+#endif
+
   if (ret < 0)
     {
       return ret;
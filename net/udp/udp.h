@@ -46,6 +46,7 @@
 #include <sys/socket.h>
 #include <queue.h>
 
+#include <nuttx/net/net.h>
 #include <nuttx/net/ip.h>
 #include <nuttx/mm/iob.h>
 
@@ -123,6 +124,8 @@ struct udp_conn_s
 
   /* UDP-specific content follows */
 
+  dq_entry_t hnode;       /* Links a connection with a local port into its
+                           * hash chain (see udp_active()) */
   union ip_binding_u u;   /* IP address binding */
   uint16_t lport;         /* Bound local port number (network byte order) */
   uint16_t rport;         /* Remote port number (network byte order) */
@@ -140,9 +143,13 @@ struct udp_conn_s
    *
    *   readahead - A singly linked list of type struct iob_qentry_s
    *               where the UDP/IP read-ahead data is retained.
+   *   rdlock    - Protects readahead with CONFIG_NET_FINE_LOCKING.
    */
 
   struct iob_queue_s readahead;   /* Read-ahead buffering */
+#ifdef CONFIG_NET_FINE_LOCKING
+  net_finelock_t rdlock;          /* Read-ahead buffer lock */
+#endif
 
 #ifdef CONFIG_NET_UDP_WRITE_BUFFERS
   /* Write buffering
@@ -45,6 +45,7 @@
 #include <debug.h>
 
 #include <nuttx/net/netconfig.h>
+#include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/netstats.h>
 #include <nuttx/net/udp.h>
@@ -226,7 +227,10 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev,
 
   /* Add the new I/O buffer chain to the tail of the read-ahead queue */
 
+  net_finelock(&conn->rdlock);
   ret = iob_tryadd_queue(iob, &conn->readahead);
+  net_fineunlock(&conn->rdlock);
+
   if (ret < 0)
     {
       nerr("ERROR: Failed to queue the I/O buffer chain: %d\n", ret);
@@ -55,7 +55,7 @@
 #include <arch/irq.h>
 
 #include <nuttx/clock.h>
-#include <nuttx/semaphore.h>
+#include <nuttx/nuttx.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
@@ -74,6 +74,12 @@
 #define IPv4BUF ((struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 #define IPv6BUF ((struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 
+#if (CONFIG_NET_UDP_HASHSIZE & (CONFIG_NET_UDP_HASHSIZE - 1)) != 0
+#  error CONFIG_NET_UDP_HASHSIZE must be a power of two
+#endif
+
+#define UDP_HASHMASK (CONFIG_NET_UDP_HASHSIZE - 1)
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -85,30 +91,85 @@ struct udp_conn_s g_udp_connections[CONFIG_NET_UDP_CONNS];
 /* A list of all free UDP connections */
 
 static dq_queue_t g_free_udp_connections;
-static sem_t g_free_sem;
 
 /* A list of all allocated UDP connections */
 
 static dq_queue_t g_active_udp_connections;
 
+/* The connections with a local port, hashed on the local port */
+
+static dq_queue_t g_udp_porthash[CONFIG_NET_UDP_HASHSIZE];
+
+#ifdef CONFIG_NET_FINE_LOCKING
+/* Protects the lists and the hash chains.  Connections are added to the
+ * active list by udp_alloc() without the network lock, but they are only
+ * removed from it with the network lock held.  The hash chains are only
+ * accessed with this lock held.
+ */
+
+static net_finelock_t g_udp_tablelock;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: _udp_semtake() and _udp_semgive()
+ * Name: udp_hash
  *
  * Description:
- *   Take/give semaphore
+ *   Return the index of the hash chain for a local port (network order).
  *
  ****************************************************************************/
 
-static inline void _udp_semtake(FAR sem_t *sem)
+static inline unsigned int udp_hash(uint16_t lport)
 {
-  net_lockedwait_uninterruptible(sem);
+  uint32_t key = lport * 0x9e3779b1;
+
+  return (key ^ (key >> 16)) & UDP_HASHMASK;
 }
 
-#define _udp_semgive(sem) nxsem_post(sem)
+/****************************************************************************
+ * Name: udp_hashconn
+ *
+ * Description:
+ *   Return the connection that contains a hash chain entry (or NULL).
+ *
+ ****************************************************************************/
+
+static inline FAR struct udp_conn_s *udp_hashconn(FAR dq_entry_t *entry)
+{
+  return entry ? container_of(entry, struct udp_conn_s, hnode) : NULL;
+}
+
+/****************************************************************************
+ * Name: udp_setlport
+ *
+ * Description:
+ *   Set the local port of a connection (in network order, zero if none)
+ *   and move the connection to the matching hash chain.  The local port of
+ *   a connection must not be modified in any other way.
+ *
+ ****************************************************************************/
+
+static void udp_setlport(FAR struct udp_conn_s *conn, uint16_t lport)
+{
+  net_finelock(&g_udp_tablelock);
+
+  if (conn->lport != 0)
+    {
+      dq_rem(&conn->hnode, &g_udp_porthash[udp_hash(conn->lport)]);
+    }
+
+  conn->lport = lport;
+
+  if (lport != 0)
+    {
+      dq_addlast(&conn->hnode, &g_udp_porthash[udp_hash(lport)]);
+    }
+
+  net_fineunlock(&g_udp_tablelock);
+}
 
 /****************************************************************************
  * Name: udp_find_conn()
@@ -126,14 +187,15 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
                                             uint16_t portno)
 {
   FAR struct udp_conn_s *conn;
-  int i;
 
-  /* Now search each connection structure. */
+  /* Now search each connection structure in the hash chain of the port */
 
-  for (i = 0; i < CONFIG_NET_UDP_CONNS; i++)
-    {
-      conn = &g_udp_connections[i];
+  net_finelock(&g_udp_tablelock);
 
+  for (conn = udp_hashconn(g_udp_porthash[udp_hash(portno)].head);
+       conn != NULL;
+       conn = udp_hashconn(conn->hnode.flink))
+    {
       /* If the port local port number assigned to the connections matches
        * AND the IP address of the connection matches, then return a
        * reference to the connection structure.  INADDR_ANY is a special
@@ -149,7 +211,7 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
               (net_ipv4addr_cmp(conn->u.ipv4.laddr, ipaddr->ipv4.laddr) ||
                net_ipv4addr_cmp(conn->u.ipv4.laddr, INADDR_ANY)))
             {
-              return conn;
+              break;
             }
         }
 #endif /* CONFIG_NET_IPv4 */
@@ -163,13 +225,14 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
               (net_ipv6addr_cmp(conn->u.ipv6.laddr, ipaddr->ipv6.laddr) ||
                net_ipv6addr_cmp(conn->u.ipv6.laddr, g_ipv6_unspecaddr)))
             {
-              return conn;
+              break;
             }
         }
 #endif /* CONFIG_NET_IPv6 */
     }
 
-  return NULL;
+  net_fineunlock(&g_udp_tablelock);
+  return conn;
 }
 
 /****************************************************************************
@@ -264,8 +327,10 @@ static inline FAR struct udp_conn_s *
   FAR struct ipv4_hdr_s *ip = IPv4BUF;
   FAR struct udp_conn_s *conn;
 
-  conn = (FAR struct udp_conn_s *)g_active_udp_connections.head;
-  while (conn)
+  /* Only the connections in the hash chain of the port can match */
+
+  conn = udp_hashconn(g_udp_porthash[udp_hash(udp->destport)].head);
+  while (conn != NULL)
     {
       /* If the local UDP port is non-zero, the connection is considered
        * to be used. If so, then the following checks are performed:
@@ -375,9 +440,9 @@ static inline FAR struct udp_conn_s *
             }
         }
 
-      /* Look at the next active connection */
+      /* Look at the next connection in the hash chain */
 
-      conn = (FAR struct udp_conn_s *)conn->node.flink;
+      conn = udp_hashconn(conn->hnode.flink);
     }
 
   return conn;
@@ -403,7 +468,9 @@ static inline FAR struct udp_conn_s *
   FAR struct ipv6_hdr_s *ip = IPv6BUF;
   FAR struct udp_conn_s *conn;
 
-  conn = (FAR struct udp_conn_s *)g_active_udp_connections.head;
+  /* Only the connections in the hash chain of the port can match */
+
+  conn = udp_hashconn(g_udp_porthash[udp_hash(udp->destport)].head);
   while (conn != NULL)
     {
       /* If the local UDP port is non-zero, the connection is considered
@@ -514,9 +581,9 @@ static inline FAR struct udp_conn_s *
             }
         }
 
-      /* Look at the next active connection */
+      /* Look at the next connection in the hash chain */
 
-      conn = (FAR struct udp_conn_s *)conn->node.flink;
+      conn = udp_hashconn(conn->hnode.flink);
     }
 
   return conn;
@@ -544,13 +611,19 @@ void udp_initialize(void)
 
   dq_init(&g_free_udp_connections);
   dq_init(&g_active_udp_connections);
-  nxsem_init(&g_free_sem, 0, 1);
+  net_finelock_init(&g_udp_tablelock);
+
+  for (i = 0; i < CONFIG_NET_UDP_HASHSIZE; i++)
+    {
+      dq_init(&g_udp_porthash[i]);
+    }
 
   for (i = 0; i < CONFIG_NET_UDP_CONNS; i++)
     {
       /* Mark the connection closed and move it to the free list */
 
       g_udp_connections[i].lport = 0;
+      net_finelock_init(&g_udp_connections[i].rdlock);
       dq_addlast(&g_udp_connections[i].node, &g_free_udp_connections);
     }
 }
@@ -568,9 +641,9 @@ FAR struct udp_conn_s *udp_alloc(uint8_t domain)
 {
   FAR struct udp_conn_s *conn;
 
-  /* The free list is protected by a semaphore (that behaves like a mutex). */
+  /* The free list is protected by the connection table lock */
 
-  _udp_semtake(&g_free_sem);
+  net_finelock(&g_udp_tablelock);
   conn = (FAR struct udp_conn_s *)dq_remfirst(&g_free_udp_connections);
   if (conn)
     {
@@ -596,7 +669,7 @@ FAR struct udp_conn_s *udp_alloc(uint8_t domain)
       dq_addlast(&conn->node, &g_active_udp_connections);
     }
 
-  _udp_semgive(&g_free_sem);
+  net_fineunlock(&g_udp_tablelock);
   return conn;
 }
 
@@ -615,20 +688,23 @@ void udp_free(FAR struct udp_conn_s *conn)
   FAR struct udp_wrbuffer_s *wrbuffer;
 #endif
 
-  /* The free list is protected by a semaphore (that behaves like a mutex). */
+  /* The free list is protected by the connection table lock */
 
   DEBUGASSERT(conn->crefs == 0);
 
-  _udp_semtake(&g_free_sem);
-  conn->lport = 0;
+  udp_setlport(conn, 0);
 
   /* Remove the connection from the active list */
 
+  net_finelock(&g_udp_tablelock);
   dq_rem(&conn->node, &g_active_udp_connections);
+  net_fineunlock(&g_udp_tablelock);
 
   /* Release any read-ahead buffers attached to the connection */
 
+  net_finelock(&conn->rdlock);
   iob_free_queue(&conn->readahead, IOBUSER_NET_UDP_READAHEAD);
+  net_fineunlock(&conn->rdlock);
 
 #ifdef CONFIG_NET_UDP_WRITE_BUFFERS
   /* Release any write buffers attached to the connection */
@@ -642,8 +718,9 @@ void udp_free(FAR struct udp_conn_s *conn)
 
   /* Free the connection */
 
+  net_finelock(&g_udp_tablelock);
   dq_addlast(&conn->node, &g_free_udp_connections);
-  _udp_semgive(&g_free_sem);
+  net_fineunlock(&g_udp_tablelock);
 }
 
 /****************************************************************************
@@ -661,12 +738,20 @@ void udp_free(FAR struct udp_conn_s *conn)
 FAR struct udp_conn_s *udp_active(FAR struct net_driver_s *dev,
                                   FAR struct udp_hdr_s *udp)
 {
+  FAR struct udp_conn_s *conn;
+
+  /* udp_alloc() may add connections to the active list without the network
+   * lock.
+   */
+
+  net_finelock(&g_udp_tablelock);
+
 #ifdef CONFIG_NET_IPv6
 #ifdef CONFIG_NET_IPv4
   if (IFF_IS_IPv6(dev->d_flags))
 #endif
     {
-      return udp_ipv6_active(dev, udp);
+      conn = udp_ipv6_active(dev, udp);
     }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -675,9 +760,12 @@ FAR struct udp_conn_s *udp_active(FAR struct net_driver_s *dev,
   else
 #endif
     {
-      return udp_ipv4_active(dev, udp);
+      conn = udp_ipv4_active(dev, udp);
     }
 #endif /* CONFIG_NET_IPv4 */
+
+  net_fineunlock(&g_udp_tablelock);
+  return conn;
 }
 
 /****************************************************************************
@@ -693,14 +781,18 @@ FAR struct udp_conn_s *udp_active(FAR struct net_driver_s *dev,
 
 FAR struct udp_conn_s *udp_nextconn(FAR struct udp_conn_s *conn)
 {
+  net_finelock(&g_udp_tablelock);
   if (!conn)
     {
-      return (FAR struct udp_conn_s *)g_active_udp_connections.head;
+      conn = (FAR struct udp_conn_s *)g_active_udp_connections.head;
     }
   else
     {
-      return (FAR struct udp_conn_s *)conn->node.flink;
+      conn = (FAR struct udp_conn_s *)conn->node.flink;
     }
+
+  net_fineunlock(&g_udp_tablelock);
+  return conn;
 }
 
 /****************************************************************************
@@ -769,8 +861,8 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
     {
       /* Yes.. Select any unused local port number */
 
-      conn->lport = htons(udp_select_port(conn->domain, &conn->u));
-      ret         = OK;
+      udp_setlport(conn, htons(udp_select_port(conn->domain, &conn->u)));
+      ret = OK;
     }
   else
     {
@@ -786,12 +878,12 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
         {
           /* No.. then bind the socket to the port */
 
-          conn->lport = portno;
-          ret         = OK;
+          udp_setlport(conn, portno);
+          ret = OK;
         }
       else
         {
-          ret         = -EADDRINUSE;
+          ret = -EADDRINUSE;
         }
 
       net_unlock();
@@ -839,7 +931,7 @@ int udp_connect(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
        * connection structure.
        */
 
-      conn->lport = htons(udp_select_port(conn->domain, &conn->u));
+      udp_setlport(conn, htons(udp_select_port(conn->domain, &conn->u)));
     }
 
   /* Is there a remote port (rport)? */
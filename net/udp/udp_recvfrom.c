@@ -202,14 +202,18 @@ static inline void udp_readahead(struct udp_recvfrom_s *pstate)
   int recvlen;
 
   /* Check there is any UDP datagram already buffered in a read-ahead
-   * buffer.
+   * buffer.  The datagram is removed from the read-ahead queue with only
+   * the read-ahead buffers locked; after that, nobody else can reach it.
    */
 
   pstate->ir_recvlen = -1;
 
-  if ((iob = iob_peek_queue(&conn->readahead)) != NULL)
+  net_finelock(&conn->rdlock);
+  iob = iob_remove_queue(&conn->readahead);
+  net_fineunlock(&conn->rdlock);
+
+  if (iob != NULL)
     {
-      FAR struct iob_s *tmp;
       uint8_t src_addr_size;
 
       DEBUGASSERT(iob->io_pktlen > 0);
@@ -267,14 +271,6 @@ static inline void udp_readahead(struct udp_recvfrom_s *pstate)
         }
 
 out:
-      /* Remove the I/O buffer chain from the head of the read-ahead
-       * buffer queue.
-       */
-
-      tmp = iob_remove_queue(&conn->readahead);
-      DEBUGASSERT(tmp == iob);
-      UNUSED(tmp);
-
       /* And free the I/O buffer chain */
 
       iob_free_chain(iob, IOBUSER_NET_UDP_READAHEAD);
@@ -621,14 +617,11 @@ ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR void *buf,
 
   /* Perform the UDP recvfrom() operation */
 
-  /* Initialize the state structure.  This is done with the network locked
-   * because we don't want anything to happen until we are ready.
-   */
-
-  net_lock();
   udp_recvfrom_initialize(psock, buf, len, from, fromlen, &state);
 
-  /* Copy the read-ahead data from the packet */
+  /* Copy the read-ahead data from the packet.  This does not require the
+   * network lock.
+   */
 
   udp_readahead(&state);
 
@@ -666,6 +659,24 @@ ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR void *buf,
 
   else if (state.ir_recvlen <= 0)
     {
+      /* Lock the network because we don't want anything to happen until we
+       * are ready.  A datagram may have been buffered after we looked into
+       * the read-ahead buffers, so look again.
+       */
+
+      net_lock();
+      if (state.ir_recvlen < 0)
+        {
+          udp_readahead(&state);
+          ret = state.ir_recvlen;
+        }
+
+      if (state.ir_recvlen > 0)
+        {
+          net_unlock();
+          goto out;
+        }
+
       /* Get the device that will handle the packet transfers.  This may be
        * NULL if the UDP socket is bound to INADDR_ANY.  In that case, no
        * NETDEV_DOWN notifications will be received.
@@ -704,9 +715,11 @@ ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR void *buf,
         {
           ret = -EBUSY;
         }
+
+      net_unlock();
     }
 
-  net_unlock();
+out:
   udp_recvfrom_uninitialize(&state);
   return ret;
 }
@@ -107,7 +107,9 @@
  * task, is always the IDLE task.
  */
 
+#if !defined(CONFIG_SMP) || !defined(CONFIG_SMP_PERCPU_READYTORUN)
 volatile dq_queue_t g_readytorun;
+#endif
 
 #ifdef CONFIG_SMP
 /* In order to support SMP, the function of the g_readytorun list changes,
@@ -142,6 +144,14 @@ volatile dq_queue_t g_readytorun;
 
 volatile dq_queue_t g_assignedtasks[CONFIG_SMP_NCPUS];
 
+/* With CONFIG_SMP_PERCPU_READYTORUN, each CPU has its own list of ready-to-
+ * run tasks instead of the global g_readytorun list.
+ */
+
+#ifdef CONFIG_SMP_PERCPU_READYTORUN
+volatile dq_queue_t g_cpureadytorun[CONFIG_SMP_NCPUS];
+#endif
+
 /* g_running_tasks[] holds a references to the running task for each cpu.
  * It is valid only when up_interrupt_context() returns true.
  */
@@ -241,8 +251,13 @@ const struct tasklist_s g_tasklisttable[NUM_TASK_STATES] =
   },
 #ifdef CONFIG_SMP
   {                                              /* TSTATE_TASK_READYTORUN */
+#ifdef CONFIG_SMP_PERCPU_READYTORUN
+    g_cpureadytorun,
+    TLIST_ATTR_PRIORITIZED | TLIST_ATTR_INDEXED
+#else
     &g_readytorun,
     TLIST_ATTR_PRIORITIZED
+#endif
   },
   {                                              /* TSTATE_TASK_ASSIGNED */
     g_assignedtasks,
@@ -382,7 +397,9 @@ void nx_start(void)
 
   /* Initialize all task lists */
 
+#if !defined(CONFIG_SMP) || !defined(CONFIG_SMP_PERCPU_READYTORUN)
   dq_init(&g_readytorun);
+#endif
   dq_init(&g_pendingtasks);
   dq_init(&g_waitingforsemaphore);
   dq_init(&g_waitingforsignal);
@@ -402,6 +419,9 @@ void nx_start(void)
   for (i = 0; i < CONFIG_SMP_NCPUS; i++)
     {
       dq_init(&g_assignedtasks[i]);
+#ifdef CONFIG_SMP_PERCPU_READYTORUN
+      dq_init(&g_cpureadytorun[i]);
+#endif
     }
 #endif
 
@@ -66,6 +66,12 @@ sq_queue_t  g_msgfreeirq;
 
 sq_queue_t  g_desfree;
 
+#ifdef CONFIG_MM_MEMPOOL
+/* The pool of messages that are allocated when g_msgfree is empty */
+
+struct mempool_s g_msgdynpool;
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -174,6 +180,19 @@ void nxmq_initialize(void)
   /* Allocate a block of message queue descriptors */
 
   nxmq_alloc_desblock();
+
+#ifdef CONFIG_MM_MEMPOOL
+  /* Messages beyond CONFIG_PREALLOC_MQ_MSGS are taken from a pool that
+   * grows on demand.  The pool uses a critical section like the other
+   * message free lists.
+   */
+
+  g_msgdynpool.bsize     = sizeof(struct mqueue_msg_s);
+  g_msgdynpool.ninitial  = 0;
+  g_msgdynpool.nexpand   = MQ_DYNPOOL_NEXPAND;
+  g_msgdynpool.interrupt = true;
+  mempool_init(&g_msgdynpool, "mqueue");
+#endif
 }
 
 /****************************************************************************
@@ -42,9 +42,11 @@
  * Description:
  *   The nxmq_free_msg function will return a message to the free pool of
  *   messages if it was a pre-allocated message. If the message was
- *   allocated dynamically it will be deallocated.
+ *   allocated dynamically it will be deallocated.  Messages taken from the
+ *   message pool of a message queue are returned to that pool.
  *
  * Input Parameters:
+ *   msgq  - The message queue that the message was allocated for
  *   mqmsg - message to free
  *
  * Returned Value:
@@ -52,7 +54,8 @@
  *
  ****************************************************************************/
 
-void nxmq_free_msg(FAR struct mqueue_msg_s *mqmsg)
+void nxmq_free_msg(FAR struct mqueue_inode_s *msgq,
+                   FAR struct mqueue_msg_s *mqmsg)
 {
   irqstate_t flags;
 
@@ -86,6 +89,19 @@ void nxmq_free_msg(FAR struct mqueue_msg_s *mqmsg)
       leave_critical_section(flags);
     }
 
+#ifdef CONFIG_MQ_MSGPOOL
+  /* If this message belongs to the message pool of the message queue,
+   * then put it back in the pool.
+   */
+
+  else if (mqmsg->type == MQ_ALLOC_POOL)
+    {
+      flags = enter_critical_section();
+      sq_addlast((FAR sq_entry_t *)mqmsg, &msgq->msgfree);
+      leave_critical_section(flags);
+    }
+#endif
+
   /* Otherwise, deallocate it.  Note:  interrupt handlers
    * will never deallocate messages because they will not
    * received them.
@@ -93,7 +109,11 @@ void nxmq_free_msg(FAR struct mqueue_msg_s *mqmsg)
 
   else if (mqmsg->type == MQ_ALLOC_DYN)
     {
+#ifdef CONFIG_MM_MEMPOOL
+      mempool_free(&g_msgdynpool, mqmsg);
+#else
       kmm_free(mqmsg);
+#endif
     }
   else
     {
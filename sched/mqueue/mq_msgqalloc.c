@@ -61,6 +61,11 @@ FAR struct mqueue_inode_s *nxmq_alloc_msgq(mode_t mode,
                                            FAR struct mq_attr *attr)
 {
   FAR struct mqueue_inode_s *msgq;
+#ifdef CONFIG_MQ_MSGPOOL
+  FAR uint8_t *msg;
+  size_t msgsize;
+  int i;
+#endif
 
   /* Check if the caller is attempting to allocate a message for messages
    * larger than the configured maximum message size.
@@ -94,6 +99,31 @@ FAR struct mqueue_inode_s *nxmq_alloc_msgq(mode_t mode,
         }
 
       msgq->ntpid = INVALID_PROCESS_ID;
+
+#ifdef CONFIG_MQ_MSGPOOL
+      /* Pre-allocate one message buffer for each message that the queue
+       * can hold.  Each buffer is sized to the queue's maximum message
+       * size rather than to CONFIG_MQ_MAXMSGSIZE.
+       */
+
+      sq_init(&msgq->msgfree);
+
+      msgsize = MQ_MSG_SIZE(msgq->maxmsgsize);
+      msgq->msgpool = kmm_malloc(msgq->maxmsgs * msgsize);
+      if (msgq->msgpool == NULL)
+        {
+          kmm_free(msgq);
+          return NULL;
+        }
+
+      msg = (FAR uint8_t *)msgq->msgpool;
+      for (i = 0; i < msgq->maxmsgs; i++)
+        {
+          ((FAR struct mqueue_msg_s *)msg)->type = MQ_ALLOC_POOL;
+          sq_addlast((FAR sq_entry_t *)msg, &msgq->msgfree);
+          msg += msgsize;
+        }
+#endif
     }
 
   return msgq;
@@ -24,6 +24,7 @@
 
 #include <nuttx/config.h>
 
+#include <assert.h>
 #include <debug.h>
 #include <nuttx/kmalloc.h>
 #include "mqueue/mqueue.h"
@@ -55,6 +56,14 @@ void nxmq_free_msgq(FAR struct mqueue_inode_s *msgq)
   FAR struct mqueue_msg_s *curr;
   FAR struct mqueue_msg_s *next;
 
+#ifdef CONFIG_MQ_ZEROCOPY
+  /* Loaned message buffers must be returned before the queue goes away.
+   * They may belong to its message pool and they are returned to it.
+   */
+
+  DEBUGASSERT(msgq->nloaned == 0);
+#endif
+
   /* Deallocate any stranded messages in the message queue. */
 
   curr = (FAR struct mqueue_msg_s *)msgq->msglist.head;
@@ -63,10 +72,21 @@ void nxmq_free_msgq(FAR struct mqueue_inode_s *msgq)
       /* Deallocate the message structure. */
 
       next = curr->next;
-      nxmq_free_msg(curr);
+      nxmq_free_msg(msgq, curr);
       curr = next;
     }
 
+#ifdef CONFIG_MQ_MSGPOOL
+  /* Release the message pool.  Any pool messages still queued above were
+   * just returned to the pool and go away with it.
+   */
+
+  if (msgq->msgpool != NULL)
+    {
+      kmm_free(msgq->msgpool);
+    }
+
+#endif
   /* Then deallocate the message queue itself */
 
   kmm_free(msgq);
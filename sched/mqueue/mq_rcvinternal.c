@@ -211,6 +211,62 @@ int nxmq_wait_receive(mqd_t mqdes, FAR struct mqueue_msg_s **rcvmsg)
   return OK;
 }
 
+/****************************************************************************
+ * Name: nxmq_wake_sender
+ *
+ * Description:
+ *   Unblock the highest priority task that is waiting for the message
+ *   queue to become non-full, if there is one.  This is called after a
+ *   message has been removed from the queue.
+ *
+ * Input Parameters:
+ *   msgq - The message queue that a message was just removed from
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ * - Pre-emption should be disabled throughout this call.
+ *
+ ****************************************************************************/
+
+void nxmq_wake_sender(FAR struct mqueue_inode_s *msgq)
+{
+  FAR struct tcb_s *btcb;
+  irqstate_t flags;
+
+  /* Check if any tasks are waiting for the MQ not full event. */
+
+  if (msgq->nwaitnotfull > 0)
+    {
+      /* Find the highest priority task that is waiting for
+       * this queue to be not-full in g_waitingformqnotfull list.
+       * This must be performed in a critical section because
+       * messages can be sent from interrupt handlers.
+       */
+
+      flags = enter_critical_section();
+      for (btcb = (FAR struct tcb_s *)g_waitingformqnotfull.head;
+           btcb && btcb->msgwaitq != msgq;
+           btcb = btcb->flink)
+        {
+        }
+
+      /* If one was found, unblock it.  NOTE:  There is a race
+       * condition here:  the queue might be full again by the
+       * time the task is unblocked
+       */
+
+      DEBUGASSERT(btcb != NULL);
+
+      btcb->msgwaitq = NULL;
+      msgq->nwaitnotfull--;
+      up_unblock_task(btcb);
+
+      leave_critical_section(flags);
+    }
+}
+
 /****************************************************************************
  * Name: nxmq_do_receive
  *
@@ -243,9 +299,6 @@ int nxmq_wait_receive(mqd_t mqdes, FAR struct mqueue_msg_s **rcvmsg)
 ssize_t nxmq_do_receive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
                         FAR char *ubuffer, unsigned int *prio)
 {
-  FAR struct tcb_s *btcb;
-  irqstate_t flags;
-  FAR struct mqueue_inode_s *msgq;
   ssize_t rcvmsglen;
 
   /* Get the length of the message (also the return value) */
@@ -265,39 +318,11 @@ ssize_t nxmq_do_receive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
 
   /* We are done with the message.  Deallocate it now. */
 
-  nxmq_free_msg(mqmsg);
+  nxmq_free_msg(mqdes->msgq, mqmsg);
 
-  /* Check if any tasks are waiting for the MQ not full event. */
-
-  msgq = mqdes->msgq;
-  if (msgq->nwaitnotfull > 0)
-    {
-      /* Find the highest priority task that is waiting for
-       * this queue to be not-full in g_waitingformqnotfull list.
-       * This must be performed in a critical section because
-       * messages can be sent from interrupt handlers.
-       */
+  /* Wake up any task that was waiting for the MQ not full event. */
 
-      flags = enter_critical_section();
-      for (btcb = (FAR struct tcb_s *)g_waitingformqnotfull.head;
-           btcb && btcb->msgwaitq != msgq;
-           btcb = btcb->flink)
-        {
-        }
-
-      /* If one was found, unblock it.  NOTE:  There is a race
-       * condition here:  the queue might be full again by the
-       * time the task is unblocked
-       */
-
-      DEBUGASSERT(btcb != NULL);
-
-      btcb->msgwaitq = NULL;
-      msgq->nwaitnotfull--;
-      up_unblock_task(btcb);
-
-      leave_critical_section(flags);
-    }
+  nxmq_wake_sender(mqdes->msgq);
 
   /* Return the length of the message transferred to the user buffer */
 
@@ -99,8 +99,9 @@ int nxmq_verify_send(mqd_t mqdes, FAR const char *msg, size_t msglen,
  *
  * Description:
  *   The nxmq_alloc_msg function will get a free message for use by the
- *   operating system.  The message will be allocated from the g_msgfree
- *   list.
+ *   operating system.  If the message queue has its own message pool, the
+ *   message is taken from that pool first.  Otherwise, the message will be
+ *   allocated from the g_msgfree list.
  *
  *   If the list is empty AND the message is NOT being allocated from the
  *   interrupt level, then the message will be allocated.  If a message
@@ -113,7 +114,7 @@ int nxmq_verify_send(mqd_t mqdes, FAR const char *msg, size_t msglen,
  *   handler will be notified.
  *
  * Input Parameters:
- *   None
+ *   msgq - The message queue that the message will be sent to
  *
  * Returned Value:
  *   A reference to the allocated msg structure.  On a failure to allocate,
@@ -121,11 +122,26 @@ int nxmq_verify_send(mqd_t mqdes, FAR const char *msg, size_t msglen,
  *
  ****************************************************************************/
 
-FAR struct mqueue_msg_s *nxmq_alloc_msg(void)
+FAR struct mqueue_msg_s *nxmq_alloc_msg(FAR struct mqueue_inode_s *msgq)
 {
   FAR struct mqueue_msg_s *mqmsg;
   irqstate_t flags;
 
+#ifdef CONFIG_MQ_MSGPOOL
+  /* Try the per-queue message pool first.  Pool messages are sized to the
+   * queue's maximum message size and never touch the heap.
+   */
+
+  flags = enter_critical_section();
+  mqmsg = (FAR struct mqueue_msg_s *)sq_remfirst(&msgq->msgfree);
+  leave_critical_section(flags);
+
+  if (mqmsg != NULL)
+    {
+      return mqmsg;
+    }
+
+#endif
   /* If we were called from an interrupt handler, then try to get the message
    * from generally available list of messages. If this fails, then try the
    * list of messages reserved for interrupt handlers
@@ -162,8 +178,12 @@ FAR struct mqueue_msg_s *nxmq_alloc_msg(void)
 
       if (mqmsg == NULL)
         {
+#ifdef CONFIG_MM_MEMPOOL
+          mqmsg = (FAR struct mqueue_msg_s *)mempool_alloc(&g_msgdynpool);
+#else
           mqmsg = (FAR struct mqueue_msg_s *)
             kmm_malloc((sizeof (struct mqueue_msg_s)));
+#endif
 
           /* Check if we allocated the message */
 
@@ -339,9 +359,14 @@ int nxmq_do_send(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
   mqmsg->priority = prio;
   mqmsg->msglen   = msglen;
 
-  /* Copy the message data into the message */
+  /* Copy the message data into the message.  There is nothing to copy if
+   * the caller built the message in place (zero-copy send).
+   */
 
-  memcpy((FAR void *)mqmsg->mail, (FAR const void *)msg, msglen);
+  if (msg != mqmsg->mail)
+    {
+      memcpy((FAR void *)mqmsg->mail, (FAR const void *)msg, msglen);
+    }
 
   /* Insert the new message in the message queue */
 
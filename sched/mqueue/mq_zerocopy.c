@@ -0,0 +1,394 @@
+/****************************************************************************
+ *  sched/mqueue/mq_zerocopy.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <fcntl.h>
+#include <mqueue.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/cancelpt.h>
+#include <nuttx/mqueue.h>
+
+#include "mqueue/mqueue.h"
+
+#ifdef CONFIG_MQ_ZEROCOPY
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmq_alloc_buffer
+ *
+ * Description:
+ *   Loan a message buffer of the message queue to the caller.  The message
+ *   can then be built in place and sent with nxmq_send_buffer().
+ *
+ * Input Parameters:
+ *   mqdes  - Message queue descriptor
+ *   buffer - The location to return the message buffer
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+int nxmq_alloc_buffer(mqd_t mqdes, FAR void **buffer)
+{
+  FAR struct mqueue_msg_s *mqmsg;
+  irqstate_t flags;
+
+  if (mqdes == NULL || buffer == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if ((mqdes->oflags & O_WROK) == 0)
+    {
+      return -EPERM;
+    }
+
+  mqmsg = nxmq_alloc_msg(mqdes->msgq);
+  if (mqmsg == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  flags = enter_critical_section();
+  mqdes->msgq->nloaned++;
+  leave_critical_section(flags);
+
+  *buffer = mqmsg->mail;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxmq_send_buffer
+ *
+ * Description:
+ *   Send a message buffer that was loaned with nxmq_alloc_buffer().  This
+ *   behaves like nxmq_send() except that the message data is not copied.
+ *
+ * Input Parameters:
+ *   mqdes  - Message queue descriptor
+ *   buffer - The message buffer that holds the message
+ *   msglen - The length of the message in bytes
+ *   prio   - The priority of the message
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned
+ *   on failure.  The caller still owns the buffer on failure.
+ *
+ ****************************************************************************/
+
+int nxmq_send_buffer(mqd_t mqdes, FAR void *buffer, size_t msglen,
+                     unsigned int prio)
+{
+  FAR struct mqueue_inode_s *msgq;
+  irqstate_t flags;
+  int ret;
+
+  ret = nxmq_verify_send(mqdes, buffer, msglen, prio);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Wait for the message queue to become non-FULL, exactly as nxmq_send()
+   * does.  Only the message allocation and the copy are skipped.
+   */
+
+  sched_lock();
+  msgq  = mqdes->msgq;
+  flags = enter_critical_section();
+
+  if (!up_interrupt_context() && msgq->nmsgs >= msgq->maxmsgs)
+    {
+      ret = nxmq_wait_send(mqdes);
+    }
+
+  if (ret >= 0)
+    {
+      /* The buffer belongs to the message queue again */
+
+      DEBUGASSERT(msgq->nloaned > 0);
+      msgq->nloaned--;
+    }
+
+  leave_critical_section(flags);
+  if (ret >= 0)
+    {
+      ret = nxmq_do_send(mqdes, MQ_BUFFER2MSG(buffer), buffer, msglen,
+                         prio);
+    }
+
+  sched_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxmq_receive_buffer
+ *
+ * Description:
+ *   Receive the oldest of the highest priority messages from the message
+ *   queue without copying it.  The caller owns the returned buffer and must
+ *   give it back with nxmq_free_buffer().
+ *
+ * Input Parameters:
+ *   mqdes  - Message Queue Descriptor
+ *   buffer - The location to return the message buffer
+ *   prio   - If not NULL, the location to store message priority.
+ *
+ * Returned Value:
+ *   The length of the message is returned on success.  A negated errno
+ *   value is returned on failure.
+ *
+ ****************************************************************************/
+
+ssize_t nxmq_receive_buffer(mqd_t mqdes, FAR void **buffer,
+                            FAR unsigned int *prio)
+{
+  FAR struct mqueue_msg_s *mqmsg;
+  irqstate_t flags;
+  ssize_t ret;
+
+  DEBUGASSERT(up_interrupt_context() == false);
+
+  if (mqdes == NULL || buffer == NULL)
+    {
+      return -EINVAL;
+    }
+
+  ret = nxmq_verify_receive(mqdes, (FAR char *)buffer,
+                            mqdes->msgq->maxmsgsize);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  sched_lock();
+  flags = enter_critical_section();
+  ret = nxmq_wait_receive(mqdes, &mqmsg);
+  if (ret >= 0)
+    {
+      mqdes->msgq->nloaned++;
+    }
+
+  leave_critical_section(flags);
+
+  if (ret >= 0)
+    {
+      DEBUGASSERT(mqmsg != NULL);
+
+      /* Hand the message to the caller instead of copying it out, then
+       * let any sender blocked on the full queue proceed.
+       */
+
+      *buffer = mqmsg->mail;
+      if (prio)
+        {
+          *prio = mqmsg->priority;
+        }
+
+      ret = mqmsg->msglen;
+      nxmq_wake_sender(mqdes->msgq);
+    }
+
+  sched_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxmq_free_buffer
+ *
+ * Description:
+ *   Return a message buffer obtained from nxmq_alloc_buffer() or
+ *   nxmq_receive_buffer() to the message queue.
+ *
+ * Input Parameters:
+ *   mqdes  - Message Queue Descriptor
+ *   buffer - The message buffer
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxmq_free_buffer(mqd_t mqdes, FAR void *buffer)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(mqdes != NULL && buffer != NULL);
+
+  flags = enter_critical_section();
+  DEBUGASSERT(mqdes->msgq->nloaned > 0);
+  mqdes->msgq->nloaned--;
+  leave_critical_section(flags);
+
+  nxmq_free_msg(mqdes->msgq, MQ_BUFFER2MSG(buffer));
+}
+
+/****************************************************************************
+ * Name: mq_alloc_buffer
+ *
+ * Description:
+ *   Loan a message buffer of the message queue to the caller.  The message
+ *   can then be built in place and sent with mq_send_buffer().  This is a
+ *   non-standard extension.
+ *
+ * Input Parameters:
+ *   mqdes  - Message queue descriptor
+ *   buffer - The location to return the message buffer
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  On failure, -1 (ERROR) is returned
+ *   and the errno is set appropriately (see nxmq_alloc_buffer()).
+ *
+ ****************************************************************************/
+
+int mq_alloc_buffer(mqd_t mqdes, FAR void **buffer)
+{
+  int ret;
+
+  ret = nxmq_alloc_buffer(mqdes, buffer);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mq_send_buffer
+ *
+ * Description:
+ *   Send a message buffer that was loaned with mq_alloc_buffer().  This
+ *   behaves like mq_send() except that the message data is not copied.
+ *   This is a non-standard extension.
+ *
+ * Input Parameters:
+ *   mqdes  - Message queue descriptor
+ *   buffer - The message buffer that holds the message
+ *   msglen - The length of the message in bytes
+ *   prio   - The priority of the message
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  On failure, -1 (ERROR) is returned
+ *   and the errno is set appropriately (see mq_send()).  The caller still
+ *   owns the buffer on failure.
+ *
+ ****************************************************************************/
+
+int mq_send_buffer(mqd_t mqdes, FAR void *buffer, size_t msglen,
+                   unsigned int prio)
+{
+  int ret;
+
+  /* mq_send_buffer() is a cancellation point */
+
+  enter_cancellation_point();
+
+  ret = nxmq_send_buffer(mqdes, buffer, msglen, prio);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mq_receive_buffer
+ *
+ * Description:
+ *   Receive the oldest of the highest priority messages from the message
+ *   queue without copying it.  The caller owns the returned buffer and must
+ *   give it back with mq_free_buffer().  This is a non-standard extension.
+ *
+ * Input Parameters:
+ *   mqdes  - Message Queue Descriptor
+ *   buffer - The location to return the message buffer
+ *   prio   - If not NULL, the location to store message priority.
+ *
+ * Returned Value:
+ *   The length of the message is returned on success.  On failure, -1
+ *   (ERROR) is returned and the errno is set appropriately (see
+ *   mq_receive()).
+ *
+ ****************************************************************************/
+
+ssize_t mq_receive_buffer(mqd_t mqdes, FAR void **buffer,
+                          FAR unsigned int *prio)
+{
+  ssize_t ret;
+
+  /* mq_receive_buffer() is a cancellation point */
+
+  enter_cancellation_point();
+
+  ret = nxmq_receive_buffer(mqdes, buffer, prio);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mq_free_buffer
+ *
+ * Description:
+ *   Return a message buffer obtained from mq_alloc_buffer() or
+ *   mq_receive_buffer() to the message queue.  This is a non-standard
+ *   extension.
+ *
+ * Input Parameters:
+ *   mqdes  - Message Queue Descriptor
+ *   buffer - The message buffer
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mq_free_buffer(mqd_t mqdes, FAR void *buffer)
+{
+  nxmq_free_buffer(mqdes, buffer);
+}
+
+#endif /* CONFIG_MQ_ZEROCOPY */
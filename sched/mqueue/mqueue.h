@@ -29,6 +29,7 @@
 #include <nuttx/compiler.h>
 
 #include <sys/types.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <limits.h>
@@ -36,6 +37,7 @@
 #include <sched.h>
 
 #include <nuttx/mqueue.h>
+#include <nuttx/mm/mempool.h>
 
 #if CONFIG_MQ_MAXMSGSIZE > 0
 
@@ -59,6 +61,26 @@
 
 #define NUM_INTERRUPT_MSGS   8
 
+/* This defines the number of messages that are added to g_msgdynpool each
+ * time that it runs empty.
+ */
+
+#define MQ_DYNPOOL_NEXPAND   8
+
+/* The size of a message with room for 'n' bytes of message data, rounded up
+ * so that messages can be allocated back to back.
+ */
+
+#define MQ_MSG_SIZE(n) \
+  ((offsetof(struct mqueue_msg_s, mail) + (n) + sizeof(uintptr_t) - 1) & \
+   ~(sizeof(uintptr_t) - 1))
+
+/* The message that holds the message buffer 'b' */
+
+#define MQ_BUFFER2MSG(b) \
+  ((FAR struct mqueue_msg_s *)((FAR char *)(b) - \
+                               offsetof(struct mqueue_msg_s, mail)))
+
 /********************************************************************************
  * Public Type Definitions
  ********************************************************************************/
@@ -67,10 +89,13 @@ enum mqalloc_e
 {
   MQ_ALLOC_FIXED = 0,  /* Pre-allocated; never freed */
   MQ_ALLOC_DYN,        /* Dynamically allocated; free when unused */
-  MQ_ALLOC_IRQ         /* Preallocated, reserved for interrupt handling */
+  MQ_ALLOC_IRQ,        /* Preallocated, reserved for interrupt handling */
+  MQ_ALLOC_POOL        /* Allocated with the message queue (MQ_MSGPOOL) */
 };
 
-/* This structure describes one buffered POSIX message. */
+/* This structure describes one buffered POSIX message.  Messages of a
+ * message pool are allocated with only MQ_MSG_SIZE(mq_msgsize) bytes.
+ */
 
 struct mqueue_msg_s
 {
@@ -116,6 +141,14 @@ EXTERN sq_queue_t  g_msgfreeirq;
 
 EXTERN sq_queue_t  g_desfree;
 
+#ifdef CONFIG_MM_MEMPOOL
+/* Messages that are allocated when g_msgfree is empty come from this
+ * memory pool instead of the heap.
+ */
+
+EXTERN struct mempool_s g_msgdynpool;
+#endif
+
 /********************************************************************************
  * Public Function Prototypes
  ********************************************************************************/
@@ -127,7 +160,8 @@ struct task_group_s; /* Forward reference */
 
 void weak_function nxmq_initialize(void);
 void nxmq_alloc_desblock(void);
-void nxmq_free_msg(FAR struct mqueue_msg_s *mqmsg);
+void nxmq_free_msg(FAR struct mqueue_inode_s *msgq,
+                   FAR struct mqueue_msg_s *mqmsg);
 
 /* mq_waitirq.c *****************************************************************/
 
@@ -139,12 +173,13 @@ int nxmq_verify_receive(mqd_t mqdes, FAR char *msg, size_t msglen);
 int nxmq_wait_receive(mqd_t mqdes, FAR struct mqueue_msg_s **rcvmsg);
 ssize_t nxmq_do_receive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
                         FAR char *ubuffer, FAR unsigned int *prio);
+void nxmq_wake_sender(FAR struct mqueue_inode_s *msgq);
 
 /* mq_sndinternal.c *************************************************************/
 
 int nxmq_verify_send(mqd_t mqdes, FAR const char *msg, size_t msglen,
                      unsigned int prio);
-FAR struct mqueue_msg_s *nxmq_alloc_msg(void);
+FAR struct mqueue_msg_s *nxmq_alloc_msg(FAR struct mqueue_inode_s *msgq);
 int nxmq_wait_send(mqd_t mqdes);
 int nxmq_do_send(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
                  FAR const char *msg, size_t msglen, unsigned int prio);
@@ -154,7 +154,9 @@ struct tasklist_s
  * task, is always the IDLE task.
  */
 
+#if !defined(CONFIG_SMP) || !defined(CONFIG_SMP_PERCPU_READYTORUN)
 extern volatile dq_queue_t g_readytorun;
+#endif
 
 #ifdef CONFIG_SMP
 /* In order to support SMP, the function of the g_readytorun list changes,
@@ -189,6 +191,17 @@ extern volatile dq_queue_t g_readytorun;
 
 extern volatile dq_queue_t g_assignedtasks[CONFIG_SMP_NCPUS];
 
+#ifdef CONFIG_SMP_PERCPU_READYTORUN
+/* If CONFIG_SMP_PERCPU_READYTORUN is selected, the g_readytorun list is
+ * replaced with one list per CPU, g_cpureadytorun[].  Each holds the
+ * ready-to-run, unassigned tasks that were queued on CPU 'n' (tcb->cpu).
+ * A CPU takes (steals) a task from the list of another CPU if it beats the
+ * tasks of its own list and its affinity permits it.
+ */
+
+extern volatile dq_queue_t g_cpureadytorun[CONFIG_SMP_NCPUS];
+#endif
+
 /* g_running_tasks[] holds a references to the running task for each cpu.
  * It is valid only when up_interrupt_context() returns true.
  */
@@ -417,6 +430,17 @@ FAR struct tcb_s *this_task(void);
 int  nxsched_select_cpu(cpu_set_t affinity);
 int  nxsched_pause_cpu(FAR struct tcb_s *tcb);
 
+/* Ready-to-run (but not running and not assigned) task list management */
+
+void nxsched_add_readyqueue(FAR struct tcb_s *tcb);
+void nxsched_remove_readyqueue(FAR struct tcb_s *tcb);
+FAR struct tcb_s *nxsched_peek_readyqueue(int cpu);
+#ifdef CONFIG_SMP_PERCPU_READYTORUN
+FAR struct tcb_s *nxsched_steal_readyqueue(int cpu, int prio);
+#endif
+void nxsched_pend_readyqueue(void);
+void nxsched_merge_readyqueue(void);
+
 #  define nxsched_islocked_global() spin_islocked(&g_cpu_schedlock)
 #  define nxsched_islocked_tcb(tcb) nxsched_islocked_global()
 
@@ -167,6 +167,9 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
 bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
 {
   FAR struct tcb_s *rtcb;
+#ifdef CONFIG_SMP_PERCPU_READYTORUN
+  FAR struct tcb_s *preempted = NULL;
+#endif
   FAR dq_queue_t *tasklist;
   bool switched;
   bool doswitch;
@@ -253,16 +256,14 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
     {
       /* The new btcb was added either (1) in the middle of the assigned
        * task list (the btcb->cpu field is already valid) or (2) was
-       * added to the ready-to-run list (the btcb->cpu field does not
-       * matter).  Either way, it won't be running.
+       * added to the ready-to-run list (the btcb->cpu field is set by
+       * nxsched_add_readyqueue()).  Either way, it won't be running.
        *
        * Add the task to the ready-to-run (but not running) task list
        */
 
-      nxsched_add_prioritized(btcb, (FAR dq_queue_t *)&g_readytorun);
-
-      btcb->task_state = TSTATE_TASK_READYTORUN;
-      doswitch         = false;
+      nxsched_add_readyqueue(btcb);
+      doswitch = false;
     }
   else /* (task_state == TSTATE_TASK_ASSIGNED || task_state == TSTATE_TASK_RUNNING) */
     {
@@ -388,15 +389,22 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
               if (nxsched_islocked_global())
                 {
                   next->task_state = TSTATE_TASK_PENDING;
-                  tasklist         = (FAR dq_queue_t *)&g_pendingtasks;
+                  nxsched_add_prioritized(next,
+                                          (FAR dq_queue_t *)&g_pendingtasks);
                 }
               else
                 {
-                  next->task_state = TSTATE_TASK_READYTORUN;
-                  tasklist         = (FAR dq_queue_t *)&g_readytorun;
+#ifdef CONFIG_SMP_PERCPU_READYTORUN
+                  /* The preempted task may still outrank the running task
+                   * of another CPU.  It is added again below, once the CPU
+                   * paused here has been resumed.
+                   */
+
+                  preempted = next;
+#else
+                  nxsched_add_readyqueue(next);
+#endif
                 }
-
-              nxsched_add_prioritized(next, tasklist);
             }
 
           doswitch = true;
@@ -425,6 +433,19 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
           DEBUGVERIFY(up_cpu_resume(cpu));
           doswitch = false;
         }
+
+#ifdef CONFIG_SMP_PERCPU_READYTORUN
+      /* If the preempted task outranks the lowest priority running task,
+       * that CPU must reschedule; otherwise the task is just queued.  This
+       * recurses at most once per CPU, since each step displaces a task of
+       * strictly lower priority.
+       */
+
+      if (preempted != NULL)
+        {
+          doswitch |= nxsched_add_readytorun(preempted);
+        }
+#endif
     }
 
   return doswitch;
@@ -211,9 +211,7 @@ int sched_lock(void)
        * unlocked and nxsched_merge_pending() is called.
        */
 
-      nxsched_merge_prioritized((FAR dq_queue_t *)&g_readytorun,
-                                (FAR dq_queue_t *)&g_pendingtasks,
-                                TSTATE_TASK_PENDING);
+      nxsched_pend_readyqueue();
 
       leave_critical_section(flags);
     }
@@ -237,9 +237,7 @@ bool nxsched_merge_pending(void)
                * move them back to the pending task list.
                */
 
-              nxsched_merge_prioritized((FAR dq_queue_t *)&g_readytorun,
-                                        (FAR dq_queue_t *)&g_pendingtasks,
-                                        TSTATE_TASK_PENDING);
+              nxsched_pend_readyqueue();
 
               /* And return with the scheduler locked and tasks in the
                * pending task list.
@@ -267,9 +265,7 @@ bool nxsched_merge_pending(void)
        * tasks in the pending task list to the ready-to-run task list.
        */
 
-      nxsched_merge_prioritized((FAR dq_queue_t *)&g_pendingtasks,
-                                (FAR dq_queue_t *)&g_readytorun,
-                                TSTATE_TASK_READYTORUN);
+      nxsched_merge_readyqueue();
     }
 
 errout:
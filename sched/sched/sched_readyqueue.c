@@ -0,0 +1,254 @@
+/****************************************************************************
+ * sched/sched/sched_readyqueue.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <sched.h>
+#include <queue.h>
+#include <assert.h>
+
+#include <nuttx/sched.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SMP
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_add_readyqueue
+ *
+ * Description:
+ *   Add a TCB that is ready-to-run, but not running and not locked to a CPU
+ *   to the ready-to-run list.  With CONFIG_SMP_PERCPU_READYTORUN, the TCB is
+ *   queued on the CPU that runs the lowest priority task that the TCB may
+ *   preempt later.
+ *
+ * Input Parameters:
+ *   tcb - The TCB to be added.  The caller has already removed it from
+ *         whatever list it was in.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+void nxsched_add_readyqueue(FAR struct tcb_s *tcb)
+{
+#ifdef CONFIG_SMP_PERCPU_READYTORUN
+  int cpu = nxsched_select_cpu(tcb->affinity);
+
+  tcb->cpu = cpu;
+  nxsched_add_prioritized(tcb, (FAR dq_queue_t *)&g_cpureadytorun[cpu]);
+#else
+  nxsched_add_prioritized(tcb, (FAR dq_queue_t *)&g_readytorun);
+#endif
+
+  tcb->task_state = TSTATE_TASK_READYTORUN;
+}
+
+/****************************************************************************
+ * Name: nxsched_remove_readyqueue
+ *
+ * Description:
+ *   Remove a TCB in the TSTATE_TASK_READYTORUN state from the ready-to-run
+ *   list that holds it.  The task_state of the TCB is not modified.
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+void nxsched_remove_readyqueue(FAR struct tcb_s *tcb)
+{
+  DEBUGASSERT(tcb->task_state == TSTATE_TASK_READYTORUN);
+
+#ifdef CONFIG_SMP_PERCPU_READYTORUN
+  dq_rem((FAR dq_entry_t *)tcb,
+         (FAR dq_queue_t *)&g_cpureadytorun[tcb->cpu]);
+#else
+  dq_rem((FAR dq_entry_t *)tcb, (FAR dq_queue_t *)&g_readytorun);
+#endif
+}
+
+/****************************************************************************
+ * Name: nxsched_peek_readyqueue
+ *
+ * Description:
+ *   Return the highest priority ready-to-run TCB that may run on 'cpu'
+ *   without removing it.  With CONFIG_SMP_PERCPU_READYTORUN, only the list
+ *   of 'cpu' is examined; see nxsched_steal_readyqueue() for taking a task
+ *   from another CPU.
+ *
+ * Input Parameters:
+ *   cpu - The CPU that is looking for a task to run
+ *
+ * Returned Value:
+ *   The TCB or NULL if there is no ready-to-run task that may run on 'cpu'.
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+FAR struct tcb_s *nxsched_peek_readyqueue(int cpu)
+{
+  FAR struct tcb_s *tcb;
+
+#ifdef CONFIG_SMP_PERCPU_READYTORUN
+  tcb = (FAR struct tcb_s *)g_cpureadytorun[cpu].head;
+#else
+  tcb = (FAR struct tcb_s *)g_readytorun.head;
+#endif
+
+  while (tcb != NULL && !CPU_ISSET(cpu, &tcb->affinity))
+    {
+      tcb = (FAR struct tcb_s *)tcb->flink;
+    }
+
+  return tcb;
+}
+
+/****************************************************************************
+ * Name: nxsched_steal_readyqueue
+ *
+ * Description:
+ *   Return the highest priority ready-to-run TCB of the lists of the other
+ *   CPUs that may run on 'cpu' and has at least priority 'prio', without
+ *   removing it.  Removing it from its list steals it from the other CPU.
+ *
+ *   This is called whenever 'cpu' selects its next task.  Only the heads
+ *   of the other lists need to be examined unless they beat 'prio'.
+ *
+ * Input Parameters:
+ *   cpu  - The CPU that is looking for a task to run
+ *   prio - The lowest priority that beats the task that 'cpu' would run
+ *          otherwise
+ *
+ * Returned Value:
+ *   The TCB or NULL if there is no such task.
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP_PERCPU_READYTORUN
+FAR struct tcb_s *nxsched_steal_readyqueue(int cpu, int prio)
+{
+  FAR struct tcb_s *rtrtcb = NULL;
+  FAR struct tcb_s *tcb;
+  int i;
+
+  for (i = 1; i < CONFIG_SMP_NCPUS; i++)
+    {
+      int qcpu = (cpu + i) % CONFIG_SMP_NCPUS;
+
+      /* The lists are sorted by priority, so the search of a list may stop
+       * at the first TCB that cannot beat the best TCB found so far.
+       */
+
+      for (tcb = (FAR struct tcb_s *)g_cpureadytorun[qcpu].head;
+           tcb != NULL && tcb->sched_priority >= prio;
+           tcb = (FAR struct tcb_s *)tcb->flink)
+        {
+          if (CPU_ISSET(cpu, &tcb->affinity))
+            {
+              rtrtcb = tcb;
+              prio   = tcb->sched_priority + 1;
+              break;
+            }
+        }
+    }
+
+  return rtrtcb;
+}
+#endif
+
+/****************************************************************************
+ * Name: nxsched_pend_readyqueue
+ *
+ * Description:
+ *   Move all ready-to-run (but not running and not assigned) TCBs to the
+ *   g_pendingtasks list.
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+void nxsched_pend_readyqueue(void)
+{
+#ifdef CONFIG_SMP_PERCPU_READYTORUN
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      nxsched_merge_prioritized((FAR dq_queue_t *)&g_cpureadytorun[cpu],
+                                (FAR dq_queue_t *)&g_pendingtasks,
+                                TSTATE_TASK_PENDING);
+    }
+#else
+  nxsched_merge_prioritized((FAR dq_queue_t *)&g_readytorun,
+                            (FAR dq_queue_t *)&g_pendingtasks,
+                            TSTATE_TASK_PENDING);
+#endif
+}
+
+/****************************************************************************
+ * Name: nxsched_merge_readyqueue
+ *
+ * Description:
+ *   Move all TCBs in the g_pendingtasks list to the ready-to-run list(s).
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+void nxsched_merge_readyqueue(void)
+{
+#ifdef CONFIG_SMP_PERCPU_READYTORUN
+  FAR struct tcb_s *tcb;
+
+  while ((tcb = (FAR struct tcb_s *)
+                dq_remfirst((FAR dq_queue_t *)&g_pendingtasks)) != NULL)
+    {
+      nxsched_add_readyqueue(tcb);
+    }
+#else
+  nxsched_merge_prioritized((FAR dq_queue_t *)&g_pendingtasks,
+                            (FAR dq_queue_t *)&g_readytorun,
+                            TSTATE_TASK_READYTORUN);
+#endif
+}
+
+#endif /* CONFIG_SMP */
@@ -168,6 +168,9 @@ bool nxsched_remove_readytorun(FAR struct tcb_s *rtcb)
     {
       FAR struct tcb_s *nxttcb;
       FAR struct tcb_s *rtrtcb = NULL;
+#ifdef CONFIG_SMP_PERCPU_READYTORUN
+      FAR struct tcb_s *stltcb;
+#endif
       int me;
 
       /* There must always be at least one task in the list (the IDLE task)
@@ -211,9 +214,32 @@ bool nxsched_remove_readytorun(FAR struct tcb_s *rtcb)
            * CPU.
            */
 
-          for (rtrtcb = (FAR struct tcb_s *)g_readytorun.head;
-               rtrtcb != NULL && !CPU_ISSET(cpu, &rtrtcb->affinity);
-               rtrtcb = (FAR struct tcb_s *)rtrtcb->flink);
+          rtrtcb = nxsched_peek_readyqueue(cpu);
+
+#ifdef CONFIG_SMP_PERCPU_READYTORUN
+          /* Steal a task from the list of another CPU if it beats the task
+           * that this CPU would run otherwise.  Running a lower priority
+           * task of our own list while that task waits would be a priority
+           * inversion.
+           */
+
+          if (rtrtcb == NULL ||
+              rtrtcb->sched_priority < nxttcb->sched_priority)
+            {
+              stltcb = nxsched_steal_readyqueue(cpu,
+                                                nxttcb->sched_priority);
+            }
+          else
+            {
+              stltcb = nxsched_steal_readyqueue(cpu,
+                                                rtrtcb->sched_priority + 1);
+            }
+
+          if (stltcb != NULL)
+            {
+              rtrtcb = stltcb;
+            }
+#endif
         }
 
       /* Did we find a task in the g_readytorun list?  Which task should
@@ -225,20 +251,16 @@ bool nxsched_remove_readytorun(FAR struct tcb_s *rtcb)
 
       if (rtrtcb != NULL && rtrtcb->sched_priority >= nxttcb->sched_priority)
         {
-          FAR struct tcb_s *tmptcb;
-
-          /* The TCB at the head of the ready to run list has the higher
-           * priority.  Remove that task from the head of the g_readytorun
-           * list and add to the head of the g_assignedtasks[cpu] list.
+          /* The TCB from the ready to run list has the higher priority.
+           * Remove that task from the ready to run list and add to the
+           * head of the g_assignedtasks[cpu] list.
            */
 
-          tmptcb = (FAR struct tcb_s *)
-            dq_remfirst((FAR dq_queue_t *)&g_readytorun);
-
-          dq_addfirst((FAR dq_entry_t *)tmptcb, tasklist);
+          nxsched_remove_readyqueue(rtrtcb);
+          dq_addfirst((FAR dq_entry_t *)rtrtcb, tasklist);
 
-          tmptcb->cpu = cpu;
-          nxttcb = tmptcb;
+          rtrtcb->cpu = cpu;
+          nxttcb = rtrtcb;
         }
 
       /* Will pre-emption be disabled after the switch?  If the lockcount is
@@ -57,6 +57,9 @@ static FAR struct tcb_s *nxsched_nexttcb(FAR struct tcb_s *tcb)
 {
   FAR struct tcb_s *nxttcb = (FAR struct tcb_s *)tcb->flink;
   FAR struct tcb_s *rtrtcb;
+#ifdef CONFIG_SMP_PERCPU_READYTORUN
+  FAR struct tcb_s *stltcb;
+#endif
   int cpu = this_cpu();
 
   /* Which task should run next?  It will be either the next tcb in the
@@ -72,9 +75,27 @@ static FAR struct tcb_s *nxsched_nexttcb(FAR struct tcb_s *tcb)
     {
       /* Search for the highest priority task that can run on this CPU. */
 
-      for (rtrtcb = (FAR struct tcb_s *)g_readytorun.head;
-           rtrtcb != NULL && !CPU_ISSET(cpu, &rtrtcb->affinity);
-           rtrtcb = (FAR struct tcb_s *)rtrtcb->flink);
+      rtrtcb = nxsched_peek_readyqueue(cpu);
+
+#ifdef CONFIG_SMP_PERCPU_READYTORUN
+      /* Steal a task from the list of another CPU if it beats the task that
+       * this CPU would run otherwise.
+       */
+
+      if (rtrtcb == NULL || rtrtcb->sched_priority < nxttcb->sched_priority)
+        {
+          stltcb = nxsched_steal_readyqueue(cpu, nxttcb->sched_priority);
+        }
+      else
+        {
+          stltcb = nxsched_steal_readyqueue(cpu, rtrtcb->sched_priority + 1);
+        }
+
+      if (stltcb != NULL)
+        {
+          rtrtcb = stltcb;
+        }
+#endif
 
       /* Return the TCB from the readyt-to-run list if it is the next
        * highest priority task.
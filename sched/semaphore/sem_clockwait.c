@@ -109,6 +109,17 @@ int nxsem_clockwait(FAR sem_t *sem, clockid_t clockid,
     }
 #endif
 
+#ifdef CONFIG_SEM_FASTPATH
+  /* Take an available count without entering the critical section if
+   * there are no holders to be tracked.
+   */
+
+  if (sem != NULL && NXSEM_NOHOLDERS(sem) && nxsem_fast_trywait(sem))
+    {
+      return OK;
+    }
+#endif
+
   /* We will disable interrupts until we have completed the semaphore
    * wait.  We need to do this (as opposed to just disabling pre-emption)
    * because there could be interrupt handlers that are asynchronously
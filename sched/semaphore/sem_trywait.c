@@ -79,8 +79,10 @@
 
 int nxsem_trywait(FAR sem_t *sem)
 {
+#ifndef CONFIG_SEM_FASTPATH
   FAR struct tcb_s *rtcb = this_task();
   irqstate_t flags;
+#endif
   int ret;
 
   /* This API should not be called from interrupt handlers */
@@ -89,6 +91,13 @@ int nxsem_trywait(FAR sem_t *sem)
 
   if (sem != NULL)
     {
+#ifdef CONFIG_SEM_FASTPATH
+      /* The count is only changed atomically, so an available count can be
+       * taken without entering the critical section.
+       */
+
+      ret = nxsem_fast_trywait(sem) ? OK : -EAGAIN;
+#else
       /* The following operations must be performed with interrupts disabled
        * because sem_post() may be called from an interrupt handler.
        */
@@ -115,6 +124,7 @@ int nxsem_trywait(FAR sem_t *sem)
       /* Interrupts may now be enabled. */
 
       leave_critical_section(flags);
+#endif
     }
   else
     {
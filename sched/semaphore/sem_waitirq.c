@@ -94,7 +94,7 @@ void nxsem_wait_irq(FAR struct tcb_s *wtcb, int errcode)
        * place.
        */
 
-      sem->semcount++;
+      NXSEM_COUNT_INC(sem);
 
       /* Indicate that the semaphore wait is over. */
 
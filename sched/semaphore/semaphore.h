@@ -31,9 +31,92 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <limits.h>
 #include <sched.h>
 #include <queue.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* True if no holders of the semaphore are tracked for priority
+ * inheritance.  Only then can counts be taken and released without
+ * entering the critical section.
+ */
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+#  define NXSEM_NOHOLDERS(s) (((s)->flags & PRIOINHERIT_FLAGS_DISABLE) != 0)
+#else
+#  define NXSEM_NOHOLDERS(s) true
+#endif
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_SEM_FASTPATH
+
+/****************************************************************************
+ * Name: nxsem_fast_trywait
+ *
+ * Description:
+ *   Take a count of the semaphore if one is available, without entering
+ *   the critical section.
+ *
+ * Returned Value:
+ *   True if a count was taken.
+ *
+ ****************************************************************************/
+
+static inline bool nxsem_fast_trywait(FAR sem_t *sem)
+{
+  int16_t count = sem->semcount;
+
+  while (count > 0)
+    {
+      if (__atomic_compare_exchange_n(&sem->semcount, &count, count - 1,
+                                      true, __ATOMIC_ACQUIRE,
+                                      __ATOMIC_RELAXED))
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: nxsem_fast_post
+ *
+ * Description:
+ *   Release a count of the semaphore without entering the critical section
+ *   if no thread is waiting for the semaphore.
+ *
+ * Returned Value:
+ *   True if the count was released.  False if a waiting thread has to be
+ *   woken up or the count would overflow.
+ *
+ ****************************************************************************/
+
+static inline bool nxsem_fast_post(FAR sem_t *sem)
+{
+  int16_t count = sem->semcount;
+
+  while (count >= 0 && count < SEM_VALUE_MAX)
+    {
+      if (__atomic_compare_exchange_n(&sem->semcount, &count, count + 1,
+                                      true, __ATOMIC_RELEASE,
+                                      __ATOMIC_RELAXED))
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+#endif /* CONFIG_SEM_FASTPATH */
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
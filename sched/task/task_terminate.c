@@ -144,9 +144,12 @@ int nxtask_terminate(pid_t pid, bool nonblocking)
 
   cpu = nxsched_pause_cpu(dtcb);
 
-  /* Get the task list associated with the thread's state and CPU */
+  /* Get the task list associated with the thread's state and CPU.  The
+   * CPU returned by nxsched_pause_cpu() is negative if the thread is not
+   * running.
+   */
 
-  tasklist = TLIST_HEAD(dtcb->task_state, cpu);
+  tasklist = TLIST_HEAD(dtcb->task_state, dtcb->cpu);
 #else
   /* In the non-SMP case, we can be assured that the task to be terminated
    * is not running.  get the task list associated with the task state.
@@ -57,8 +57,10 @@
 
 int wd_cancel(FAR struct wdog_s *wdog)
 {
+#ifndef CONFIG_WDOG_TIMERWHEEL
   FAR struct wdog_s *curr;
   FAR struct wdog_s *prev;
+#endif
   irqstate_t flags;
   int ret = -EINVAL;
 
@@ -74,6 +76,14 @@ int wd_cancel(FAR struct wdog_s *wdog)
 
   if (wdog != NULL && WDOG_ISACTIVE(wdog))
     {
+#ifdef CONFIG_WDOG_TIMERWHEEL
+      /* Remove the watchdog from its timing wheel slot.  The interval
+       * timer is not reassessed:  At worst, wd_timer() will be called once
+       * without any watchdog to expire.
+       */
+
+      wd_wheel_remove(wdog);
+#else
       /* Search the g_wdactivelist for the target FCB.  We can't use sq_rem
        * to do this because there are additional operations that need to be
        * done.
@@ -123,6 +133,7 @@ int wd_cancel(FAR struct wdog_s *wdog)
 
           nxsched_reassess_timer();
         }
+#endif
 
       /* Mark the watchdog inactive */
 
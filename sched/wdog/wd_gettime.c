@@ -59,6 +59,12 @@ int wd_gettime(FAR struct wdog_s *wdog)
   flags = enter_critical_section();
   if (wdog != NULL && WDOG_ISACTIVE(wdog))
     {
+#ifdef CONFIG_WDOG_TIMERWHEEL
+      int delay = wd_wheel_remaining(wdog) - wd_elapse();
+
+      leave_critical_section(flags);
+      return delay;
+#else
       /* Traverse the watchdog list accumulating lag times until we find the
        * wdog that we are looking for
        */
@@ -78,6 +84,7 @@ int wd_gettime(FAR struct wdog_s *wdog)
               return delay;
             }
         }
+#endif
     }
 
   leave_critical_section(flags);
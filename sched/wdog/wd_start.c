@@ -54,6 +54,8 @@
  * Private Functions
  ****************************************************************************/
 
+#ifndef CONFIG_WDOG_TIMERWHEEL
+
 /****************************************************************************
  * Name: wd_expiration
  *
@@ -109,6 +111,8 @@ static inline void wd_expiration(void)
     }
 }
 
+#endif /* !CONFIG_WDOG_TIMERWHEEL */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -152,10 +156,12 @@ static inline void wd_expiration(void)
 int wd_start(FAR struct wdog_s *wdog, int32_t delay,
              wdentry_t wdentry, wdparm_t arg)
 {
+#ifndef CONFIG_WDOG_TIMERWHEEL
   FAR struct wdog_s *curr;
   FAR struct wdog_s *prev;
   FAR struct wdog_s *next;
   int32_t now;
+#endif
   irqstate_t flags;
 
   /* Verify the wdog and setup parameters */
@@ -204,6 +210,21 @@ int wd_start(FAR struct wdog_s *wdog, int32_t delay,
   nxsched_cancel_timer();
 #endif
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+#ifdef CONFIG_SCHED_TICKLESS
+  if (wd_wheel_empty())
+    {
+      /* Update clock tickbase */
+
+      g_wdtickbase = clock_systime_ticks();
+    }
+#endif
+
+  /* Add the watchdog to the timing wheel.  This is O(1). */
+
+  wd_wheel_insert(wdog, delay);
+
+#else
   /* Do the easy case first -- when the watchdog timer queue is empty. */
 
   if (g_wdactivelist.head == NULL)
@@ -294,9 +315,13 @@ int wd_start(FAR struct wdog_s *wdog, int32_t delay,
         }
     }
 
-  /* Put the lag into the watchdog structure and mark it as active. */
+  /* Put the lag into the watchdog structure */
 
   wdog->lag = delay;
+#endif /* CONFIG_WDOG_TIMERWHEEL */
+
+  /* Mark the watchdog as active */
+
   WDOG_SETACTIVE(wdog);
 
 #ifdef CONFIG_SCHED_TICKLESS
@@ -337,6 +362,7 @@ int wd_start(FAR struct wdog_s *wdog, int32_t delay,
  *
  ****************************************************************************/
 
+#ifndef CONFIG_WDOG_TIMERWHEEL
 #ifdef CONFIG_SCHED_TICKLESS
 unsigned int wd_timer(int ticks)
 {
@@ -445,3 +471,4 @@ void wd_timer(void)
 #endif
 }
 #endif /* CONFIG_SCHED_TICKLESS */
+#endif /* !CONFIG_WDOG_TIMERWHEEL */
@@ -0,0 +1,529 @@
+/****************************************************************************
+ * sched/wdog/wd_wheel.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <strings.h>
+#include <string.h>
+#include <queue.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/wdog.h>
+
+#include "sched/sched.h"
+#include "wdog/wdog.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The timing wheel has WDOG_WHEEL_LEVELS levels of WDOG_WHEEL_SLOTS slots.
+ * A slot of level 'l' covers 2^(l * WDOG_WHEEL_BITS) ticks.  Enough levels
+ * are provided to hold any delay below 2^31 ticks.  Only the lower bits of
+ * the top level are used because the wheel time is a 32-bit value.
+ */
+
+#define WDOG_WHEEL_BITS      CONFIG_WDOG_TIMERWHEEL_BITS
+#define WDOG_WHEEL_SLOTS     (1 << WDOG_WHEEL_BITS)
+#define WDOG_WHEEL_MASK      (WDOG_WHEEL_SLOTS - 1)
+#define WDOG_WHEEL_LEVELS    ((31 + WDOG_WHEEL_BITS - 1) / WDOG_WHEEL_BITS)
+#define WDOG_WHEEL_TOPSHIFT  ((WDOG_WHEEL_LEVELS - 1) * WDOG_WHEEL_BITS)
+#define WDOG_WHEEL_TOPMASK   ((1 << (32 - WDOG_WHEEL_TOPSHIFT)) - 1)
+#define WDOG_WHEEL_MAPS      (WDOG_WHEEL_SLOTS / 32)
+
+#define WDOG_WHEEL_SHIFT(l)  ((l) * WDOG_WHEEL_BITS)
+#define WDOG_WHEEL_LMASK(l)  ((l) == WDOG_WHEEL_LEVELS - 1 ? \
+                              WDOG_WHEEL_TOPMASK : WDOG_WHEEL_MASK)
+#define WDOG_WHEEL_INDEX(l,t) \
+  (((t) >> WDOG_WHEEL_SHIFT(l)) & WDOG_WHEEL_LMASK(l))
+
+/* Value of the slot field of watchdogs that expire in the current tick */
+
+#define WDOG_WHEEL_PENDING   UINT16_MAX
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The slots of the wheel and a bitmap of the non-empty slots per level */
+
+static dq_queue_t g_wdslot[WDOG_WHEEL_LEVELS][WDOG_WHEEL_SLOTS];
+static uint32_t g_wdbitmap[WDOG_WHEEL_LEVELS][WDOG_WHEEL_MAPS];
+
+/* Watchdogs that have been removed from the wheel because they expire in
+ * the current tick, but whose functions have not been called yet.
+ */
+
+static dq_queue_t g_wdpending;
+
+/* The next wheel tick to be processed and the number of active watchdogs */
+
+static uint32_t g_wdtick;
+static unsigned int g_wdcount;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_add
+ *
+ * Description:
+ *   Add a watchdog to the wheel slot that matches its expiration time
+ *   relative to the current wheel time.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_add(FAR struct wdog_s *wdog)
+{
+  uint32_t delta = wdog->expiry - g_wdtick;
+  unsigned int ndx;
+  int level;
+
+  if ((int32_t)delta < 0)
+    {
+      /* Already due.  Expire it with the next tick */
+
+      level = 0;
+      ndx   = g_wdtick & WDOG_WHEEL_MASK;
+    }
+  else
+    {
+      /* Use the lowest level whose slots do not wrap around before the
+       * expiration time.
+       */
+
+      level = 0;
+      while (level < WDOG_WHEEL_LEVELS - 1 &&
+             delta >= ((uint32_t)1 << WDOG_WHEEL_SHIFT(level + 1)))
+        {
+          level++;
+        }
+
+      ndx = WDOG_WHEEL_INDEX(level, wdog->expiry);
+    }
+
+  dq_addlast((FAR dq_entry_t *)wdog, &g_wdslot[level][ndx]);
+  g_wdbitmap[level][ndx >> 5] |= (uint32_t)1 << (ndx & 31);
+  wdog->slot = level * WDOG_WHEEL_SLOTS + ndx;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_find
+ *
+ * Description:
+ *   Return the distance in slots from slot 'start' to the next non-empty
+ *   slot of a level, or -1 if all slots of the level are empty.
+ *
+ ****************************************************************************/
+
+static int wd_wheel_find(int level, unsigned int start)
+{
+  unsigned int ndx = start;
+  uint32_t bits;
+  int i;
+
+  /* Visit the word holding 'start' twice to handle the wrap-around */
+
+  for (i = 0; i <= WDOG_WHEEL_MAPS; i++)
+    {
+      bits = g_wdbitmap[level][(ndx >> 5) & (WDOG_WHEEL_MAPS - 1)] &
+             (UINT32_MAX << (ndx & 31));
+      if (bits != 0)
+        {
+          ndx = (ndx & ~31) + ffs(bits) - 1;
+          return (ndx - start) & WDOG_WHEEL_LMASK(level);
+        }
+
+      ndx = (ndx | 31) + 1;
+    }
+
+  return -1;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_next
+ *
+ * Description:
+ *   Return the number of ticks from the current wheel time to the next tick
+ *   that must be processed, i.e. the next expiration in level 0 or the next
+ *   cascade of a non-empty slot of a higher level.  UINT32_MAX is returned
+ *   if the wheel is empty.
+ *
+ ****************************************************************************/
+
+static uint32_t wd_wheel_next(void)
+{
+  uint32_t next = UINT32_MAX;
+  uint32_t base;
+  uint32_t span;
+  int level;
+  int dist;
+
+  if (g_wdcount == 0)
+    {
+      return UINT32_MAX;
+    }
+
+  /* Level 0 holds the exact expiration times of the next ticks */
+
+  dist = wd_wheel_find(0, g_wdtick & WDOG_WHEEL_MASK);
+  if (dist >= 0)
+    {
+      next = dist;
+    }
+
+  /* A slot of a higher level is cascaded at the first tick of its span.
+   * This may happen before the next expiration found in level 0.
+   */
+
+  for (level = 1; level < WDOG_WHEEL_LEVELS; level++)
+    {
+      span = (uint32_t)1 << WDOG_WHEEL_SHIFT(level);
+      base = (g_wdtick + span - 1) & ~(span - 1);
+      dist = wd_wheel_find(level, WDOG_WHEEL_INDEX(level, base));
+      if (dist >= 0 && base - g_wdtick + dist * span < next)
+        {
+          next = base - g_wdtick + dist * span;
+        }
+    }
+
+  return next;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_cascade
+ *
+ * Description:
+ *   Move all watchdogs of one slot of a higher level to the lower levels.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_cascade(int level, unsigned int ndx)
+{
+  FAR struct wdog_s *wdog;
+  dq_queue_t list;
+
+  dq_init(&list);
+  dq_cat(&g_wdslot[level][ndx], &list);
+  g_wdbitmap[level][ndx >> 5] &= ~((uint32_t)1 << (ndx & 31));
+
+  while ((wdog = (FAR struct wdog_s *)dq_remfirst(&list)) != NULL)
+    {
+      wd_wheel_add(wdog);
+    }
+}
+
+/****************************************************************************
+ * Name: wd_wheel_tick
+ *
+ * Description:
+ *   Process one tick of the wheel:  Cascade the higher levels if a level 0
+ *   rotation is complete, advance the wheel time and call the functions of
+ *   all watchdogs that expire in this tick.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_tick(void)
+{
+  FAR struct wdog_s *wdog;
+  unsigned int ndx;
+  int level;
+
+  /* Cascade level 'l' each time the levels below it wrapped around */
+
+  ndx = g_wdtick & WDOG_WHEEL_MASK;
+  if (ndx == 0)
+    {
+      for (level = 1; level < WDOG_WHEEL_LEVELS; level++)
+        {
+          unsigned int cndx = WDOG_WHEEL_INDEX(level, g_wdtick);
+
+          wd_wheel_cascade(level, cndx);
+          if (cndx != 0)
+            {
+              break;
+            }
+        }
+    }
+
+  /* Move the expired watchdogs to the pending list.  They may still be
+   * cancelled by the functions of watchdogs called before them.  The list
+   * is appended to because a watchdog function may re-enter wd_timer()
+   * through wd_start() in the tickless mode.
+   */
+
+  for (wdog = (FAR struct wdog_s *)g_wdslot[0][ndx].head; wdog != NULL;
+       wdog = wdog->next)
+    {
+      wdog->slot = WDOG_WHEEL_PENDING;
+    }
+
+  dq_cat(&g_wdslot[0][ndx], &g_wdpending);
+  g_wdbitmap[0][ndx >> 5] &= ~((uint32_t)1 << (ndx & 31));
+
+  /* Watchdogs restarted by the functions are relative to the next tick */
+
+  g_wdtick++;
+
+  while ((wdog = (FAR struct wdog_s *)dq_remfirst(&g_wdpending)) != NULL)
+    {
+      /* Indicate that the watchdog is no longer active. */
+
+      WDOG_CLRACTIVE(wdog);
+      g_wdcount--;
+
+      /* Execute the watchdog function */
+
+      up_setpicbase(wdog->picbase);
+      wdog->func(wdog->arg);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_initialize
+ *
+ * Description:
+ *   Initialize the (empty) timing wheel.
+ *
+ ****************************************************************************/
+
+void wd_wheel_initialize(void)
+{
+  int level;
+  int ndx;
+
+  for (level = 0; level < WDOG_WHEEL_LEVELS; level++)
+    {
+      for (ndx = 0; ndx < WDOG_WHEEL_SLOTS; ndx++)
+        {
+          dq_init(&g_wdslot[level][ndx]);
+        }
+    }
+
+  memset(g_wdbitmap, 0, sizeof(g_wdbitmap));
+  dq_init(&g_wdpending);
+  g_wdtick  = 0;
+  g_wdcount = 0;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_empty
+ *
+ * Description:
+ *   Return true if no watchdog is active.
+ *
+ ****************************************************************************/
+
+bool wd_wheel_empty(void)
+{
+  return g_wdcount == 0;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_insert
+ *
+ * Description:
+ *   Add a watchdog to the timing wheel.  The watchdog expires after 'delay'
+ *   ticks have been processed by wd_timer().
+ *
+ * Assumptions:
+ *   Called from within a critical section.  delay is at least one.
+ *
+ ****************************************************************************/
+
+void wd_wheel_insert(FAR struct wdog_s *wdog, int32_t delay)
+{
+  DEBUGASSERT(delay > 0);
+
+  wdog->expiry = g_wdtick + (uint32_t)delay - 1;
+  wd_wheel_add(wdog);
+  g_wdcount++;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_remove
+ *
+ * Description:
+ *   Remove an active watchdog from the timing wheel.
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+void wd_wheel_remove(FAR struct wdog_s *wdog)
+{
+  unsigned int level;
+  unsigned int ndx;
+
+  if (wdog->slot == WDOG_WHEEL_PENDING)
+    {
+      dq_rem((FAR dq_entry_t *)wdog, &g_wdpending);
+    }
+  else
+    {
+      level = wdog->slot / WDOG_WHEEL_SLOTS;
+      ndx   = wdog->slot % WDOG_WHEEL_SLOTS;
+
+      DEBUGASSERT(level < WDOG_WHEEL_LEVELS);
+
+      dq_rem((FAR dq_entry_t *)wdog, &g_wdslot[level][ndx]);
+      if (dq_empty(&g_wdslot[level][ndx]))
+        {
+          g_wdbitmap[level][ndx >> 5] &= ~((uint32_t)1 << (ndx & 31));
+        }
+    }
+
+  g_wdcount--;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_remaining
+ *
+ * Description:
+ *   Return the number of ticks that wd_timer() must still process before
+ *   an active watchdog expires.
+ *
+ ****************************************************************************/
+
+int wd_wheel_remaining(FAR struct wdog_s *wdog)
+{
+  return (int)(wdog->expiry - g_wdtick) + 1;
+}
+
+/****************************************************************************
+ * Name: wd_timer
+ *
+ * Description:
+ *   This function is called from the timer interrupt handler to determine
+ *   if it is time to execute a watchdog function.  If so, the watchdog
+ *   function will be executed in the context of the timer interrupt
+ *   handler.
+ *
+ * Input Parameters:
+ *   ticks - If CONFIG_SCHED_TICKLESS is defined then the number of ticks
+ *     in the interval that just expired is provided.  Otherwise,
+ *     this function is called on each timer interrupt and a value of one
+ *     is implicit.
+ *
+ * Returned Value:
+ *   If CONFIG_SCHED_TICKLESS is defined then the number of ticks for the
+ *   next delay is provided (zero if no delay).  Otherwise, this function
+ *   has no returned value.
+ *
+ * Assumptions:
+ *   Called from interrupt handler logic with interrupts disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_TICKLESS
+unsigned int wd_timer(int ticks)
+{
+#ifdef CONFIG_SMP
+  irqstate_t flags;
+#endif
+  unsigned int ret;
+  uint32_t next;
+
+#ifdef CONFIG_SMP
+  /* We are in an interrupt handler as, as a consequence, interrupts are
+   * disabled.  But in the SMP case, interrupts MAY be disabled only on
+   * the local CPU since most architectures do not permit disabling
+   * interrupts on other CPUS.
+   *
+   * Hence, we must follow rules for critical sections even here in the
+   * SMP case.
+   */
+
+  flags = enter_critical_section();
+#endif
+
+  /* Skip over the ticks without any work and process the others */
+
+  while (ticks > 0)
+    {
+      next = wd_wheel_next();
+      if (next >= (uint32_t)ticks)
+        {
+          break;
+        }
+
+      g_wdtick     += next;
+      g_wdtickbase += next + 1;
+      ticks        -= next + 1;
+
+      wd_wheel_tick();
+    }
+
+  /* Update the wheel time and the clock tickbase */
+
+  g_wdtick     += ticks;
+  g_wdtickbase += ticks;
+
+  /* Return the delay for the next watchdog to expire */
+
+  next = wd_wheel_next();
+  ret  = next != UINT32_MAX ? next + 1 : 0;
+
+#ifdef CONFIG_SMP
+  leave_critical_section(flags);
+#endif
+
+  return ret;
+}
+
+#else
+void wd_timer(void)
+{
+#ifdef CONFIG_SMP
+  irqstate_t flags;
+
+  /* We are in an interrupt handler as, as a consequence, interrupts are
+   * disabled.  But in the SMP case, interrupts MAY be disabled only on
+   * the local CPU since most architectures do not permit disabling
+   * interrupts on other CPUS.
+   *
+   * Hence, we must follow rules for critical sections even here in the
+   * SMP case.
+   */
+
+  flags = enter_critical_section();
+#endif
+
+  wd_wheel_tick();
+
+#ifdef CONFIG_SMP
+  leave_critical_section(flags);
+#endif
+}
+#endif /* CONFIG_SCHED_TICKLESS */
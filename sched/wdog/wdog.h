@@ -72,7 +72,9 @@ extern "C"
  * this linked list are removed and the function is called.
  */
 
+#ifndef CONFIG_WDOG_TIMERWHEEL
 extern sq_queue_t g_wdactivelist;
+#endif
 
 /* This is wdog tickbase, for wd_gettime() may called many times
  * between 2 times of wd_timer(), we use it to update wd_gettime().
@@ -138,6 +140,30 @@ unsigned int wd_timer(int ticks);
 void wd_timer(void);
 #endif
 
+/****************************************************************************
+ * Name: wd_wheel_initialize, wd_wheel_empty, wd_wheel_insert,
+ *       wd_wheel_remove and wd_wheel_remaining
+ *
+ * Description:
+ *   Timing wheel operations used instead of the g_wdactivelist if
+ *   CONFIG_WDOG_TIMERWHEEL is selected.  wd_wheel_insert() adds a watchdog
+ *   that expires after 'delay' (at least one) ticks have been processed by
+ *   wd_timer().  wd_wheel_remaining() returns the number of ticks until an
+ *   active watchdog expires.
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_TIMERWHEEL
+void wd_wheel_initialize(void);
+bool wd_wheel_empty(void);
+void wd_wheel_insert(FAR struct wdog_s *wdog, int32_t delay);
+void wd_wheel_remove(FAR struct wdog_s *wdog);
+int  wd_wheel_remaining(FAR struct wdog_s *wdog);
+#endif
+
 /****************************************************************************
  * Name: wd_recover
  *
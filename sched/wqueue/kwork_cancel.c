@@ -49,7 +49,8 @@
  *   work_queue() again.
  *
  * Input Parameters:
- *   qid    - The work queue ID
+ *   wqueue - The work queue.  Not used with CONFIG_SCHED_LPWORK_PERCPU,
+ *            where the work records the queue that it is in.
  *   work   - The previously queue work structure to cancel
  *
  * Returned Value:
@@ -74,26 +75,52 @@ static int work_qcancel(FAR struct kwork_wqueue_s *wqueue,
    * new work is typically added to the work queue from interrupt handlers.
    */
 
-  flags = enter_critical_section();
+#ifdef CONFIG_SCHED_LPWORK_PERCPU
+  /* The work is in the queue that it was last queued on, which need not be
+   * the queue of this CPU.  The work may be moved to another queue before
+   * that queue is locked, so look again if it is no longer there.
+   */
+
+  for (; ; )
+    {
+      wqueue = work->wqueue;
+      if (wqueue == NULL)
+        {
+          return -ENOENT;
+        }
+
+      flags = work_lock(wqueue);
+      if (work->wqueue == wqueue)
+        {
+          break;
+        }
+
+      work_unlock(wqueue, flags);
+    }
+#else
+  flags = work_lock(wqueue);
+#endif
   if (work->worker != NULL)
     {
       /* A little test of the integrity of the work queue */
 
       DEBUGASSERT(work->dq.flink != NULL ||
-                  (FAR dq_entry_t *)work == wqueue->q.tail);
+                  (FAR dq_entry_t *)work == wqueue->q.tail ||
+                  (FAR dq_entry_t *)work == wqueue->delayed.tail);
       DEBUGASSERT(work->dq.blink != NULL ||
-                  (FAR dq_entry_t *)work == wqueue->q.head);
+                  (FAR dq_entry_t *)work == wqueue->q.head ||
+                  (FAR dq_entry_t *)work == wqueue->delayed.head);
 
       /* Remove the entry from the work queue and make sure that it is
        * marked as available (i.e., the worker field is nullified).
        */
 
-      dq_rem((FAR dq_entry_t *)work, &wqueue->q);
+      work_remove(wqueue, work);
       work->worker = NULL;
       ret = OK;
     }
 
-  leave_critical_section(flags);
+  work_unlock(wqueue, flags);
   return ret;
 }
 
@@ -138,7 +165,7 @@ int work_cancel(int qid, FAR struct work_s *work)
     {
       /* Cancel low priority work */
 
-      return work_qcancel((FAR struct kwork_wqueue_s *)&g_lpwork, work);
+      return work_qcancel((FAR struct kwork_wqueue_s *)&g_lpwork[0], work);
     }
   else
 #endif
@@ -32,6 +32,7 @@
 #include <debug.h>
 
 #include <nuttx/wqueue.h>
+#include <nuttx/signal.h>
 #include <nuttx/kthread.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/clock.h>
@@ -80,6 +81,12 @@ static int work_hpthread(int argc, char *argv[])
 #if CONFIG_SCHED_HPNTHREADS > 1
   pid_t me = getpid();
   int i;
+#endif
+#ifdef CONFIG_SCHED_LPWORK_PERCPU
+  sigset_t set;
+#endif
+
+#if CONFIG_SCHED_HPNTHREADS > 1
 
   /* Find out thread index by search the workers in g_hpwork */
 
@@ -95,6 +102,16 @@ static int work_hpthread(int argc, char *argv[])
   DEBUGASSERT(i < CONFIG_SCHED_HPNTHREADS);
 #endif
 
+#ifdef CONFIG_SCHED_LPWORK_PERCPU
+  /* The work queues are not protected by the critical section.  Keep
+   * SIGWORK pending while work is performed so that it is not lost.
+   */
+
+  sigemptyset(&set);
+  nxsig_addset(&set, SIGWORK);
+  nxsig_procmask(SIG_BLOCK, &set, NULL);
+#endif
+
   /* Loop forever */
 
   for (; ; )
@@ -32,6 +32,7 @@
 #include <debug.h>
 
 #include <nuttx/wqueue.h>
+#include <nuttx/signal.h>
 #include <nuttx/kthread.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/clock.h>
@@ -46,7 +47,7 @@
 
 /* The state of the kernel mode, low priority work queue(s). */
 
-struct lp_wqueue_s g_lpwork;
+struct lp_wqueue_s g_lpwork[LPWORK_NQUEUES];
 
 /****************************************************************************
  * Private Functions
@@ -76,23 +77,47 @@ struct lp_wqueue_s g_lpwork;
 
 static int work_lpthread(int argc, char *argv[])
 {
+  FAR struct kwork_wqueue_s *wqueue;
   int wndx = 0;
-#if CONFIG_SCHED_LPNTHREADS > 1
+#if CONFIG_SCHED_LPNTHREADS > 1 || LPWORK_NQUEUES > 1
   pid_t me = getpid();
+  int qndx;
   int i;
+#endif
+#ifdef CONFIG_SCHED_LPWORK_PERCPU
+  sigset_t set;
+#endif
 
-  /* Find out thread index by search the workers in g_lpwork */
+#if CONFIG_SCHED_LPNTHREADS > 1 || LPWORK_NQUEUES > 1
+  /* Find out queue and thread index by search the workers in g_lpwork */
 
-  for (wndx = 0, i = 0; i < CONFIG_SCHED_LPNTHREADS; i++)
+  for (wqueue = NULL, qndx = 0; wqueue == NULL && qndx < LPWORK_NQUEUES;
+       qndx++)
     {
-      if (g_lpwork.worker[i].pid == me)
+      for (i = 0; i < CONFIG_SCHED_LPNTHREADS; i++)
         {
-          wndx = i;
-          break;
+          if (g_lpwork[qndx].worker[i].pid == me)
+            {
+              wqueue = (FAR struct kwork_wqueue_s *)&g_lpwork[qndx];
+              wndx   = i;
+              break;
+            }
         }
     }
 
-  DEBUGASSERT(i < CONFIG_SCHED_LPNTHREADS);
+  DEBUGASSERT(wqueue != NULL);
+#else
+  wqueue = (FAR struct kwork_wqueue_s *)&g_lpwork[0];
+#endif
+
+#ifdef CONFIG_SCHED_LPWORK_PERCPU
+  /* Keep SIGWORK pending while work is performed.  It is only accepted by
+   * work_process() when the worker waits for more work.
+   */
+
+  sigemptyset(&set);
+  nxsig_addset(&set, SIGWORK);
+  nxsig_procmask(SIG_BLOCK, &set, NULL);
 #endif
 
   /* Loop forever */
@@ -104,7 +129,7 @@ static int work_lpthread(int argc, char *argv[])
        * triggered, or delayed work expires.
        */
 
-      work_process((FAR struct kwork_wqueue_s *)&g_lpwork, wndx);
+      work_process(wqueue, wndx);
     }
 
   return OK; /* To keep some compilers happy */
@@ -131,7 +156,11 @@ static int work_lpthread(int argc, char *argv[])
 
 int work_start_lowpri(void)
 {
+#ifdef CONFIG_SCHED_LPWORK_PERCPU
+  cpu_set_t cpuset;
+#endif
   pid_t pid;
+  int qndx;
   int wndx;
 
   /* Don't permit any of the threads to run until we have fully initialized
@@ -144,27 +173,39 @@ int work_start_lowpri(void)
 
   sinfo("Starting low-priority kernel worker thread(s)\n");
 
-  for (wndx = 0; wndx < CONFIG_SCHED_LPNTHREADS; wndx++)
+  for (qndx = 0; qndx < LPWORK_NQUEUES; qndx++)
     {
-      pid = kthread_create(LPWORKNAME, CONFIG_SCHED_LPWORKPRIORITY,
-                           CONFIG_SCHED_LPWORKSTACKSIZE,
-                           (main_t)work_lpthread,
-                           (FAR char * const *)NULL);
-
-      DEBUGASSERT(pid > 0);
-      if (pid < 0)
+      for (wndx = 0; wndx < CONFIG_SCHED_LPNTHREADS; wndx++)
         {
-          serr("ERROR: kthread_create %d failed: %d\n", wndx, (int)pid);
-          sched_unlock();
-          return (int)pid;
-        }
+          pid = kthread_create(LPWORKNAME, CONFIG_SCHED_LPWORKPRIORITY,
+                               CONFIG_SCHED_LPWORKSTACKSIZE,
+                               (main_t)work_lpthread,
+                               (FAR char * const *)NULL);
+
+          DEBUGASSERT(pid > 0);
+          if (pid < 0)
+            {
+              serr("ERROR: kthread_create %d failed: %d\n",
+                   wndx, (int)pid);
+              sched_unlock();
+              return (int)pid;
+            }
+
+#ifdef CONFIG_SCHED_LPWORK_PERCPU
+          /* Bind the workers of each queue to the CPU of the queue */
+
+          CPU_ZERO(&cpuset);
+          CPU_SET(qndx, &cpuset);
+          nxsched_set_affinity(pid, sizeof(cpu_set_t), &cpuset);
+#endif
 
-      g_lpwork.worker[wndx].pid  = pid;
-      g_lpwork.worker[wndx].busy = true;
+          g_lpwork[qndx].worker[wndx].pid  = pid;
+          g_lpwork[qndx].worker[wndx].busy = true;
+        }
     }
 
   sched_unlock();
-  return g_lpwork.worker[0].pid;
+  return g_lpwork[0].worker[0].pid;
 }
 
 #endif /* CONFIG_SCHED_LPWORK */
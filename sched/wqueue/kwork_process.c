@@ -40,27 +40,73 @@
 #ifdef CONFIG_SCHED_WORKQUEUE
 
 /****************************************************************************
- * Pre-processor Definitions
+ * Private Functions
  ****************************************************************************/
 
-/* Use CLOCK_MONOTONIC if it is available.  CLOCK_REALTIME can cause bad
- * delays if the time is changed.
- */
+/****************************************************************************
+ * Name: work_steal
+ *
+ * Description:
+ *   Take the first ready work from the queue of another CPU and perform it.
+ *   Only the workers of the per-CPU low-priority queues take work from
+ *   each other.
+ *
+ * Input Parameters:
+ *   wqueue - Describes the work queue of the calling worker
+ *
+ * Returned Value:
+ *   True if work was performed.
+ *
+ ****************************************************************************/
 
-#ifdef CONFIG_CLOCK_MONOTONIC
-#  define WORK_CLOCK CLOCK_MONOTONIC
-#else
-#  define WORK_CLOCK CLOCK_REALTIME
-#endif
+#ifdef CONFIG_SCHED_LPWORK_PERCPU
+static bool work_steal(FAR struct kwork_wqueue_s *wqueue)
+{
+  FAR struct kwork_wqueue_s *victim;
+  FAR struct work_s *work;
+  worker_t  worker;
+  irqstate_t flags;
+  FAR void *arg;
+  int ndx;
+  int i;
 
-#ifdef CONFIG_SYSTEM_TIME64
-#  define WORK_DELAY_MAX UINT64_MAX
-#else
-#  define WORK_DELAY_MAX UINT32_MAX
+#ifdef CONFIG_SCHED_HPWORK
+  if (wqueue == (FAR struct kwork_wqueue_s *)&g_hpwork)
+    {
+      return false;
+    }
 #endif
 
-#ifndef MIN
-#  define MIN(a,b) ((a) < (b) ? (a) : (b))
+  ndx = (FAR struct lp_wqueue_s *)wqueue - g_lpwork;
+  for (i = 1; i < LPWORK_NQUEUES; i++)
+    {
+      victim = (FAR struct kwork_wqueue_s *)
+               &g_lpwork[(ndx + i) % LPWORK_NQUEUES];
+
+      /* Peek without the lock first so that empty queues are not locked */
+
+      if (dq_empty(&victim->q))
+        {
+          continue;
+        }
+
+      flags = work_lock(victim);
+      work  = (FAR struct work_s *)dq_remfirst(&victim->q);
+      if (work != NULL && (worker = work->worker) != NULL)
+        {
+          arg          = work->arg;
+          work->worker = NULL;
+          work_unlock(victim, flags);
+
+          worker(arg);
+          return true;
+        }
+
+      work_unlock(victim, flags);
+    }
+
+  return false;
+}
 #endif
 
 /****************************************************************************
@@ -78,6 +124,7 @@
  *
  * Input Parameters:
  *   wqueue - Describes the work queue to be processed
+ *   wndx   - The worker thread index
  *
  * Returned Value:
  *   None
@@ -86,161 +133,94 @@
 
 void work_process(FAR struct kwork_wqueue_s *wqueue, int wndx)
 {
-  volatile FAR struct work_s *work;
+  FAR struct work_s *work;
   worker_t  worker;
   irqstate_t flags;
   FAR void *arg;
-  clock_t elapsed;
-  clock_t remaining;
-  clock_t stick;
-  clock_t ctick;
-  clock_t next;
-
-  /* Then process queued work.  We need to keep interrupts disabled while
-   * we process items in the work list.
-   */
+  sigset_t set;
 
-  next  = WORK_DELAY_MAX;
-  flags = enter_critical_section();
+  /* Then process queued work.  Delayed work is moved to the ready queue by
+   * the watchdog of the work queue when it becomes ready, so all of the
+   * work in the ready queue can be performed now in FIFO order.  Interrupts
+   * need only be disabled while the work is removed from the queue.
+   */
 
-  /* Get the time that we started processing the queue in clock ticks. */
+  flags = work_lock(wqueue);
 
-  stick = clock_systime_ticks();
+  while ((work = (FAR struct work_s *)dq_remfirst(&wqueue->q)) != NULL)
+    {
+      /* Extract the work description from the entry (in case the work
+       * instance by the re-used after it has been de-queued).
+       */
 
-  /* And check each entry in the work queue.  Since we have disabled
-   * interrupts we know:  (1) we will not be suspended unless we do
-   * so ourselves, and (2) there will be no changes to the work queue
-   */
+      worker = work->worker;
 
-  work = (FAR struct work_s *)wqueue->q.head;
-  while (work != NULL)
-    {
-      /* Is this work ready?  It is ready if there is no delay or if
-       * the delay has elapsed. qtime is the time that the work was added
-       * to the work queue.  It will always be greater than or equal to
-       * zero.  Therefore a delay of zero will always execute immediately.
+      /* Check for a race condition where the work may be nullified
+       * before it is removed from the queue.
        */
 
-      ctick   = clock_systime_ticks();
-      elapsed = ctick - work->qtime;
-      if (elapsed >= work->delay)
+      if (worker != NULL)
         {
-          /* Remove the ready-to-execute work from the list */
+          /* Extract the work argument (before re-enabling interrupts) */
 
-          dq_rem((struct dq_entry_s *)work, &wqueue->q);
+          arg = work->arg;
 
-          /* Extract the work description from the entry (in case the work
-           * instance by the re-used after it has been de-queued).
-           */
+          /* Mark the work as no longer being queued */
 
-          worker = work->worker;
+          work->worker = NULL;
 
-          /* Check for a race condition where the work may be nullified
-           * before it is removed from the queue.
+          /* Do the work.  Re-enable interrupts while the work is being
+           * performed... we don't have any idea how long this will take!
            */
 
-          if (worker != NULL)
-            {
-              /* Extract the work argument (before re-enabling interrupts) */
-
-              arg = work->arg;
-
-              /* Mark the work as no longer being queued */
-
-              work->worker = NULL;
-
-              /* Do the work.  Re-enable interrupts while the work is being
-               * performed... we don't have any idea how long this will take!
-               */
-
-              leave_critical_section(flags);
-              worker(arg);
-
-              /* Now, unfortunately, since we re-enabled interrupts we don't
-               * know the state of the work list and we will have to start
-               * back at the head of the list.
-               */
-
-              flags = enter_critical_section();
-              work  = (FAR struct work_s *)wqueue->q.head;
-            }
-          else
-            {
-              /* Cancelled.. Just move to the next work in the list with
-               * interrupts still disabled.
-               */
-
-              work = (FAR struct work_s *)work->dq.flink;
-            }
+          work_unlock(wqueue, flags);
+          worker(arg);
+          flags = work_lock(wqueue);
         }
-      else /* elapsed < work->delay */
-        {
-          /* This one is not ready.
-           *
-           * NOTE that elapsed is relative to the current time,
-           * not the time of beginning of this queue processing pass.
-           * So it may need an adjustment.
-           */
-
-          elapsed += (ctick - stick);
-          if (elapsed > work->delay)
-            {
-              /* The delay has expired while we are processing */
-
-              elapsed = work->delay;
-            }
-
-          /* Will it be ready before the next scheduled wakeup interval? */
-
-          remaining = work->delay - elapsed;
-          if (remaining < next)
-            {
-              /* Yes.. Then schedule to wake up when the work is ready */
-
-              next = remaining;
-            }
+    }
 
-          /* Then try the next in the list. */
+  /* Wait indefinitely until signalled with SIGWORK.  That happens when
+   * work is queued without a delay or when delayed work becomes ready.
+   */
 
-          work = (FAR struct work_s *)work->dq.flink;
-        }
-    }
+  sigemptyset(&set);
+  nxsig_addset(&set, SIGWORK);
 
-  /* When multiple worker threads are created for this work queue, only
-   * thread 0 (wndx = 0) will monitor the unexpired works.
-   *
-   * Other worker threads (wndx > 0) just process no-delay or expired
-   * works, then sleep. The unexpired works are left in the queue. They
-   * will be handled by thread 0 when it finishes current work and iterate
-   * over the queue again.
+#ifdef CONFIG_SCHED_LPWORK_PERCPU
+  /* Help the other CPUs before waiting.  The queue of this worker is
+   * checked again afterward since new work may have been queued while it
+   * was unlocked.
    */
 
-  if (wndx > 0 || next == WORK_DELAY_MAX)
+  work_unlock(wqueue, flags);
+  if (work_steal(wqueue))
     {
-      sigset_t set;
+      return;
+    }
 
-      /* Wait indefinitely until signalled with SIGWORK */
+  flags = work_lock(wqueue);
+  if (!dq_empty(&wqueue->q))
+    {
+      work_unlock(wqueue, flags);
+      return;
+    }
 
-      sigemptyset(&set);
-      nxsig_addset(&set, SIGWORK);
+  /* SIGWORK is blocked in the worker threads.  A SIGWORK sent after the
+   * work queue is unlocked stays pending and ends the wait at once.
+   */
 
-      wqueue->worker[wndx].busy = false;
-      DEBUGVERIFY(nxsig_waitinfo(&set, NULL));
-      wqueue->worker[wndx].busy = true;
-    }
-  else
-    {
-      /* Wait a while to check the work list.  We will wait here until
-       * either the time elapses or until we are awakened by a signal.
-       * Interrupts will be re-enabled while we wait.
-       */
+  wqueue->worker[wndx].busy = false;
+  work_unlock(wqueue, flags);
 
-      wqueue->worker[wndx].busy = false;
-      nxsig_usleep(next * USEC_PER_TICK);
-      wqueue->worker[wndx].busy = true;
-    }
+  DEBUGVERIFY(nxsig_waitinfo(&set, NULL));
+  wqueue->worker[wndx].busy = true;
+#else
+  wqueue->worker[wndx].busy = false;
+  DEBUGVERIFY(nxsig_waitinfo(&set, NULL));
+  wqueue->worker[wndx].busy = true;
 
-  leave_critical_section(flags);
+  work_unlock(wqueue, flags);
+#endif
 }
 
 #endif /* CONFIG_SCHED_WORKQUEUE */
@@ -32,16 +32,132 @@
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
 #include <nuttx/clock.h>
+#include <nuttx/wdog.h>
 #include <nuttx/wqueue.h>
 
 #include "wqueue/wqueue.h"
 
 #ifdef CONFIG_SCHED_WORKQUEUE
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The time at which delayed work becomes ready */
+
+#define WORK_EXPIRY(w) ((w)->qtime + (w)->delay)
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void work_timer_expiry(wdparm_t arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_LPWORK_PERCPU
+/* Serializes the claim of work that has never been queued and so is not
+ * owned by any work queue yet.
+ */
+
+static spinlock_t g_work_claimlock = SP_UNLOCKED;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: work_timer_start
+ *
+ * Description:
+ *   (Re-)start the watchdog of the work queue so that it expires when the
+ *   first delayed work becomes ready.  Must be called in a critical
+ *   section with the work queue locked.
+ *
+ ****************************************************************************/
+
+static void work_timer_start(FAR struct kwork_wqueue_s *wqueue)
+{
+  FAR struct work_s *work = (FAR struct work_s *)wqueue->delayed.head;
+  sclock_t remaining;
+
+  if (work == NULL)
+    {
+      wd_cancel(&wqueue->timer);
+      return;
+    }
+
+  remaining = (sclock_t)(WORK_EXPIRY(work) - clock_systime_ticks());
+  if (remaining < 1)
+    {
+      remaining = 1;
+    }
+  else if (remaining > INT32_MAX)
+    {
+      /* The watchdog will expire early and be started again */
+
+      remaining = INT32_MAX;
+    }
+
+  wd_start(&wqueue->timer, (int32_t)remaining, work_timer_expiry,
+           (wdparm_t)wqueue);
+}
+
+/****************************************************************************
+ * Name: work_timer_expiry
+ *
+ * Description:
+ *   The watchdog of a work queue has expired.  Move all of the delayed work
+ *   that is now ready to the end of the ready queue, wake up a worker and
+ *   start the watchdog again for the remaining delayed work.
+ *
+ * Input Parameters:
+ *   arg - The work queue
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Runs in the context of the timer interrupt handler, in a critical
+ *   section.
+ *
+ ****************************************************************************/
+
+static void work_timer_expiry(wdparm_t arg)
+{
+  FAR struct kwork_wqueue_s *wqueue = (FAR struct kwork_wqueue_s *)arg;
+  FAR struct work_s *work;
+  irqstate_t flags;
+  clock_t now;
+  bool ready = false;
+
+  DEBUGASSERT(wqueue != NULL);
+
+  flags = work_lock(wqueue);
+  now   = clock_systime_ticks();
+
+  while ((work = (FAR struct work_s *)wqueue->delayed.head) != NULL &&
+         (sclock_t)(now - WORK_EXPIRY(work)) >= 0)
+    {
+      dq_remfirst(&wqueue->delayed);
+
+      work->delay = 0;
+      dq_addlast((FAR dq_entry_t *)work, &wqueue->q);
+      ready = true;
+    }
+
+  work_timer_start(wqueue);
+  work_unlock(wqueue, flags);
+
+  if (ready)
+    {
+      work_wakeup(wqueue);
+    }
+}
+
 /****************************************************************************
  * Name: work_qqueue
  *
@@ -56,8 +172,12 @@
  *   from the queue, or (2) work_cancel() has been called to cancel the work
  *   and remove it from the work queue.
  *
+ *   Work without a delay is added to the end of the ready queue.  Delayed
+ *   work is inserted into the delayed queue after any work that becomes
+ *   ready at the same time or earlier.
+ *
  * Input Parameters:
- *   qid    - The work queue ID (index)
+ *   wqueue - The work queue
  *   work   - The work structure to queue
  *   worker - The worker callback to be invoked.  The callback will invoked
  *            on the worker thread of execution.
@@ -75,7 +195,22 @@ static void work_qqueue(FAR struct kwork_wqueue_s *wqueue,
                         FAR struct work_s *work, worker_t worker,
                         FAR void *arg, clock_t delay)
 {
+  FAR dq_entry_t *prev;
   irqstate_t flags;
+#ifdef CONFIG_SCHED_LPWORK_PERCPU
+  FAR struct kwork_wqueue_s *owner;
+  irqstate_t cflags = 0;
+
+  /* The watchdog may have to be started for delayed work.  That requires
+   * the critical section, which must be entered before the work queue is
+   * locked.
+   */
+
+  if (delay != 0)
+    {
+      cflags = enter_critical_section();
+    }
+#endif
 
   DEBUGASSERT(work != NULL && worker != NULL);
 
@@ -83,7 +218,61 @@ static void work_qqueue(FAR struct kwork_wqueue_s *wqueue,
    * task logic or ifrom nterrupt handling logic.
    */
 
-  flags = enter_critical_section();
+#ifdef CONFIG_SCHED_LPWORK_PERCPU
+  /* The work belongs to the queue in work->wqueue, which is only changed
+   * with that queue locked.  Work that has never been queued belongs to
+   * no queue and is claimed under g_work_claimlock.  Pending work may be
+   * in the queue of another CPU.  As in work_qcancel(), lock the queue
+   * holding the work and check that the work is still there.  The work is
+   * removed and handed over to this queue while that lock is held, so it
+   * is never in two queues at once.
+   */
+
+  for (; ; )
+    {
+      owner = work->wqueue;
+      if (owner == NULL)
+        {
+          flags = up_irq_save();
+          spin_lock(&g_work_claimlock);
+          if (work->wqueue == NULL)
+            {
+              work->wqueue = wqueue;
+            }
+
+          spin_unlock(&g_work_claimlock);
+          up_irq_restore(flags);
+        }
+      else if (owner != wqueue)
+        {
+          flags = work_lock(owner);
+          if (work->wqueue == owner)
+            {
+              if (work->worker != NULL)
+                {
+                  work_remove(owner, work);
+                  work->worker = NULL;
+                }
+
+              work->wqueue = wqueue;
+            }
+
+          work_unlock(owner, flags);
+        }
+
+      flags = work_lock(wqueue);
+      if (work->wqueue == wqueue)
+        {
+          break;
+        }
+
+      /* The work was claimed by another queue in the meantime */
+
+      work_unlock(wqueue, flags);
+    }
+#else
+  flags = work_lock(wqueue);
+#endif
 
   /* Is there already pending work? */
 
@@ -93,7 +282,7 @@ static void work_qqueue(FAR struct kwork_wqueue_s *wqueue,
        * end of the work queue.
        */
 
-      dq_rem((FAR dq_entry_t *)work, &wqueue->q);
+      work_remove(wqueue, work);
     }
 
   /* Initialize the work structure. */
@@ -101,20 +290,128 @@ static void work_qqueue(FAR struct kwork_wqueue_s *wqueue,
   work->worker = worker;           /* Work callback. non-NULL means queued */
   work->arg    = arg;              /* Callback argument */
   work->delay  = delay;            /* Delay until work performed */
+#ifdef CONFIG_SCHED_LPWORK_PERCPU
+  work->wqueue = wqueue;           /* Work queue holding the work */
+#endif
 
   /* Now, time-tag that entry and put it in the work queue */
 
   work->qtime  = clock_systime_ticks(); /* Time work queued */
 
-  dq_addlast((FAR dq_entry_t *)work, &wqueue->q);
+  if (delay == 0)
+    {
+      dq_addlast((FAR dq_entry_t *)work, &wqueue->q);
+    }
+  else
+    {
+      /* Search backward since later work is usually queued with the same
+       * or a longer delay.
+       */
+
+      for (prev = wqueue->delayed.tail;
+           prev != NULL &&
+           (sclock_t)(WORK_EXPIRY((FAR struct work_s *)prev) -
+                      WORK_EXPIRY(work)) > 0;
+           prev = prev->blink)
+        {
+        }
+
+      if (prev != NULL)
+        {
+          dq_addafter(prev, (FAR dq_entry_t *)work, &wqueue->delayed);
+        }
+      else
+        {
+          /* The new work is the first to become ready */
+
+          dq_addfirst((FAR dq_entry_t *)work, &wqueue->delayed);
+          work_timer_start(wqueue);
+        }
+    }
+
+  work_unlock(wqueue, flags);
 
-  leave_critical_section(flags);
+#ifdef CONFIG_SCHED_LPWORK_PERCPU
+  if (delay != 0)
+    {
+      leave_critical_section(cflags);
+    }
+#endif
 }
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: work_qid2wqueue
+ *
+ * Description:
+ *   Return the kernel work queue with the ID 'qid' or NULL if there is
+ *   none.  For LPWORK with CONFIG_SCHED_LPWORK_PERCPU, this is the queue of
+ *   the calling CPU.
+ *
+ ****************************************************************************/
+
+FAR struct kwork_wqueue_s *work_qid2wqueue(int qid)
+{
+#ifdef CONFIG_SCHED_HPWORK
+  if (qid == HPWORK)
+    {
+      return (FAR struct kwork_wqueue_s *)&g_hpwork;
+    }
+#endif
+
+#ifdef CONFIG_SCHED_LPWORK
+  if (qid == LPWORK)
+    {
+#ifdef CONFIG_SCHED_LPWORK_PERCPU
+      /* The caller may be moved to another CPU at any time, but then the
+       * work is simply queued to the CPU that it was running on.
+       */
+
+      return (FAR struct kwork_wqueue_s *)&g_lpwork[up_cpu_index()];
+#else
+      return (FAR struct kwork_wqueue_s *)&g_lpwork[0];
+#endif
+    }
+#endif
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: work_remove
+ *
+ * Description:
+ *   Remove queued work from whichever queue of the work queue holds it.
+ *   Must be called with the work queue locked by work_lock().
+ *
+ * Input Parameters:
+ *   wqueue - Describes the work queue holding the work
+ *   work   - The queued work to remove
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void work_remove(FAR struct kwork_wqueue_s *wqueue, FAR struct work_s *work)
+{
+  /* If the work was the first delayed work, the watchdog is left running.
+   * It will find nothing ready and start again for the next delayed work.
+   */
+
+  if (work->delay == 0)
+    {
+      dq_rem((FAR dq_entry_t *)work, &wqueue->q);
+    }
+  else
+    {
+      dq_rem((FAR dq_entry_t *)work, &wqueue->delayed);
+    }
+}
+
 /****************************************************************************
  * Name: work_queue
  *
@@ -148,33 +445,20 @@ static void work_qqueue(FAR struct kwork_wqueue_s *wqueue,
 int work_queue(int qid, FAR struct work_s *work, worker_t worker,
                FAR void *arg, clock_t delay)
 {
-  /* Queue the new work */
-
-#ifdef CONFIG_SCHED_HPWORK
-  if (qid == HPWORK)
-    {
-      /* Queue high priority work */
-
-      work_qqueue((FAR struct kwork_wqueue_s *)&g_hpwork, work, worker,
-                  arg, delay);
-      return work_signal(HPWORK);
-    }
-  else
-#endif
-#ifdef CONFIG_SCHED_LPWORK
-  if (qid == LPWORK)
-    {
-      /* Queue low priority work */
+  FAR struct kwork_wqueue_s *wqueue = work_qid2wqueue(qid);
 
-      work_qqueue((FAR struct kwork_wqueue_s *)&g_lpwork, work, worker,
-                  arg, delay);
-      return work_signal(LPWORK);
-    }
-  else
-#endif
+  if (wqueue == NULL)
     {
       return -EINVAL;
     }
+
+  /* Queue the new work */
+
+  work_qqueue(wqueue, work, worker, arg, delay);
+
+  /* Delayed work wakes up a worker when its watchdog expires */
+
+  return delay == 0 ? work_wakeup(wqueue) : OK;
 }
 
 #endif /* CONFIG_SCHED_WORKQUEUE */
@@ -34,78 +34,138 @@
 
 #ifdef CONFIG_SCHED_WORKQUEUE
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_idle
+ *
+ * Description:
+ *   Return the process ID of an IDLE worker thread of the work queue or
+ *   zero if all of its worker threads are busy.
+ *
+ ****************************************************************************/
+
+static pid_t work_idle(FAR struct kwork_wqueue_s *wqueue, int threads)
+{
+  int i;
+
+  for (i = 0; i < threads; i++)
+    {
+      /* Is this worker thread busy? */
+
+      if (!wqueue->worker[i].busy)
+        {
+          /* No.. select this thread */
+
+          return wqueue->worker[i].pid;
+        }
+    }
+
+  return 0;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: work_signal
+ * Name: work_wakeup
  *
  * Description:
- *   Signal the worker thread to process the work queue now.  This function
- *   is used internally by the work logic but could also be used by the
- *   user to force an immediate re-assessment of pending work.
+ *   Signal an idle worker thread of the work queue, if there is one.  With
+ *   CONFIG_SCHED_LPWORK_PERCPU, an idle worker of another low-priority
+ *   queue is signalled if all of the workers of a low-priority queue are
+ *   busy.  That worker will take the ready work from the queue.
  *
  * Input Parameters:
- *   qid    - The work queue ID
+ *   wqueue - Describes the work queue with the ready work
  *
  * Returned Value:
  *   Zero (OK) on success, a negated errno value on failure
  *
  ****************************************************************************/
 
-int work_signal(int qid)
+int work_wakeup(FAR struct kwork_wqueue_s *wqueue)
 {
-  FAR struct kwork_wqueue_s *work;
-  int threads;
+  pid_t pid;
+#ifdef CONFIG_SCHED_LPWORK_PERCPU
+  int ndx;
   int i;
+#endif
 
-  /* Get the process ID of the worker thread */
+  /* Find an IDLE worker thread */
 
 #ifdef CONFIG_SCHED_HPWORK
-  if (qid == HPWORK)
-    {
-      work = (FAR struct kwork_wqueue_s *)&g_hpwork;
-      threads = CONFIG_SCHED_HPNTHREADS;
-    }
-  else
-#endif
-#ifdef CONFIG_SCHED_LPWORK
-  if (qid == LPWORK)
+  if (wqueue == (FAR struct kwork_wqueue_s *)&g_hpwork)
     {
-      work = (FAR struct kwork_wqueue_s *)&g_lpwork;
-      threads = CONFIG_SCHED_LPNTHREADS;
+      pid = work_idle(wqueue, CONFIG_SCHED_HPNTHREADS);
     }
   else
 #endif
     {
-      return -EINVAL;
-    }
-
-  /* Find an IDLE worker thread */
+#ifdef CONFIG_SCHED_LPWORK
+      pid = work_idle(wqueue, CONFIG_SCHED_LPNTHREADS);
 
-  for (i = 0; i < threads; i++)
-    {
-      /* Is this worker thread busy? */
+#ifdef CONFIG_SCHED_LPWORK_PERCPU
+      /* Look at the queues of the next CPUs in turn so that the work is
+       * spread over the idle workers.
+       */
 
-      if (!work->worker[i].busy)
+      ndx = (FAR struct lp_wqueue_s *)wqueue - g_lpwork;
+      for (i = 1; pid == 0 && i < LPWORK_NQUEUES; i++)
         {
-          /* No.. select this thread */
-
-          break;
+          pid = work_idle((FAR struct kwork_wqueue_s *)
+                          &g_lpwork[(ndx + i) % LPWORK_NQUEUES],
+                          CONFIG_SCHED_LPNTHREADS);
         }
+#endif
+#else
+      pid = 0;
+#endif
     }
 
-  /* If all of the IDLE threads are busy, then just return successfully */
+  /* If all of the worker threads are busy, then just return successfully.
+   * One of them will find the work when it has finished its current work.
+   */
 
-  if (i >= threads)
+  if (pid == 0)
     {
       return OK;
     }
 
   /* Otherwise, signal the first IDLE thread found */
 
-  return nxsig_kill(work->worker[i].pid, SIGWORK);
+  return nxsig_kill(pid, SIGWORK);
+}
+
+/****************************************************************************
+ * Name: work_signal
+ *
+ * Description:
+ *   Signal the worker thread to process the work queue now.  This function
+ *   is used internally by the work logic but could also be used by the
+ *   user to force an immediate re-assessment of pending work.
+ *
+ * Input Parameters:
+ *   qid    - The work queue ID
+ *
+ * Returned Value:
+ *   Zero (OK) on success, a negated errno value on failure
+ *
+ ****************************************************************************/
+
+int work_signal(int qid)
+{
+  FAR struct kwork_wqueue_s *wqueue = work_qid2wqueue(qid);
+
+  if (wqueue == NULL)
+    {
+      return -EINVAL;
+    }
+
+  return work_wakeup(wqueue);
 }
 
 #endif /* CONFIG_SCHED_WORKQUEUE */
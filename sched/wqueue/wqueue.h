@@ -31,6 +31,9 @@
 #include <queue.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wdog.h>
 
 #ifdef CONFIG_SCHED_WORKQUEUE
 
@@ -43,6 +46,14 @@
 #define HPWORKNAME "hpwork"
 #define LPWORKNAME "lpwork"
 
+/* The number of low-priority work queues */
+
+#ifdef CONFIG_SCHED_LPWORK_PERCPU
+#  define LPWORK_NQUEUES CONFIG_SMP_NCPUS
+#else
+#  define LPWORK_NQUEUES 1
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -55,11 +66,26 @@ struct kworker_s
   volatile bool     busy;   /* True: Worker is not available */
 };
 
-/* This structure defines the state of one kernel-mode work queue */
+/* This structure defines the state of one kernel-mode work queue.  Work
+ * that is ready to run is kept in FIFO order in 'q'.  Delayed work is kept
+ * in 'delayed', sorted by the time at which it becomes ready.  The 'timer'
+ * watchdog expires when the first delayed work becomes ready and moves it
+ * to 'q'.  Work with a zero delay field is in 'q', any other queued work is
+ * in 'delayed'.
+ *
+ * With CONFIG_SCHED_LPWORK_PERCPU, the queues are protected by 'lock'
+ * instead of by the critical section.  The critical section, if needed,
+ * must be entered before the lock is taken and never while it is held.
+ */
 
 struct kwork_wqueue_s
 {
-  struct dq_queue_s q;         /* The queue of pending work */
+  struct dq_queue_s q;         /* The queue of work ready to run */
+  struct dq_queue_s delayed;   /* The time-sorted queue of delayed work */
+  struct wdog_s     timer;     /* Expires when delayed work becomes ready */
+#ifdef CONFIG_SCHED_LPWORK_PERCPU
+  spinlock_t        lock;      /* Protects the queues of the work queue */
+#endif
   struct kworker_s  worker[1]; /* Describes a worker thread */
 };
 
@@ -70,7 +96,12 @@ struct kwork_wqueue_s
 #ifdef CONFIG_SCHED_HPWORK
 struct hp_wqueue_s
 {
-  struct dq_queue_s q;         /* The queue of pending work */
+  struct dq_queue_s q;         /* The queue of work ready to run */
+  struct dq_queue_s delayed;   /* The time-sorted queue of delayed work */
+  struct wdog_s     timer;     /* Expires when delayed work becomes ready */
+#ifdef CONFIG_SCHED_LPWORK_PERCPU
+  spinlock_t        lock;      /* Protects the queues of the work queue */
+#endif
 
   /* Describes each thread in the high priority queue's thread pool */
 
@@ -85,7 +116,12 @@ struct hp_wqueue_s
 #ifdef CONFIG_SCHED_LPWORK
 struct lp_wqueue_s
 {
-  struct dq_queue_s q;      /* The queue of pending work */
+  struct dq_queue_s q;         /* The queue of work ready to run */
+  struct dq_queue_s delayed;   /* The time-sorted queue of delayed work */
+  struct wdog_s     timer;     /* Expires when delayed work becomes ready */
+#ifdef CONFIG_SCHED_LPWORK_PERCPU
+  spinlock_t        lock;      /* Protects the queues of the work queue */
+#endif
 
   /* Describes each thread in the low priority queue's thread pool */
 
@@ -104,9 +140,42 @@ extern struct hp_wqueue_s g_hpwork;
 #endif
 
 #ifdef CONFIG_SCHED_LPWORK
-/* The state of the kernel mode, low priority work queue(s). */
+/* The state of the kernel mode, low priority work queue(s).  There is one
+ * queue for each CPU if CONFIG_SCHED_LPWORK_PERCPU is selected.
+ */
 
-extern struct lp_wqueue_s g_lpwork;
+extern struct lp_wqueue_s g_lpwork[LPWORK_NQUEUES];
+#endif
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_lock and work_unlock
+ *
+ * Description:
+ *   Get and release exclusive access to the queues of a kernel work queue.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_LPWORK_PERCPU
+static inline irqstate_t work_lock(FAR struct kwork_wqueue_s *wqueue)
+{
+  irqstate_t flags = up_irq_save();
+  spin_lock(&wqueue->lock);
+  return flags;
+}
+
+static inline void work_unlock(FAR struct kwork_wqueue_s *wqueue,
+                               irqstate_t flags)
+{
+  spin_unlock(&wqueue->lock);
+  up_irq_restore(flags);
+}
+#else
+#  define work_lock(w)         enter_critical_section()
+#  define work_unlock(w,f)     leave_critical_section(f)
 #endif
 
 /****************************************************************************
@@ -171,6 +240,55 @@ int work_start_lowpri(void);
 
 void work_process(FAR struct kwork_wqueue_s *wqueue, int wndx);
 
+/****************************************************************************
+ * Name: work_qid2wqueue
+ *
+ * Description:
+ *   Return the kernel work queue with the ID 'qid' or NULL if there is
+ *   none.  For LPWORK with CONFIG_SCHED_LPWORK_PERCPU, this is the queue of
+ *   the calling CPU.
+ *
+ ****************************************************************************/
+
+FAR struct kwork_wqueue_s *work_qid2wqueue(int qid);
+
+/****************************************************************************
+ * Name: work_wakeup
+ *
+ * Description:
+ *   Signal an idle worker thread of the work queue, if there is one.  With
+ *   CONFIG_SCHED_LPWORK_PERCPU, an idle worker of another low-priority
+ *   queue is signalled if all of the workers of a low-priority queue are
+ *   busy.  That worker will take the ready work from the queue.
+ *
+ * Input Parameters:
+ *   wqueue - Describes the work queue with the ready work
+ *
+ * Returned Value:
+ *   Zero (OK) on success, a negated errno value on failure
+ *
+ ****************************************************************************/
+
+int work_wakeup(FAR struct kwork_wqueue_s *wqueue);
+
+/****************************************************************************
+ * Name: work_remove
+ *
+ * Description:
+ *   Remove queued work from whichever queue of the work queue holds it.
+ *   Must be called with the work queue locked by work_lock().
+ *
+ * Input Parameters:
+ *   wqueue - Describes the work queue holding the work
+ *   work   - The queued work to remove
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void work_remove(FAR struct kwork_wqueue_s *wqueue, FAR struct work_s *work);
+
 /****************************************************************************
  * Name: work_initialize_notifier
  *
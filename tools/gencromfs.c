@@ -117,6 +117,8 @@
 #define CROMFS_MAGIC       0x4d4f5243
 #define CROMFS_BLOCKSIZE   512
 
+#define CROMFS_NODE_BLKINDEX (1 << 0) /* A block index precedes the data */
+
 #define LZF_BUFSIZE        512
 #define LZF_HLOG           13
 #define LZF_HSIZE          (1 << LZF_HLOG)
@@ -164,7 +166,7 @@ struct cromfs_volume_s
 struct cromfs_node_s
 {
   uint16_t cn_mode;       /* File type, attributes, and access mode bits */
-  uint16_t cn_pad;        /* Not used */
+  uint16_t cn_flags;      /* See CROMFS_NODE_* definitions */
   uint32_t cn_name;       /* Offset from the beginning of the volume header to the
                            * node name string.  NUL-terminated. */
   uint32_t cn_size;       /* Size of the uncompressed data (in bytes) */
@@ -311,7 +313,7 @@ static void gen_dirlink(const char *name, uint32_t tgtoffs, bool dirempty);
 static void gen_directory(const char *path, const char *name, mode_t mode,
                           bool lastentry);
 static void gen_file(const char *path, const char *name, mode_t mode,
-                          bool lastentry);
+                     off_t size, bool lastentry);
 static int  dir_notempty(const char *dirpath, const char *name,
                          void *arg, bool lastentry);
 static int  process_direntry(const char *dirpath, const char *name,
@@ -901,7 +903,7 @@ static void gen_dirlink(const char *name, uint32_t tgtoffs, bool dirempty)
           (unsigned long)g_offset, name);
 
   node.cn_mode    = TGT_UINT16(DIRLINK_MODEFLAGS);
-  node.cn_pad     = 0;
+  node.cn_flags   = 0;
 
   g_offset       += sizeof(struct cromfs_node_s);
   node.cn_name    = TGT_UINT32(g_offset);
@@ -984,7 +986,7 @@ static void gen_directory(const char *path, const char *name, mode_t mode,
           (unsigned long)save_offset, path);
 
   node.cn_mode    = TGT_UINT16(NUTTX_IFDIR | get_mode(mode));
-  node.cn_pad     = 0;
+  node.cn_flags   = 0;
 
   save_offset    += sizeof(struct cromfs_node_s);
   node.cn_name    = TGT_UINT32(save_offset);
@@ -1008,7 +1010,7 @@ static void gen_directory(const char *path, const char *name, mode_t mode,
 }
 
 static void gen_file(const char *path, const char *name, mode_t mode,
-                     bool lastentry)
+                     off_t size, bool lastentry)
 {
   struct cromfs_node_s node;
   union lzf_result_u result;
@@ -1017,20 +1019,41 @@ static void gen_file(const char *path, const char *name, mode_t mode,
   FILE *outstream;
   FILE *instream;
   uint8_t iobuffer[LZF_BUFSIZE];
+  uint32_t *blkindex;
   size_t nread;
   size_t ntotal;
   size_t blklen;
   size_t blktotal;
+  size_t ndxlen;
+  unsigned int nblocks;
   unsigned int blkno;
   int namlen;
 
   namlen      = strlen(name) + 1;
 
+  /* Every block but the last holds LZF_BUFSIZE bytes of the file.  Allocate
+   * the block index that will hold the offset to each block.
+   */
+
+  nblocks     = (size + LZF_BUFSIZE - 1) / LZF_BUFSIZE;
+  ndxlen      = nblocks * sizeof(uint32_t);
+  blkindex    = NULL;
+
+  if (nblocks > 0)
+    {
+      blkindex = (uint32_t *)malloc(ndxlen);
+      if (!blkindex)
+        {
+          fprintf(stderr, "Failed to allocate block index for %s\n", path);
+          exit(1);
+        }
+    }
+
   /* Open a new temporary file */
 
   outstream   = open_tmpfile();
   g_tmpstream = outstream;
-  g_offset    = nodeoffs + sizeof(struct cromfs_node_s) + namlen;
+  g_offset    = nodeoffs + sizeof(struct cromfs_node_s) + namlen + ndxlen;
 
   /* Open the source data file */
 
@@ -1059,6 +1082,12 @@ static void gen_file(const char *path, const char *name, mode_t mode,
         {
           uint16_t clen;
 
+          if (blkno >= nblocks)
+            {
+              fprintf(stderr, "Source file %s changed size\n", path);
+              exit(1);
+            }
+
           /* Compress the chunk */
 
           blklen = lzf_compress(iobuffer, nread, &result);
@@ -1080,6 +1109,8 @@ static void gen_file(const char *path, const char *name, mode_t mode,
           dump_hexbuffer(g_tmpstream, &result, blklen);
           dump_nextline(g_tmpstream);
 
+          blkindex[blkno] = TGT_UINT32(g_offset);
+
           ntotal   += nread;
           blktotal += blklen;
           g_offset += blklen;
@@ -1090,6 +1121,14 @@ static void gen_file(const char *path, const char *name, mode_t mode,
     }
   while (nread > 0);
 
+  fclose(instream);
+
+  if (blkno != nblocks)
+    {
+      fprintf(stderr, "Source file %s changed size\n", path);
+      exit(1);
+    }
+
   /* Restore the old tmpfile context */
 
   g_tmpstream        = save_tmpstream;
@@ -1102,14 +1141,14 @@ static void gen_file(const char *path, const char *name, mode_t mode,
           (unsigned long)blktotal);
 
   node.cn_mode       = TGT_UINT16(NUTTX_IFREG | get_mode(mode));
-  node.cn_pad        = 0;
+  node.cn_flags      = TGT_UINT16(CROMFS_NODE_BLKINDEX);
 
   nodeoffs          += sizeof(struct cromfs_node_s);
   node.cn_name       = TGT_UINT32(nodeoffs);
 
   node.cn_size       = TGT_UINT32(ntotal);
 
-  nodeoffs          += namlen;
+  nodeoffs          += namlen + ndxlen;
   node.u.cn_blocks   = TGT_UINT32(nodeoffs);
 
   nodeoffs          += blktotal;
@@ -1117,6 +1156,15 @@ static void gen_file(const char *path, const char *name, mode_t mode,
 
   dump_hexbuffer(g_tmpstream, &node, sizeof(struct cromfs_node_s));
   dump_hexbuffer(g_tmpstream, name, namlen);
+
+  /* The block index lies between the file name and the first block */
+
+  if (nblocks > 0)
+    {
+      dump_hexbuffer(g_tmpstream, blkindex, ndxlen);
+      free(blkindex);
+    }
+
   dump_nextline(g_tmpstream);
 
   g_nnodes++;
@@ -1194,7 +1242,7 @@ static int process_direntry(const char *dirpath, const char *name,
     }
   else if (S_ISREG(buf.st_mode))
     {
-      gen_file(path, name, buf.st_mode, lastentry);
+      gen_file(path, name, buf.st_mode, buf.st_size, lastentry);
     }
   else
     {
@@ -0,0 +1,425 @@
+/****************************************************************************
+ * tools/note2json.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* These must agree with include/nuttx/note/notepcpu_driver.h and
+ * include/nuttx/sched_note.h.
+ */
+
+#define NOTEPCPU_HDRSIZE     8
+#define NOTEPCPU_RECSIZE     12
+#define NOTEPCPU_VERSION     1
+#define NOTEPCPU_FLAG_SMP    (1 << 0)
+
+#define NOTE_START           0
+#define NOTE_STOP            1
+#define NOTE_SUSPEND         2
+#define NOTE_RESUME          3
+#define NOTE_CPU_START       4
+#define NOTE_CPU_STARTED     5
+#define NOTE_CPU_PAUSE       6
+#define NOTE_CPU_PAUSED      7
+#define NOTE_CPU_RESUME      8
+#define NOTE_CPU_RESUMED     9
+#define NOTE_PREEMPT_LOCK    10
+#define NOTE_PREEMPT_UNLOCK  11
+#define NOTE_CSECTION_ENTER  12
+#define NOTE_CSECTION_LEAVE  13
+#define NOTE_SPINLOCK_LOCK   14
+#define NOTE_SPINLOCK_LOCKED 15
+#define NOTE_SPINLOCK_UNLOCK 16
+#define NOTE_SPINLOCK_ABORT  17
+#define NOTE_SYSCALL_ENTER   18
+#define NOTE_SYSCALL_LEAVE   19
+#define NOTE_IRQ_ENTER       20
+#define NOTE_IRQ_LEAVE       21
+
+#define MAX_CPUS             256
+#define MAX_PIDS             65536
+#define MAX_NAME             32
+
+/* Chrome trace process IDs used for the two groups of tracks */
+
+#define TRACE_CPU_PID        0     /* One thread per CPU and per CPU IRQ */
+#define TRACE_TASK_PID       1     /* One thread per NuttX task */
+#define TRACE_IRQ_TID        1000  /* IRQ track of CPU n is 1000 + n */
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FILE *g_out;
+static bool g_first = true;
+static char *g_names[MAX_PIDS];
+static int g_running[MAX_CPUS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void show_usage(const char *progname)
+{
+  fprintf(stderr, "USAGE: %s <note-stream> [<json-file>]\n", progname);
+  fprintf(stderr, "\nConvert a stream read from /dev/note with "
+                  "CONFIG_DRIVER_NOTEPCPU=y\n");
+  fprintf(stderr, "into the Chrome trace event format.  The output is "
+                  "written to stdout\n");
+  fprintf(stderr, "if no <json-file> is given.\n");
+  exit(EXIT_FAILURE);
+}
+
+static const char *task_name(unsigned int pid)
+{
+  static char buffer[MAX_NAME];
+
+  if (g_names[pid] != NULL)
+    {
+      return g_names[pid];
+    }
+
+  snprintf(buffer, MAX_NAME, "pid %u", pid);
+  return buffer;
+}
+
+static void set_name(unsigned int pid, const uint8_t *name, size_t len)
+{
+  char *copy;
+  size_t i;
+
+  copy = malloc(len + 1);
+  if (copy == NULL)
+    {
+      return;
+    }
+
+  /* Keep the JSON valid whatever the task name contains */
+
+  for (i = 0; i < len && name[i] != '\0'; i++)
+    {
+      copy[i] = (name[i] < 0x20 || name[i] > 0x7e ||
+                 name[i] == '"' || name[i] == '\\') ? '_' : name[i];
+    }
+
+  copy[i] = '\0';
+  free(g_names[pid]);
+  g_names[pid] = copy;
+}
+
+static void emit_begin(void)
+{
+  if (!g_first)
+    {
+      fputs(",\n", g_out);
+    }
+
+  g_first = false;
+}
+
+static void emit_event(const char *ph, double ts, int pid, int tid,
+                       const char *name)
+{
+  emit_begin();
+  fprintf(g_out, "{\"name\":\"%s\",\"ph\":\"%s\",\"ts\":%.3f,"
+                 "\"pid\":%d,\"tid\":%d",
+          name, ph, ts, pid, tid);
+
+  if (ph[0] == 'i')
+    {
+      fputs(",\"s\":\"t\"", g_out);
+    }
+
+  fputs("}", g_out);
+}
+
+static void emit_thread_name(int pid, int tid, const char *name)
+{
+  emit_begin();
+  fprintf(g_out, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,"
+                 "\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+          pid, tid, name);
+}
+
+static void emit_process_name(int pid, const char *name)
+{
+  emit_begin();
+  fprintf(g_out, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,"
+                 "\"args\":{\"name\":\"%s\"}}",
+          pid, name);
+}
+
+static void switch_out(int cpu, double ts)
+{
+  if (g_running[cpu] >= 0)
+    {
+      emit_event("E", ts, TRACE_CPU_PID, cpu, task_name(g_running[cpu]));
+      g_running[cpu] = -1;
+    }
+}
+
+static void convert_note(const uint8_t *rec, const uint8_t *note,
+                         size_t cmnsize, bool smp)
+{
+  char name[MAX_NAME + 16];
+  const uint8_t *body;
+  unsigned int dropped;
+  unsigned int pid;
+  unsigned int len;
+  uint32_t sec;
+  uint32_t nsec;
+  double ts;
+  int ncpu;
+  int cpu;
+
+  cpu     = rec[0];
+  dropped = rec[2] | (rec[3] << 8);
+  sec     = rec[4] | (rec[5] << 8) | (rec[6] << 16) |
+            ((uint32_t)rec[7] << 24);
+  nsec    = rec[8] | (rec[9] << 8) | (rec[10] << 16) |
+            ((uint32_t)rec[11] << 24);
+  ts      = (double)sec * 1000000.0 + (double)nsec / 1000.0;
+
+  /* The CPU in the note is the CPU of the task the note is about; the CPU
+   * in the record is the CPU that generated the note.
+   */
+
+  ncpu    = smp ? note[3] : cpu;
+  pid     = note[cmnsize - 6] | (note[cmnsize - 5] << 8);
+  len     = note[0];
+  body    = note + cmnsize;
+
+  if (dropped > 0)
+    {
+      snprintf(name, sizeof(name), "%u notes dropped", dropped);
+      emit_event("i", ts, TRACE_CPU_PID, cpu, name);
+    }
+
+  switch (note[1])
+    {
+      case NOTE_START:
+        set_name(pid, body, len - cmnsize);
+        emit_thread_name(TRACE_TASK_PID, pid, task_name(pid));
+        emit_event("i", ts, TRACE_TASK_PID, pid, "start");
+        break;
+
+      case NOTE_STOP:
+        emit_event("i", ts, TRACE_TASK_PID, pid, "stop");
+        break;
+
+      case NOTE_SUSPEND:
+        if (g_running[ncpu] == (int)pid)
+          {
+            switch_out(ncpu, ts);
+          }
+        break;
+
+      case NOTE_RESUME:
+        switch_out(ncpu, ts);
+        g_running[ncpu] = pid;
+        emit_event("B", ts, TRACE_CPU_PID, ncpu, task_name(pid));
+        break;
+
+      case NOTE_CPU_START:
+      case NOTE_CPU_STARTED:
+      case NOTE_CPU_PAUSE:
+      case NOTE_CPU_PAUSED:
+      case NOTE_CPU_RESUME:
+      case NOTE_CPU_RESUMED:
+        {
+          static const char *const names[] =
+          {
+            "cpu start", "cpu started", "cpu pause", "cpu paused",
+            "cpu resume", "cpu resumed"
+          };
+
+          emit_event("i", ts, TRACE_CPU_PID, cpu,
+                     names[note[1] - NOTE_CPU_START]);
+        }
+        break;
+
+      case NOTE_PREEMPT_LOCK:
+        emit_event("B", ts, TRACE_TASK_PID, pid, "sched_lock");
+        break;
+
+      case NOTE_PREEMPT_UNLOCK:
+        emit_event("E", ts, TRACE_TASK_PID, pid, "sched_lock");
+        break;
+
+      case NOTE_CSECTION_ENTER:
+        emit_event("B", ts, TRACE_TASK_PID, pid, "csection");
+        break;
+
+      case NOTE_CSECTION_LEAVE:
+        emit_event("E", ts, TRACE_TASK_PID, pid, "csection");
+        break;
+
+      case NOTE_SPINLOCK_LOCK:
+      case NOTE_SPINLOCK_LOCKED:
+      case NOTE_SPINLOCK_UNLOCK:
+      case NOTE_SPINLOCK_ABORT:
+        {
+          static const char *const names[] =
+          {
+            "spin lock", "spin locked", "spin unlock", "spin abort"
+          };
+
+          emit_event("i", ts, TRACE_TASK_PID, pid,
+                     names[note[1] - NOTE_SPINLOCK_LOCK]);
+        }
+        break;
+
+      case NOTE_SYSCALL_ENTER:
+        snprintf(name, sizeof(name), "syscall %u", body[0]);
+        emit_event("B", ts, TRACE_TASK_PID, pid, name);
+        break;
+
+      case NOTE_SYSCALL_LEAVE:
+        emit_event("E", ts, TRACE_TASK_PID, pid, "");
+        break;
+
+      case NOTE_IRQ_ENTER:
+        snprintf(name, sizeof(name), "irq %u", body[0]);
+        emit_event("B", ts, TRACE_CPU_PID, TRACE_IRQ_TID + cpu, name);
+        break;
+
+      case NOTE_IRQ_LEAVE:
+        snprintf(name, sizeof(name), "irq %u", body[0]);
+        emit_event("E", ts, TRACE_CPU_PID, TRACE_IRQ_TID + cpu, name);
+        break;
+
+      default:
+        fprintf(stderr, "Unknown note type %u ignored\n", note[1]);
+        break;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, char **argv)
+{
+  uint8_t hdr[NOTEPCPU_HDRSIZE];
+  uint8_t rec[NOTEPCPU_RECSIZE];
+  uint8_t note[256];
+  char name[MAX_NAME];
+  size_t cmnsize;
+  FILE *in;
+  bool smp;
+  int ncpus;
+  int cpu;
+
+  if (argc < 2 || argc > 3)
+    {
+      show_usage(argv[0]);
+    }
+
+  in = fopen(argv[1], "rb");
+  if (in == NULL)
+    {
+      fprintf(stderr, "ERROR: Cannot open %s\n", argv[1]);
+      return EXIT_FAILURE;
+    }
+
+  g_out = stdout;
+  if (argc == 3)
+    {
+      g_out = fopen(argv[2], "w");
+      if (g_out == NULL)
+        {
+          fprintf(stderr, "ERROR: Cannot create %s\n", argv[2]);
+          fclose(in);
+          return EXIT_FAILURE;
+        }
+    }
+
+  if (fread(hdr, 1, NOTEPCPU_HDRSIZE, in) != NOTEPCPU_HDRSIZE ||
+      memcmp(hdr, "NXNT", 4) != 0)
+    {
+      fprintf(stderr, "ERROR: %s is not a note stream\n", argv[1]);
+      return EXIT_FAILURE;
+    }
+
+  if (hdr[4] != NOTEPCPU_VERSION)
+    {
+      fprintf(stderr, "ERROR: Unsupported stream version %u\n", hdr[4]);
+      return EXIT_FAILURE;
+    }
+
+  /* The common note header is length, type, priority, (cpu), pid[2] and
+   * systime[4].
+   */
+
+  ncpus   = hdr[5];
+  smp     = (hdr[6] & NOTEPCPU_FLAG_SMP) != 0;
+  cmnsize = smp ? 10 : 9;
+
+  fputs("{\"traceEvents\":[\n", g_out);
+
+  emit_process_name(TRACE_CPU_PID, "CPUs");
+  emit_process_name(TRACE_TASK_PID, "Tasks");
+
+  for (cpu = 0; cpu < MAX_CPUS; cpu++)
+    {
+      g_running[cpu] = -1;
+    }
+
+  for (cpu = 0; cpu < ncpus; cpu++)
+    {
+      snprintf(name, sizeof(name), "CPU %d", cpu);
+      emit_thread_name(TRACE_CPU_PID, cpu, name);
+      snprintf(name, sizeof(name), "CPU %d IRQ", cpu);
+      emit_thread_name(TRACE_CPU_PID, TRACE_IRQ_TID + cpu, name);
+    }
+
+  while (fread(rec, 1, NOTEPCPU_RECSIZE, in) == NOTEPCPU_RECSIZE)
+    {
+      if (fread(note, 1, 1, in) != 1 || note[0] < cmnsize ||
+          fread(note + 1, 1, note[0] - 1, in) != note[0] - 1u)
+        {
+          fprintf(stderr, "ERROR: Truncated or corrupted note\n");
+          break;
+        }
+
+      convert_note(rec, note, cmnsize, smp);
+    }
+
+  fputs("\n]}\n", g_out);
+
+  fclose(in);
+  if (g_out != stdout)
+    {
+      fclose(g_out);
+    }
+
+  return EXIT_SUCCESS;
+}